@@ -194,8 +194,10 @@ std::string get_only_file_name_with_path(const std::string& path);
 int text_is_signed(BypeArrayRef text);
 
 // Channels
-const int GPGFRONTEND_DEFAULT_CHANNEL = 0;    ///<
-const int GPGFRONTEND_NON_ASCII_CHANNEL = 2;  ///<
+const int GPGFRONTEND_DEFAULT_CHANNEL = 0;       ///<
+const int GPGFRONTEND_NON_ASCII_CHANNEL = 2;     ///<
+const int GPGFRONTEND_WORKER_CHANNEL_BASE = 64;  ///< first worker channel
+const int GPGFRONTEND_MAX_WORKER_CHANNELS = 32;  ///< worker channels per base
 
 /**
  * @brief
@@ -33,6 +33,9 @@
 #include <spdlog/spdlog.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
@@ -51,6 +54,52 @@
 
 namespace GpgFrontend {
 
+namespace {
+std::mutex passphrase_prompt_lock;  ///< one dialog at a time
+
+/**
+ * @brief overwrite a passphrase before its memory is released
+ *
+ */
+void wipe_passphrase(std::string &passphrase) {
+  std::fill(passphrase.begin(), passphrase.end(), '\0');
+  passphrase.clear();
+}
+
+/**
+ * @brief whether the calling thread is the one the dialogs live in
+ *
+ */
+bool is_gui_thread() {
+  return QCoreApplication::instance() != nullptr &&
+         QThread::currentThread() == QCoreApplication::instance()->thread();
+}
+}  // namespace
+
+GpgBatchPassphrases::~GpgBatchPassphrases() {
+  for (auto &passphrase : passphrases_) wipe_passphrase(passphrase.second);
+}
+
+std::string GpgBatchPassphrases::Get(const std::string &uid_hint,
+                                     bool last_was_bad,
+                                     const std::function<std::string()> &ask) {
+  auto key_id = uid_hint.substr(0, uid_hint.find(' '));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = passphrases_.find(key_id);
+  if (it != passphrases_.end() && !last_was_bad) return it->second;
+
+  auto passphrase = ask();
+  if (it != passphrases_.end()) wipe_passphrase(it->second);
+  // a cancelled prompt is asked again by the next worker
+  if (passphrase.empty()) {
+    if (it != passphrases_.end()) passphrases_.erase(it);
+  } else {
+    passphrases_[key_id] = passphrase;
+  }
+  return passphrase;
+}
+
 GpgContext::GpgContext(int channel)
     : SingletonFunctionObject<GpgContext>(channel) {}
 
@@ -173,29 +222,28 @@ GpgContext::GpgContext(const GpgContextInitArgs &args) : args_(args) {
     // speed up loading process
     gpgme_set_offline(*this, 1);
 
-    // set keylist mode
+    // set keylist mode, signatures, notations and tofu info are listed on
+    // demand by GpgKeyGetter::GetDetailedKey()
     if (info_.GnupgVersion >= "2.0.0") {
       check_gpg_error(gpgme_set_keylist_mode(
-          *this, GPGME_KEYLIST_MODE_LOCAL | GPGME_KEYLIST_MODE_WITH_SECRET |
-                     GPGME_KEYLIST_MODE_SIGS |
-                     GPGME_KEYLIST_MODE_SIG_NOTATIONS |
-                     GPGME_KEYLIST_MODE_WITH_TOFU));
+          *this, GPGME_KEYLIST_MODE_LOCAL | GPGME_KEYLIST_MODE_WITH_SECRET));
     } else {
-      check_gpg_error(gpgme_set_keylist_mode(
-          *this, GPGME_KEYLIST_MODE_LOCAL | GPGME_KEYLIST_MODE_SIGS |
-                     GPGME_KEYLIST_MODE_SIG_NOTATIONS |
-                     GPGME_KEYLIST_MODE_WITH_TOFU));
+      check_gpg_error(gpgme_set_keylist_mode(*this, GPGME_KEYLIST_MODE_LOCAL));
     }
 
-    // async, init context
-    Thread::TaskRunnerGetter::GetInstance()
-        .GetTaskRunner(Thread::TaskRunnerGetter::kTaskRunnerType_GPG)
-        ->PostTask(new Thread::Task(
-            [=](Thread::Task::DataObjectPtr) -> int {
-              post_init_ctx();
-              return 0;
-            },
-            "post_init_ctx"));
+    if (args_.sync_init) {
+      post_init_ctx();
+    } else {
+      // async, init context
+      Thread::TaskRunnerGetter::GetInstance()
+          .GetTaskRunner(Thread::TaskRunnerGetter::kTaskRunnerType_GPG)
+          ->PostTask(new Thread::Task(
+              [=](Thread::Task::DataObjectPtr) -> int {
+                post_init_ctx();
+                return 0;
+              },
+              "post_init_ctx"));
+    }
 
     good_ = true;
   }
@@ -230,8 +278,8 @@ void GpgContext::post_init_ctx() {
     gpgme_set_status_cb(*this, test_status_cb, nullptr);
   }
 
-  // preload info
-  auto &info = GetInfo();
+  // preload info, contexts initialized in place load it on demand
+  if (!args_.sync_init) GetInfo();
 
   // use custom qt dialog to replace pinentry
   if (!args_.use_pinentry) {
@@ -245,12 +293,20 @@ void GpgContext::post_init_ctx() {
 
 bool GpgContext::good() const { return good_; }
 
-void GpgContext::SetPassphraseCb(gpgme_passphrase_cb_t cb) const {
+const GpgContextInitArgs &GpgContext::GetInitArgs() const { return args_; }
+
+void GpgContext::SetBatchPassphrases(GpgBatchPassphrases *passphrases) {
+  if (args_.use_pinentry) return;
+  SetPassphraseCb(custom_passphrase_cb, passphrases);
+}
+
+void GpgContext::SetPassphraseCb(gpgme_passphrase_cb_t cb,
+                                 void *opaque) const {
   if (info_.GnupgVersion >= "2.1.0") {
     if (gpgme_get_pinentry_mode(*this) != GPGME_PINENTRY_MODE_LOOPBACK) {
       gpgme_set_pinentry_mode(*this, GPGME_PINENTRY_MODE_LOOPBACK);
     }
-    gpgme_set_passphrase_cb(*this, cb, nullptr);
+    gpgme_set_passphrase_cb(*this, cb, opaque);
   } else {
     SPDLOG_ERROR("not supported for gnupg version: {}", info_.GnupgVersion);
   }
@@ -290,7 +346,15 @@ gpgme_error_t GpgContext::custom_passphrase_cb(void *opaque,
   if (passphrase.empty()) {
     // user input passphrase
     SPDLOG_DEBUG("might need user to input passparase");
-    passphrase = GpgContext::GetInstance().need_user_input_passphrase();
+    auto ask = [] {
+      return GpgContext::GetInstance().need_user_input_passphrase();
+    };
+    // the contexts of a batch ask once per key
+    auto *batch = static_cast<GpgBatchPassphrases *>(opaque);
+    passphrase = batch != nullptr
+                     ? batch->Get(uid_hint != nullptr ? uid_hint : "",
+                                  last_was_bad != 0, ask)
+                     : ask();
     if (passphrase.empty()) {
       gpgme_io_write(fd, "\n", 1);
       return gpgme_error_from_errno(GPG_ERR_CANCELED);
@@ -318,26 +382,47 @@ gpgme_error_t GpgContext::test_status_cb(void *hook, const char *keyword,
 }
 
 std::string GpgContext::need_user_input_passphrase() {
-  emit SignalNeedUserInputPassphrase();
+  std::unique_lock<std::mutex> lock(passphrase_prompt_lock, std::defer_lock);
+  if (is_gui_thread()) {
+    // the dialog of the prompt in progress needs this thread
+    while (!lock.try_lock())
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+  } else {
+    lock.lock();
+  }
+  return ask_user_passphrase();
+}
+
+std::string GpgContext::ask_user_passphrase() {
+  auto done = std::make_shared<std::promise<std::string>>();
+  auto answered = std::make_shared<std::atomic_bool>(false);
+  auto future = done->get_future();
 
-  std::string final_passphrase;
-  bool input_done = false;
-  SPDLOG_DEBUG("loop start to wait from user");
   auto connection =
       connect(CoreSignalStation::GetInstance(),
               &CoreSignalStation::SignalUserInputPassphraseDone, this,
-              [&](QString passphrase) {
+              [done, answered](QString passphrase) {
                 SPDLOG_DEBUG("SignalUserInputPassphraseDone emitted");
-                final_passphrase = passphrase.toStdString();
-                input_done = true;
+                if (!answered->exchange(true))
+                  done->set_value(passphrase.toStdString());
               });
-  while (!input_done) {
-    QCoreApplication::processEvents(QEventLoop::AllEvents, 800);
+  emit SignalNeedUserInputPassphrase();
+
+  SPDLOG_DEBUG("loop start to wait from user");
+  if (is_gui_thread()) {
+    // the dialog lives in this thread, keep it responsive
+    while (future.wait_for(std::chrono::seconds(0)) !=
+           std::future_status::ready) {
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 800);
+    }
+  } else {
+    // a worker thread has no events of its own to process
+    future.wait();
   }
   disconnect(connection);
 
   SPDLOG_DEBUG("lopper end");
-  return final_passphrase;
+  return future.get();
 }
 
 const GpgInfo &GpgContext::GetInfo(bool refresh) {
@@ -29,6 +29,9 @@
 #ifndef __SGPGMEPP_CONTEXT_H__
 #define __SGPGMEPP_CONTEXT_H__
 
+#include <functional>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <string>
 
@@ -59,9 +62,48 @@ struct GpgContextInitArgs {
 
   bool use_pinentry = false;
 
+  bool sync_init = false;  ///< finish the initialization in the constructor
+
   GpgContextInitArgs() = default;
 };
 
+/**
+ * @brief passphrases answered during one batch of operations, shared by the
+ * worker contexts of that batch only. They are kept by the key they unlock,
+ * so every key is asked once per batch, and wiped when the batch ends.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT GpgBatchPassphrases {
+ public:
+  GpgBatchPassphrases() = default;
+
+  /**
+   * @brief wipe the passphrases
+   *
+   */
+  ~GpgBatchPassphrases();
+
+  GpgBatchPassphrases(const GpgBatchPassphrases&) = delete;
+  GpgBatchPassphrases& operator=(const GpgBatchPassphrases&) = delete;
+
+  /**
+   * @brief Get the passphrase of the key named by uid_hint, ask is called
+   * when the key was not asked in this batch yet or its passphrase was
+   * rejected. Workers asking for the same key wait for one answer.
+   *
+   * @param uid_hint uid hint given by gpgme, the key id comes first
+   * @param last_was_bad whether the last passphrase was rejected
+   * @param ask shows the passphrase dialog
+   * @return std::string empty if the user cancelled
+   */
+  std::string Get(const std::string& uid_hint, bool last_was_bad,
+                  const std::function<std::string()>& ask);
+
+ private:
+  std::mutex mutex_;                                ///< held while asking
+  std::map<std::string, std::string> passphrases_;  ///< by key id
+};
+
 /**
  * @brief
  *
@@ -106,6 +148,21 @@ class GPGFRONTEND_CORE_EXPORT GpgContext
    */
   [[nodiscard]] const GpgInfo& GetInfo(bool refresh = false);
 
+  /**
+   * @brief Get the arguments this context was initialized with
+   *
+   * @return const GpgContextInitArgs&
+   */
+  [[nodiscard]] const GpgContextInitArgs& GetInitArgs() const;
+
+  /**
+   * @brief Share the passphrases of a batch with this context until it is
+   * reset with nullptr, contexts using pinentry are left alone
+   *
+   * @param passphrases passphrases of the batch, or nullptr
+   */
+  void SetBatchPassphrases(GpgBatchPassphrases* passphrases);
+
   /**
    * @brief
    *
@@ -126,12 +183,19 @@ class GPGFRONTEND_CORE_EXPORT GpgContext
   void post_init_ctx();
 
   /**
-   * @brief
+   * @brief ask the user for a passphrase, one dialog at a time
    *
-   * @return std::string
+   * @return std::string empty if the user cancelled
    */
   std::string need_user_input_passphrase();
 
+  /**
+   * @brief show the passphrase dialog and wait for its answer
+   *
+   * @return std::string empty if the user cancelled
+   */
+  std::string ask_user_passphrase();
+
   /**
    * @brief Construct a new std::check component existence object
    *
@@ -202,8 +266,10 @@ class GPGFRONTEND_CORE_EXPORT GpgContext
    * @brief Set the Passphrase Cb object
    *
    * @param func
+   * @param opaque passed to func
    */
-  void SetPassphraseCb(gpgme_passphrase_cb_t func) const;
+  void SetPassphraseCb(gpgme_passphrase_cb_t func,
+                       void* opaque = nullptr) const;
 };
 }  // namespace GpgFrontend
 
@@ -32,7 +32,11 @@
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <algorithm>
+#include <condition_variable>
 #include <filesystem>
+#include <mutex>
+#include <set>
 #include <string>
 
 #include "GpgFunctionObject.h"
@@ -43,9 +47,16 @@
 #include "thread/Task.h"
 #include "thread/TaskRunner.h"
 #include "thread/TaskRunnerGetter.h"
+#include "thread/TaskTracer.h"
 
 namespace GpgFrontend {
 
+namespace {
+std::mutex worker_channels_lock;             ///< guards the leased channels
+std::condition_variable worker_channels_cv;  ///< raised on a given back one
+std::set<int> leased_worker_channels;        ///<
+}  // namespace
+
 /**
  * @brief setup logging system and do proper initialization
  *
@@ -138,6 +149,11 @@ void init_gpgfrontend_core() {
       GpgFrontend::GlobalSettingStation::GetInstance().LookupSettings(
           "general.use_pinentry_as_password_input_dialog", false);
 
+  // off by default, it costs every task some time
+  Thread::TaskTracer::GetInstance().SetEnabled(
+      GlobalSettingStation::GetInstance().LookupSettings("advanced.task_trace",
+                                                         false));
+
   SPDLOG_DEBUG("core loaded if use custom key databse path: {}",
                use_custom_key_database_path);
   SPDLOG_DEBUG("core loaded custom key databse path: {}",
@@ -252,4 +268,58 @@ void new_default_settings_channel(int channel) {
       });
 }
 
+std::vector<int> LeaseWorkerChannels(int base_channel, int count) {
+  count = std::clamp(count, 1, GPGFRONTEND_MAX_WORKER_CHANNELS);
+  auto base_args = GpgContext::GetInstance(base_channel).GetInitArgs();
+  // workers are used right away, maybe from a thread without event loop
+  base_args.sync_init = true;
+
+  std::unique_lock<std::mutex> lock(worker_channels_lock);
+  std::vector<int> channels;
+  bool init_error = false;
+  while (true) {
+    for (int i = 0; i < GPGFRONTEND_MAX_WORKER_CHANNELS && !init_error &&
+                    static_cast<int>(channels.size()) < count;
+         i++) {
+      int channel = GPGFRONTEND_WORKER_CHANNEL_BASE +
+                    base_channel * GPGFRONTEND_MAX_WORKER_CHANNELS + i;
+      // driven by another batch
+      if (leased_worker_channels.count(channel) != 0) continue;
+
+      auto& ctx = GpgFrontend::GpgContext::CreateInstance(
+          channel, [&]() -> std::unique_ptr<ChannelObject> {
+            SPDLOG_DEBUG("create worker channel: {} base channel: {}",
+                         channel, base_channel);
+            return std::unique_ptr<ChannelObject>(new GpgContext(base_args));
+          });
+
+      if (!ctx.good()) {
+        SPDLOG_ERROR("worker channel init error: {}", channel);
+        init_error = true;
+        break;
+      }
+      leased_worker_channels.insert(channel);
+      channels.push_back(channel);
+    }
+
+    if (!channels.empty() || init_error) break;
+    SPDLOG_DEBUG("all worker channels of {} are leased, waiting",
+                 base_channel);
+    worker_channels_cv.wait(lock);
+  }
+  return channels;
+}
+
+void ReleaseWorkerChannels(const std::vector<int>& channels) {
+  // the next batch must not sign with the keys of this one
+  for (auto channel : channels)
+    gpgme_signers_clear(GpgContext::GetInstance(channel));
+
+  {
+    std::lock_guard<std::mutex> lock(worker_channels_lock);
+    for (auto channel : channels) leased_worker_channels.erase(channel);
+  }
+  worker_channels_cv.notify_all();
+}
+
 }  // namespace GpgFrontend
\ No newline at end of file
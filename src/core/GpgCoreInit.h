@@ -71,6 +71,30 @@ void reset_gpgfrontend_core();
 void new_default_settings_channel(
     int channel = GpgFrontend::GPGFRONTEND_DEFAULT_CHANNEL);
 
+/**
+ * @brief Lease the channels of the gpg contexts used by parallel workers,
+ * they are created on first use with the same settings as the base channel,
+ * so every worker drives its own gpg process. A leased channel is not handed
+ * to anyone else until it is given back by ReleaseWorkerChannels(). Blocks
+ * while every worker channel of the base channel is leased.
+ *
+ * @param base_channel channel whose settings are cloned
+ * @param count number of workers, at most GPGFRONTEND_MAX_WORKER_CHANNELS
+ * @return std::vector<int> between 1 and count channels, empty if no worker
+ * context can be created
+ */
+std::vector<int> GPGFRONTEND_CORE_EXPORT
+LeaseWorkerChannels(int base_channel, int count);
+
+/**
+ * @brief give back the channels leased by LeaseWorkerChannels(), the signers
+ * set on their contexts are cleared
+ *
+ * @param channels
+ */
+void GPGFRONTEND_CORE_EXPORT
+ReleaseWorkerChannels(const std::vector<int>& channels);
+
 }  // namespace GpgFrontend
 
 #endif  // GPGFRONTEND_GPGCOREINIT_H
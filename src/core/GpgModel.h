@@ -32,6 +32,7 @@
 #include "core/GpgConstants.h"
 #include "core/model/GpgData.h"
 #include "core/model/GpgKey.h"
+#include "core/model/GpgKeySummaryTable.h"
 #include "core/model/GpgSignature.h"
 
 namespace GpgFrontend {
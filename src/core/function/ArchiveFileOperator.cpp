@@ -28,6 +28,47 @@
 
 #include "ArchiveFileOperator.h"
 
+#include <array>
+
+namespace {
+
+using ArchivePtr = std::unique_ptr<struct archive, int (*)(struct archive *)>;
+
+/**
+ * @brief libarchive write callback pushing the archive into a data exchanger
+ *
+ */
+la_ssize_t archive_write_exchanger_cb(struct archive *, void *client_data,
+                                      const void *buffer, size_t length) {
+  auto *exchanger = static_cast<GpgFrontend::DataExchanger *>(client_data);
+  auto ret = exchanger->Write(static_cast<const char *>(buffer), length);
+  return ret < 0 ? ARCHIVE_FATAL : ret;
+}
+
+/**
+ * @brief state of a libarchive reader pulling from a data exchanger
+ *
+ */
+struct ArchiveReadExchanger {
+  GpgFrontend::DataExchanger *exchanger;  ///<
+  std::array<char, 64 * 1024> buffer;     ///< handed out to libarchive
+};
+
+/**
+ * @brief libarchive read callback pulling the archive from a data exchanger
+ *
+ */
+la_ssize_t archive_read_exchanger_cb(struct archive *, void *client_data,
+                                     const void **buffer) {
+  auto *reader = static_cast<ArchiveReadExchanger *>(client_data);
+  *buffer = reader->buffer.data();
+  auto ret =
+      reader->exchanger->Read(reader->buffer.data(), reader->buffer.size());
+  return ret < 0 ? ARCHIVE_FATAL : ret;
+}
+
+}  // namespace
+
 int copy_data(struct archive *ar, struct archive *aw) {
   int r;
   const void *buff;
@@ -261,6 +302,231 @@ void GpgFrontend::ArchiveFileOperator::ExtractArchive(
   QDir::setCurrent(current_base_path_backup);
 }
 
+void GpgFrontend::ArchiveFileOperator::NewArchive2DataExchanger(
+    const std::filesystem::path &target_directory,
+    std::shared_ptr<DataExchanger> exchanger) {
+  SPDLOG_DEBUG("NewArchive2DataExchanger: {}", target_directory.u8string());
+
+  try {
+    // "dir/" has no file name, the entries would lose the "dir" prefix
+    auto directory = target_directory.lexically_normal();
+    if (!directory.has_filename()) directory = directory.parent_path();
+    auto base_path = directory.parent_path();
+
+    ArchivePtr a(archive_write_new(), archive_write_free);
+    archive_write_add_filter_none(a.get());
+    archive_write_set_format_pax_restricted(a.get());
+
+    if (archive_write_open(a.get(), exchanger.get(), nullptr,
+                           archive_write_exchanger_cb,
+                           nullptr) != ARCHIVE_OK) {
+      SPDLOG_ERROR("archive_write_open() failed: {}",
+                   archive_error_string(a.get()));
+      throw std::runtime_error("archive_write_open() failed");
+    }
+
+    ArchivePtr disk(archive_read_disk_new(), archive_read_free);
+#ifndef NO_LOOKUP
+    archive_read_disk_set_standard_lookup(disk.get());
+#endif
+
+#ifdef WINDOWS
+    auto r = archive_read_disk_open_w(disk.get(), directory.wstring().c_str());
+#else
+    auto r = archive_read_disk_open(disk.get(), directory.u8string().c_str());
+#endif
+    if (r != ARCHIVE_OK) {
+      SPDLOG_ERROR("archive_read_disk_open() failed: {}",
+                   archive_error_string(disk.get()));
+      throw std::runtime_error("archive_read_disk_open() failed");
+    }
+
+    // files are copied in chunks, memory stays bounded for large files
+    auto buff = std::make_unique<std::array<char, 64 * 1024>>();
+
+    for (;;) {
+      std::unique_ptr<struct archive_entry, void (*)(struct archive_entry *)>
+          entry(archive_entry_new(), archive_entry_free);
+
+      r = archive_read_next_header2(disk.get(), entry.get());
+      if (r == ARCHIVE_EOF) break;
+      if (r != ARCHIVE_OK) {
+        SPDLOG_ERROR("archive_read_next_header2() failed: {}",
+                     archive_error_string(disk.get()));
+        throw std::runtime_error("archive_read_next_header2() failed");
+      }
+      archive_read_disk_descend(disk.get());
+
+      // name the entry relative to the base path, without changing the
+      // current directory of the process
+#ifdef WINDOWS
+      auto source_path =
+          std::filesystem::path(archive_entry_sourcepath_w(entry.get()));
+#else
+      auto source_path =
+          std::filesystem::path(archive_entry_sourcepath(entry.get()));
+#endif
+      archive_entry_set_pathname_utf8(
+          entry.get(),
+          std::filesystem::relative(source_path, base_path).u8string().c_str());
+
+      SPDLOG_DEBUG("Adding: {} size: {} bytes: {} file type: {}",
+                   archive_entry_pathname_utf8(entry.get()),
+                   archive_entry_size(entry.get()),
+                   archive_entry_filetype(entry.get()));
+
+      r = archive_write_header(a.get(), entry.get());
+      if (r < ARCHIVE_OK) {
+        SPDLOG_ERROR("archive_write_header() failed: {}",
+                     archive_error_string(a.get()));
+        throw std::runtime_error("archive_write_header() failed");
+      }
+
+      if (archive_entry_filetype(entry.get()) != AE_IFREG ||
+          archive_entry_size(entry.get()) <= 0)
+        continue;
+
+#ifdef WINDOWS
+      QFile file(QString::fromStdU16String(source_path.u16string()));
+#else
+      QFile file(QString::fromStdString(source_path.u8string()));
+#endif
+      if (!file.open(QIODevice::ReadOnly)) {
+        SPDLOG_ERROR("cannot read file: {}", source_path.u8string());
+        throw std::runtime_error("read file error");
+      }
+
+      qint64 len;
+      while ((len = file.read(buff->data(), buff->size())) > 0) {
+        if (archive_write_data(a.get(), buff->data(), len) < 0) {
+          SPDLOG_ERROR("archive_write_data() failed: {}",
+                       archive_error_string(a.get()));
+          throw std::runtime_error("archive_write_data() failed");
+        }
+      }
+      if (len < 0) throw std::runtime_error("read file error");
+    }
+
+    archive_read_close(disk.get());
+    if (archive_write_close(a.get()) != ARCHIVE_OK) {
+      SPDLOG_ERROR("archive_write_close() failed: {}",
+                   archive_error_string(a.get()));
+      throw std::runtime_error("archive_write_close() failed");
+    }
+  } catch (...) {
+    exchanger->CloseWrite();
+    throw;
+  }
+
+  exchanger->CloseWrite();
+}
+
+void GpgFrontend::ArchiveFileOperator::ExtractArchiveFromDataExchanger(
+    std::shared_ptr<DataExchanger> exchanger,
+    const std::filesystem::path &base_path) {
+  SPDLOG_DEBUG("ExtractArchiveFromDataExchanger: {}", base_path.u8string());
+
+  auto reader = std::make_unique<ArchiveReadExchanger>();
+  reader->exchanger = exchanger.get();
+
+  try {
+    ArchivePtr a(archive_read_new(), archive_read_free);
+    ArchivePtr ext(archive_write_disk_new(), archive_write_free);
+    archive_write_disk_set_options(
+        ext.get(), ARCHIVE_EXTRACT_SECURE_NODOTDOT |
+                       ARCHIVE_EXTRACT_SECURE_SYMLINKS | ARCHIVE_EXTRACT_TIME);
+#ifndef NO_BZIP2_EXTRACT
+    archive_read_support_filter_bzip2(a.get());
+#endif
+#ifndef NO_GZIP_EXTRACT
+    archive_read_support_filter_gzip(a.get());
+#endif
+#ifndef NO_COMPRESS_EXTRACT
+    archive_read_support_filter_compress(a.get());
+#endif
+#ifndef NO_TAR_EXTRACT
+    archive_read_support_format_tar(a.get());
+#endif
+#ifndef NO_CPIO_EXTRACT
+    archive_read_support_format_cpio(a.get());
+#endif
+#ifndef NO_LOOKUP
+    archive_write_disk_set_standard_lookup(ext.get());
+#endif
+
+    if (archive_read_open(a.get(), reader.get(), nullptr,
+                          archive_read_exchanger_cb, nullptr) != ARCHIVE_OK) {
+      SPDLOG_ERROR("archive_read_open() failed: {}",
+                   archive_error_string(a.get()));
+      throw std::runtime_error("archive_read_open() failed");
+    }
+
+    struct archive_entry *entry;
+    for (;;) {
+      int r = archive_read_next_header(a.get(), &entry);
+      if (r == ARCHIVE_EOF) break;
+      if (r != ARCHIVE_OK) {
+        SPDLOG_ERROR("archive_read_next_header() failed: {}",
+                     archive_error_string(a.get()));
+        throw std::runtime_error("archive_read_next_header() failed");
+      }
+
+      // place the entry under the base path, without changing the current
+      // directory of the process
+      auto entry_path =
+          std::filesystem::u8path(archive_entry_pathname_utf8(entry));
+      if (entry_path.is_absolute()) {
+        SPDLOG_ERROR("absolute path in archive: {}", entry_path.u8string());
+        throw std::runtime_error("absolute path in archive");
+      }
+      archive_entry_set_pathname_utf8(
+          entry, (base_path / entry_path).u8string().c_str());
+
+      const char *hardlink = archive_entry_hardlink(entry);
+      if (hardlink != nullptr) {
+        archive_entry_set_hardlink(
+            entry, (base_path / std::filesystem::u8path(hardlink))
+                       .u8string()
+                       .c_str());
+      }
+
+      SPDLOG_DEBUG("Extracting: {} size: {} bytes: {} file type: {}",
+                   archive_entry_pathname_utf8(entry),
+                   archive_entry_size(entry), archive_entry_filetype(entry));
+
+      // an entry rejected or written partly fails the whole archive, so that
+      // the caller can throw away what was extracted
+      r = archive_write_header(ext.get(), entry);
+      if (r != ARCHIVE_OK) {
+        SPDLOG_ERROR("archive_write_header() failed: {}",
+                     archive_error_string(ext.get()));
+        throw std::runtime_error("archive_write_header() failed");
+      }
+      r = copy_data(a.get(), ext.get());
+      if (r != ARCHIVE_OK) {
+        SPDLOG_ERROR("copy_data() failed: {}", archive_error_string(ext.get()));
+        throw std::runtime_error("copy_data() failed");
+      }
+    }
+
+    archive_read_close(a.get());
+    // the last entry is completed on close
+    if (archive_write_close(ext.get()) != ARCHIVE_OK) {
+      SPDLOG_ERROR("archive_write_close() failed: {}",
+                   archive_error_string(ext.get()));
+      throw std::runtime_error("archive_write_close() failed");
+    }
+  } catch (...) {
+    exchanger->CloseRead();
+    throw;
+  }
+
+  // consume the padding after the end of the archive, so the writer is not
+  // blocked on a full exchanger
+  while (exchanger->Read(reader->buffer.data(), reader->buffer.size()) > 0) {
+  }
+}
+
 void GpgFrontend::ArchiveFileOperator::ListArchive(
     const std::filesystem::path &archive_path) {
   struct archive *a;
@@ -31,6 +31,7 @@
 
 #include "core/GpgFrontendCore.h"
 #include "core/function/FileOperator.h"
+#include "core/model/DataExchanger.h"
 
 namespace GpgFrontend {
 
@@ -53,6 +54,31 @@ class GPGFRONTEND_CORE_EXPORT ArchiveFileOperator {
 
   static void ExtractArchive(const std::filesystem::path &archive_path,
                              const std::filesystem::path &base_path);
+
+  /**
+   * @brief Write a tar archive of a directory into a data exchanger, no
+   * archive file is created. The write side of the exchanger is closed when
+   * done, also on failure.
+   *
+   * @param target_directory directory to archive, the entries are named
+   * relative to its parent directory
+   * @param exchanger where the archive is written to
+   */
+  static void NewArchive2DataExchanger(
+      const std::filesystem::path &target_directory,
+      std::shared_ptr<DataExchanger> exchanger);
+
+  /**
+   * @brief Extract a tar archive read from a data exchanger as it arrives, no
+   * archive file is needed. The read side of the exchanger is closed on
+   * failure, so that the writer stops.
+   *
+   * @param exchanger where the archive is read from
+   * @param base_path directory the entries are extracted into
+   */
+  static void ExtractArchiveFromDataExchanger(
+      std::shared_ptr<DataExchanger> exchanger,
+      const std::filesystem::path &base_path);
 };
 }  // namespace GpgFrontend
 
@@ -32,16 +32,40 @@
 #include <boost/format.hpp>
 #include <string>
 
+#include "core/thread/TaskRunnerGetter.h"
 #include "function/DataObjectOperator.h"
 #include "spdlog/spdlog.h"
 
 GpgFrontend::CacheManager::CacheManager(int channel)
-    : m_timer_(new QTimer(this)),
-      SingletonFunctionObject<CacheManager>(channel) {
-  connect(m_timer_, &QTimer::timeout, this, &CacheManager::flush_cache_storage);
-  m_timer_->start(15000);
-
+    : SingletonFunctionObject<CacheManager>(channel) {
   load_all_cache_storage();
+
+  // the posted flush may still be queued or running while the manager is
+  // destroyed
+  auto flush = [this, state = flush_state_](Thread::Task::DataObjectPtr) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->alive) flush_cache_storage();
+    return 0;
+  };
+
+  // flush in the background, off the thread using the cache
+  flush_timer_id_ =
+      Thread::TaskRunnerGetter::GetInstance()
+          .GetTaskRunner(Thread::TaskRunnerGetter::kTaskRunnerType_IO)
+          ->PostScheduleTask(
+              flush, "flush_cache_storage", std::chrono::seconds(15),
+              std::chrono::seconds(15),
+              (boost::format("flush_cache_storage/%1%") % channel).str());
+}
+
+GpgFrontend::CacheManager::~CacheManager() {
+  Thread::TaskRunnerGetter::GetInstance()
+      .GetTaskRunner(Thread::TaskRunnerGetter::kTaskRunnerType_IO)
+      ->CancelScheduleTask(flush_timer_id_);
+
+  // waits for a running flush, later ones are skipped
+  std::lock_guard<std::mutex> lock(flush_state_->mutex);
+  flush_state_->alive = false;
 }
 
 void GpgFrontend::CacheManager::SaveCache(std::string key,
@@ -50,10 +74,13 @@ void GpgFrontend::CacheManager::SaveCache(std::string key,
   auto data_object_key = get_data_object_key(key);
   cache_storage_.insert(key, value);
 
-  if (std::find(key_storage_.begin(), key_storage_.end(), key) ==
-      key_storage_.end()) {
-    SPDLOG_DEBUG("register new key of cache", key);
-    key_storage_.push_back(key);
+  {
+    std::lock_guard<std::mutex> lock(key_storage_mutex_);
+    if (std::find(key_storage_.begin(), key_storage_.end(), key) ==
+        key_storage_.end()) {
+      SPDLOG_DEBUG("register new key of cache", key);
+      key_storage_.push_back(key);
+    }
   }
 
   if (flush) {
@@ -108,6 +135,8 @@ nlohmann::json GpgFrontend::CacheManager::load_cache_storage(
 }
 
 void GpgFrontend::CacheManager::flush_cache_storage() {
+  // called by the periodic flush and by SaveCache() at the same time
+  std::lock_guard<std::mutex> lock(key_storage_mutex_);
   for (auto cache : cache_storage_.mirror()) {
     auto key = get_data_object_key(cache.first);
     SPDLOG_DEBUG("save cache into filesystem, key {}, value size: {}", key,
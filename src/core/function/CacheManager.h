@@ -29,6 +29,8 @@
 #ifndef GPGFRONTEND_CACHEMANAGER_H
 #define GPGFRONTEND_CACHEMANAGER_H
 
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include "core/GpgFunctionObject.h"
@@ -83,6 +85,8 @@ class GPGFRONTEND_CORE_EXPORT CacheManager
  public:
   CacheManager(int channel = SingletonFunctionObject::GetDefaultChannel());
 
+  ~CacheManager() override;
+
   void SaveCache(std::string key, const nlohmann::json& value,
                  bool flush = false);
 
@@ -102,9 +106,21 @@ class GPGFRONTEND_CORE_EXPORT CacheManager
 
   void register_cache_key(std::string key);
 
+  /**
+   * @brief state shared with the periodic flush, which outlives the manager
+   *
+   */
+  struct FlushState {
+    std::mutex mutex;   ///< held while a flush runs
+    bool alive = true;  ///< false once the manager is destroyed
+  };
+
   ThreadSafeMap<std::string, nlohmann::json> cache_storage_;
   nlohmann::json key_storage_;
-  QTimer* m_timer_;
+  std::mutex key_storage_mutex_;  ///< guards key_storage_ and the flush
+  uint64_t flush_timer_id_ = 0;   ///< the schedule of the periodic flush
+  std::shared_ptr<FlushState> flush_state_ =
+      std::make_shared<FlushState>();  ///< guards the posted flush
   const std::string drk_key_ = "__cache_manage_data_register_key_list";
 };
 
@@ -28,6 +28,155 @@
 
 #include "FileOperator.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace {
+
+/// a multiple of the page size, large enough to keep the disk busy
+constexpr qint64 kHashChunkSize = 4 * 1024 * 1024;
+
+/// smallest chunk, used for empty files and files of unknown size
+constexpr qint64 kHashMinChunkSize = 4096;
+
+/// chunks in flight between the reader and the digest workers
+constexpr size_t kHashQueueDepth = 3;
+
+/**
+ * @brief algorithms known to the digest engine, in display order, without a
+ * QCryptographicHash algorithm if this build of Qt lacks it
+ *
+ */
+const std::vector<
+    std::tuple<unsigned int, std::optional<QCryptographicHash::Algorithm>,
+               const char*>>&
+supported_hash_algorithms() {
+  static const std::vector<
+      std::tuple<unsigned int, std::optional<QCryptographicHash::Algorithm>,
+                 const char*>>
+      algorithms = {
+          {GpgFrontend::FileOperator::kHashMd5, QCryptographicHash::Md5,
+           "md5"},
+          {GpgFrontend::FileOperator::kHashSha1, QCryptographicHash::Sha1,
+           "sha1"},
+          {GpgFrontend::FileOperator::kHashSha256, QCryptographicHash::Sha256,
+           "sha256"},
+          {GpgFrontend::FileOperator::kHashSha512, QCryptographicHash::Sha512,
+           "sha512"},
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+          {GpgFrontend::FileOperator::kHashBlake2b512,
+           QCryptographicHash::Blake2b_512, "blake2b512"},
+#else
+          {GpgFrontend::FileOperator::kHashBlake2b512, std::nullopt,
+           "blake2b512"},
+#endif
+      };
+  return algorithms;
+}
+
+/**
+ * @brief feeds the chunks of a file to several digests, every digest is
+ * updated by one worker thread living as long as the file is read, the
+ * reader stays at most kHashQueueDepth chunks ahead of the slowest worker
+ *
+ */
+class DigestPipeline {
+ public:
+  DigestPipeline(std::vector<std::unique_ptr<QCryptographicHash>>& hashes,
+                 qint64 chunk_size)
+      : hashes_(hashes),
+        chunks_(kHashQueueDepth, std::vector<char>(chunk_size)),
+        lens_(kHashQueueDepth, 0),
+        consumed_(hashes.size(), 0) {}
+
+  /**
+   * @brief read the file to its end, feeding every chunk to the digests
+   *
+   * @param file opened file
+   * @param file_size bytes read
+   * @return true if success
+   * @return false if reading the file failed
+   */
+  bool Run(QFile& file, uint64_t& file_size) {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < hashes_.size(); i++) {
+      workers.emplace_back([this, i]() { work(i); });
+    }
+
+    qint64 len = 0;
+    for (size_t index = 0;; index++) {
+      auto& chunk = chunks_[index % kHashQueueDepth];
+      {
+        // wait until every worker is done with the chunk to be overwritten
+        std::unique_lock<std::mutex> lock(lock_);
+        cv_.wait(lock, [&]() {
+          return index - *std::min_element(consumed_.begin(),
+                                           consumed_.end()) <
+                 kHashQueueDepth;
+        });
+      }
+
+      len = file.read(chunk.data(), static_cast<qint64>(chunk.size()));
+      if (len <= 0) break;
+      file_size += len;
+
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        lens_[index % kHashQueueDepth] = len;
+        published_ = index + 1;
+      }
+      cv_.notify_all();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      finished_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers) worker.join();
+    return len == 0;
+  }
+
+ private:
+  std::vector<std::unique_ptr<QCryptographicHash>>& hashes_;  ///<
+  std::vector<std::vector<char>> chunks_;  ///< ring of chunks
+  std::vector<qint64> lens_;               ///< bytes in every chunk
+  std::vector<size_t> consumed_;           ///< chunks done by every worker
+  size_t published_ = 0;                   ///< chunks read
+  bool finished_ = false;                  ///< nothing more will be read
+  std::mutex lock_;                        ///<
+  std::condition_variable cv_;             ///<
+
+  void work(size_t worker) {
+    for (;;) {
+      size_t index;
+      qint64 len;
+      {
+        std::unique_lock<std::mutex> lock(lock_);
+        cv_.wait(lock,
+                 [&]() { return consumed_[worker] < published_ || finished_; });
+        if (consumed_[worker] == published_) return;
+        index = consumed_[worker];
+        len = lens_[index % kHashQueueDepth];
+      }
+
+      hashes_[worker]->addData(chunks_[index % kHashQueueDepth].data(),
+                               static_cast<int>(len));
+
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        consumed_[worker]++;
+      }
+      cv_.notify_all();
+    }
+  }
+};
+
+}  // namespace
+
 bool GpgFrontend::FileOperator::ReadFile(const QString& file_name,
                                          QByteArray& data) {
   QFile file(file_name);
@@ -72,50 +221,90 @@ bool GpgFrontend::FileOperator::WriteFileStd(
                    QByteArray::fromStdString(data));
 }
 
+bool GpgFrontend::FileOperator::CalculateDigests(
+    const std::filesystem::path& file_path, unsigned int algorithms,
+    bool parallel, std::vector<std::pair<std::string, std::string>>& digests,
+    uint64_t& file_size) {
+#ifdef WINDOWS
+  QFile f(QString::fromStdU16String(file_path.u16string()));
+#else
+  QFile f(QString::fromStdString(file_path.u8string()));
+#endif
+  // the chunks are large already, skip the copy through QFile's own buffer
+  if (!f.open(QFile::ReadOnly | QFile::Unbuffered)) {
+    SPDLOG_ERROR("failed to open file: {}", file_path.u8string());
+    return false;
+  }
+
+  digests.clear();
+  std::vector<std::unique_ptr<QCryptographicHash>> hashes;
+  for (const auto& [flag, algorithm, name] : supported_hash_algorithms()) {
+    if ((algorithms & flag) == 0) continue;
+    if (!algorithm.has_value()) {
+      SPDLOG_WARN("digest not supported by this build: {}", name);
+      continue;
+    }
+    hashes.push_back(std::make_unique<QCryptographicHash>(*algorithm));
+  }
+
+  // small files don't need the large chunks
+  auto chunk_size = std::clamp(f.size(), kHashMinChunkSize, kHashChunkSize);
+  file_size = 0;
+
+  if (parallel && hashes.size() > 1) {
+    if (!DigestPipeline(hashes, chunk_size).Run(f, file_size)) {
+      SPDLOG_ERROR("failed to read file: {}", file_path.u8string());
+      return false;
+    }
+  } else {
+    std::vector<char> chunk(chunk_size);
+    qint64 len;
+    while ((len = f.read(chunk.data(), chunk_size)) > 0) {
+      file_size += len;
+      for (auto& hash : hashes) {
+        hash->addData(chunk.data(), static_cast<int>(len));
+      }
+    }
+    if (len < 0) {
+      SPDLOG_ERROR("failed to read file: {}", file_path.u8string());
+      return false;
+    }
+  }
+
+  auto hash = hashes.begin();
+  for (const auto& [flag, algorithm, name] : supported_hash_algorithms()) {
+    if ((algorithms & flag) == 0) continue;
+    // an empty digest marks an algorithm this build can't compute
+    digests.emplace_back(name, algorithm.has_value()
+                                   ? (*hash++)->result().toHex().toStdString()
+                                   : std::string());
+    SPDLOG_DEBUG("{} {}", digests.back().first, digests.back().second);
+  }
+  return true;
+}
+
 std::string GpgFrontend::FileOperator::CalculateHash(
-    const std::filesystem::path& file_path) {
-  // Returns empty QByteArray() on failure.
+    const std::filesystem::path& file_path, unsigned int algorithms,
+    bool parallel) {
   QFileInfo info(QString::fromStdString(file_path.string()));
   std::stringstream ss;
 
-  if (info.isFile() && info.isReadable()) {
+  std::vector<std::pair<std::string, std::string>> digests;
+  uint64_t file_size = 0;
+  if (info.isFile() && info.isReadable() &&
+      CalculateDigests(file_path, algorithms, parallel, digests, file_size)) {
     ss << "[#] " << _("File Hash Information") << std::endl;
     ss << "    " << _("filename") << _(": ")
        << file_path.filename().u8string().c_str() << std::endl;
+    ss << "    " << _("file size(bytes)") << _(": ") << file_size
+       << std::endl;
 
-    QFile f(info.filePath());
-    if (f.open(QFile::ReadOnly)) {
-      // read all data
-      auto buffer = f.readAll();
-      ss << "    " << _("file size(bytes)") << _(": ") << buffer.size()
-         << std::endl;
-
-      // md5
-      auto hash_md5 = QCryptographicHash(QCryptographicHash::Md5);
-      hash_md5.addData(buffer);
-      auto md5 = hash_md5.result().toHex().toStdString();
-      SPDLOG_DEBUG("md5 {}", md5);
-      ss << "    "
-         << "md5" << _(": ") << md5 << std::endl;
-
-      // sha1
-      auto hash_sha1 = QCryptographicHash(QCryptographicHash::Sha1);
-      hash_sha1.addData(buffer);
-      auto sha1 = hash_sha1.result().toHex().toStdString();
-      SPDLOG_DEBUG("sha1 {}", sha1);
-      ss << "    "
-         << "sha1" << _(": ") << sha1 << std::endl;
-
-      // sha1
-      auto hash_sha256 = QCryptographicHash(QCryptographicHash::Sha256);
-      hash_sha256.addData(buffer);
-      auto sha256 = hash_sha256.result().toHex().toStdString();
-      SPDLOG_DEBUG("sha256 {}", sha256);
-      ss << "    "
-         << "sha256" << _(": ") << sha256 << std::endl;
-
-      ss << std::endl;
+    for (const auto& [name, digest] : digests) {
+      ss << "    " << name << _(": ")
+         << (digest.empty() ? _("not supported") : digest) << std::endl;
     }
+
+    ss << std::endl;
   } else {
     ss << "[#] " << _("Error in Calculating File Hash ") << std::endl;
   }
@@ -39,6 +39,22 @@ namespace GpgFrontend {
  */
 class GPGFRONTEND_CORE_EXPORT FileOperator {
  public:
+  /**
+   * @brief digest algorithms, can be combined
+   *
+   */
+  enum HashAlgorithm : unsigned int {
+    kHashMd5 = 1 << 0,         ///<
+    kHashSha1 = 1 << 1,        ///<
+    kHashSha256 = 1 << 2,      ///<
+    kHashSha512 = 1 << 3,      ///<
+    kHashBlake2b512 = 1 << 4,  ///< requires Qt 6
+  };
+
+  ///< digests shown by default
+  static constexpr unsigned int kDefaultHashAlgorithms =
+      kHashMd5 | kHashSha1 | kHashSha256;
+
   /**
    * @brief read file content using std struct
    *
@@ -80,12 +96,38 @@ class GPGFRONTEND_CORE_EXPORT FileOperator {
    */
   static bool WriteFile(const QString &file_name, const QByteArray &data);
 
+  /**
+   * @brief calculate several digests of a file, the file is read only once in
+   * large chunks and every chunk is fed to all the digests, so the memory
+   * used does not depend on the size of the file.
+   *
+   * @param file_path path of the file
+   * @param algorithms combination of HashAlgorithm
+   * @param parallel update every digest on its own worker thread, while the
+   * next chunks are being read
+   * @param digests name and hex value of every digest, in the order of
+   * HashAlgorithm, the value is empty for an algorithm this build of Qt does
+   * not support
+   * @param file_size bytes read
+   * @return true if success
+   * @return false if the file can not be read
+   */
+  static bool CalculateDigests(
+      const std::filesystem::path &file_path, unsigned int algorithms,
+      bool parallel,
+      std::vector<std::pair<std::string, std::string>> &digests,
+      uint64_t &file_size);
+
   /**
    * calculate the hash of a file
    * @param file_path
+   * @param algorithms combination of HashAlgorithm
+   * @param parallel update every digest on its own thread
    * @return
    */
-  static std::string CalculateHash(const std::filesystem::path &file_path);
+  static std::string CalculateHash(
+      const std::filesystem::path &file_path,
+      unsigned int algorithms = kDefaultHashAlgorithms, bool parallel = true);
 };
 }  // namespace GpgFrontend
 
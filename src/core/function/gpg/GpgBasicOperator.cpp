@@ -38,6 +38,23 @@ GpgFrontend::GpgBasicOperator::GpgBasicOperator(int channel)
 GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Encrypt(
     KeyListPtr keys, GpgFrontend::BypeArrayRef in_buffer,
     GpgFrontend::ByteArrayPtr& out_buffer, GpgFrontend::GpgEncrResult& result) {
+  // gpgme reads the input in place and writes the output straight into the
+  // result buffer, nothing is copied in between
+  GpgData data_in(in_buffer.data(), in_buffer.size(), false);
+  auto temp_data_out = std::make_unique<std::string>();
+  temp_data_out->reserve(in_buffer.size());
+  GpgData data_out(*temp_data_out);
+
+  auto err = Encrypt(std::move(keys), data_in, data_out, result);
+
+  std::swap(temp_data_out, out_buffer);
+
+  return err;
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Encrypt(
+    KeyListPtr keys, GpgData& data_in, GpgData& data_out,
+    GpgEncrResult& result) {
   // gpgme_encrypt_result_t e_result;
   gpgme_key_t recipients[keys->size() + 1];
 
@@ -47,14 +64,9 @@ GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Encrypt(
   // Last entry data_in array has to be nullptr
   recipients[keys->size()] = nullptr;
 
-  GpgData data_in(in_buffer.data(), in_buffer.size()), data_out;
-
   gpgme_error_t err = check_gpg_error(gpgme_op_encrypt(
       ctx_, recipients, GPGME_ENCRYPT_ALWAYS_TRUST, data_in, data_out));
 
-  auto temp_data_out = data_out.Read2Buffer();
-  std::swap(temp_data_out, out_buffer);
-
   auto temp_result = _new_result(gpgme_op_encrypt_result(ctx_));
   std::swap(result, temp_result);
 
@@ -64,14 +76,23 @@ GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Encrypt(
 GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Decrypt(
     BypeArrayRef in_buffer, GpgFrontend::ByteArrayPtr& out_buffer,
     GpgFrontend::GpgDecrResult& result) {
-  gpgme_error_t err;
+  GpgData data_in(in_buffer.data(), in_buffer.size(), false);
+  auto temp_data_out = std::make_unique<std::string>();
+  temp_data_out->reserve(in_buffer.size());
+  GpgData data_out(*temp_data_out);
 
-  GpgData data_in(in_buffer.data(), in_buffer.size()), data_out;
-  err = check_gpg_error(gpgme_op_decrypt(ctx_, data_in, data_out));
+  auto err = Decrypt(data_in, data_out, result);
 
-  auto temp_data_out = data_out.Read2Buffer();
   std::swap(temp_data_out, out_buffer);
 
+  return err;
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Decrypt(
+    GpgData& data_in, GpgData& data_out, GpgDecrResult& result) {
+  gpgme_error_t err =
+      check_gpg_error(gpgme_op_decrypt(ctx_, data_in, data_out));
+
   auto temp_result = _new_result(gpgme_op_decrypt_result(ctx_));
   std::swap(result, temp_result);
 
@@ -81,15 +102,24 @@ GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Decrypt(
 GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Verify(
     BypeArrayRef& in_buffer, ByteArrayPtr& sig_buffer,
     GpgVerifyResult& result) const {
-  gpgme_error_t err;
-
-  GpgData data_in(in_buffer.data(), in_buffer.size());
+  GpgData data_in(in_buffer.data(), in_buffer.size(), false);
   GpgData data_out;
 
   if (sig_buffer != nullptr && sig_buffer->size() > 0) {
-    GpgData sig_data(sig_buffer->data(), sig_buffer->size());
-    err = check_gpg_error(gpgme_op_verify(ctx_, sig_data, data_in, nullptr));
-  } else
+    GpgData sig_data(sig_buffer->data(), sig_buffer->size(), false);
+    return Verify(data_in, &sig_data, data_out, result);
+  }
+  return Verify(data_in, nullptr, data_out, result);
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Verify(
+    GpgData& data_in, GpgData* sig_data, GpgData& data_out,
+    GpgVerifyResult& result) const {
+  gpgme_error_t err;
+
+  if (sig_data != nullptr)
+    err = check_gpg_error(gpgme_op_verify(ctx_, *sig_data, data_in, nullptr));
+  else
     err = check_gpg_error(gpgme_op_verify(ctx_, data_in, nullptr, data_out));
 
   auto temp_result = _new_result(gpgme_op_verify_result(ctx_));
@@ -101,20 +131,35 @@ GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Verify(
 GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Sign(
     KeyListPtr signers, BypeArrayRef in_buffer, ByteArrayPtr& out_buffer,
     gpgme_sig_mode_t mode, GpgSignResult& result) {
-  gpgme_error_t err;
+  GpgData data_in(in_buffer.data(), in_buffer.size(), false);
+  auto temp_data_out = std::make_unique<std::string>();
+  // a detached signature is a few hundred bytes whatever the input size
+  if (mode != GPGME_SIG_MODE_DETACH) temp_data_out->reserve(in_buffer.size());
+  GpgData data_out(*temp_data_out);
+
+  auto err = Sign(std::move(signers), data_in, data_out, mode, result);
+
+  std::swap(temp_data_out, out_buffer);
 
+  return err;
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Sign(
+    KeyListPtr signers, GpgData& data_in, GpgData& data_out,
+    gpgme_sig_mode_t mode, GpgSignResult& result) {
   // Set Singers of this opera
   SetSigners(*signers);
 
-  GpgData data_in(in_buffer.data(), in_buffer.size()), data_out;
-
-  err = check_gpg_error(gpgme_op_sign(ctx_, data_in, data_out, mode));
+  return Sign(data_in, data_out, mode, result);
+}
 
-  auto temp_data_out = data_out.Read2Buffer();
-  std::swap(temp_data_out, out_buffer);
+GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Sign(
+    GpgData& data_in, GpgData& data_out, gpgme_sig_mode_t mode,
+    GpgSignResult& result) {
+  gpgme_error_t err =
+      check_gpg_error(gpgme_op_sign(ctx_, data_in, data_out, mode));
 
   auto temp_result = _new_result(gpgme_op_sign_result(ctx_));
-
   std::swap(result, temp_result);
 
   return err;
@@ -123,15 +168,24 @@ GpgFrontend::GpgError GpgFrontend::GpgBasicOperator::Sign(
 gpgme_error_t GpgFrontend::GpgBasicOperator::DecryptVerify(
     BypeArrayRef in_buffer, ByteArrayPtr& out_buffer,
     GpgDecrResult& decrypt_result, GpgVerifyResult& verify_result) {
-  gpgme_error_t err;
+  GpgData data_in(in_buffer.data(), in_buffer.size(), false);
+  auto temp_data_out = std::make_unique<std::string>();
+  temp_data_out->reserve(in_buffer.size());
+  GpgData data_out(*temp_data_out);
 
-  GpgData data_in(in_buffer.data(), in_buffer.size()), data_out;
+  auto err = DecryptVerify(data_in, data_out, decrypt_result, verify_result);
 
-  err = check_gpg_error(gpgme_op_decrypt_verify(ctx_, data_in, data_out));
-
-  auto temp_data_out = data_out.Read2Buffer();
   std::swap(temp_data_out, out_buffer);
 
+  return err;
+}
+
+gpgme_error_t GpgFrontend::GpgBasicOperator::DecryptVerify(
+    GpgData& data_in, GpgData& data_out, GpgDecrResult& decrypt_result,
+    GpgVerifyResult& verify_result) {
+  gpgme_error_t err =
+      check_gpg_error(gpgme_op_decrypt_verify(ctx_, data_in, data_out));
+
   auto temp_decr_result = _new_result(gpgme_op_decrypt_result(ctx_));
   std::swap(decrypt_result, temp_decr_result);
 
@@ -145,6 +199,22 @@ gpgme_error_t GpgFrontend::GpgBasicOperator::EncryptSign(
     KeyListPtr keys, KeyListPtr signers, BypeArrayRef in_buffer,
     ByteArrayPtr& out_buffer, GpgEncrResult& encr_result,
     GpgSignResult& sign_result) {
+  GpgData data_in(in_buffer.data(), in_buffer.size(), false);
+  auto temp_data_out = std::make_unique<std::string>();
+  temp_data_out->reserve(in_buffer.size());
+  GpgData data_out(*temp_data_out);
+
+  auto err = EncryptSign(std::move(keys), std::move(signers), data_in,
+                         data_out, encr_result, sign_result);
+
+  std::swap(temp_data_out, out_buffer);
+
+  return err;
+}
+
+gpgme_error_t GpgFrontend::GpgBasicOperator::EncryptSign(
+    KeyListPtr keys, KeyListPtr signers, GpgData& data_in, GpgData& data_out,
+    GpgEncrResult& encr_result, GpgSignResult& sign_result) {
   gpgme_error_t err;
   SetSigners(*signers);
 
@@ -158,15 +228,9 @@ gpgme_error_t GpgFrontend::GpgBasicOperator::EncryptSign(
   // Last entry dataIn array has to be nullptr
   recipients[keys->size()] = nullptr;
 
-  GpgData data_in(in_buffer.data(), in_buffer.size()), data_out;
-
-  // If the last parameter isnt 0, a private copy of data is made
   err = check_gpg_error(gpgme_op_encrypt_sign(
       ctx_, recipients, GPGME_ENCRYPT_ALWAYS_TRUST, data_in, data_out));
 
-  auto temp_data_out = data_out.Read2Buffer();
-  std::swap(temp_data_out, out_buffer);
-
   auto temp_encr_result = _new_result(gpgme_op_encrypt_result(ctx_));
   swap(encr_result, temp_encr_result);
   auto temp_sign_result = _new_result(gpgme_op_sign_result(ctx_));
@@ -203,15 +267,23 @@ GpgFrontend::GpgBasicOperator::GetSigners() {
 gpg_error_t GpgFrontend::GpgBasicOperator::EncryptSymmetric(
     GpgFrontend::ByteArray& in_buffer, GpgFrontend::ByteArrayPtr& out_buffer,
     GpgFrontend::GpgEncrResult& result) {
-  // deepcopy from ByteArray to GpgData
-  GpgData data_in(in_buffer.data(), in_buffer.size()), data_out;
+  GpgData data_in(in_buffer.data(), in_buffer.size(), false);
+  auto temp_data_out = std::make_unique<std::string>();
+  temp_data_out->reserve(in_buffer.size());
+  GpgData data_out(*temp_data_out);
 
-  gpgme_error_t err = check_gpg_error(gpgme_op_encrypt(
-      ctx_, nullptr, GPGME_ENCRYPT_SYMMETRIC, data_in, data_out));
+  auto err = EncryptSymmetric(data_in, data_out, result);
 
-  auto temp_data_out = data_out.Read2Buffer();
   std::swap(temp_data_out, out_buffer);
 
+  return err;
+}
+
+gpg_error_t GpgFrontend::GpgBasicOperator::EncryptSymmetric(
+    GpgData& data_in, GpgData& data_out, GpgEncrResult& result) {
+  gpgme_error_t err = check_gpg_error(gpgme_op_encrypt(
+      ctx_, nullptr, GPGME_ENCRYPT_SYMMETRIC, data_in, data_out));
+
   // TODO(Saturneric): maybe a bug of gpgme
   if (gpgme_err_code(err) == GPG_ERR_NO_ERROR) {
     auto temp_result = _new_result(gpgme_op_encrypt_result(ctx_));
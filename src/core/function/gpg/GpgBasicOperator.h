@@ -155,6 +155,114 @@ class GPGFRONTEND_CORE_EXPORT GpgBasicOperator
                    ByteArrayPtr& out_buffer, gpgme_sig_mode_t mode,
                    GpgSignResult& result);
 
+  /**
+   * @brief Call the interface provided by gpgme for encryption operation
+   * The data objects can be backed by memory, files or callbacks, so that
+   * large inputs can be streamed without being loaded into memory.
+   *
+   * @param keys list of public keys
+   * @param data_in data that needs to be encrypted
+   * @param data_out where the encrypted data is written to
+   * @param result the result of the operation
+   * @return error code
+   */
+  gpg_error_t Encrypt(KeyListPtr keys, GpgData& data_in, GpgData& data_out,
+                      GpgEncrResult& result);
+
+  /**
+   * @brief Call the interface provided by GPGME to symmetrical encryption
+   *
+   * @param data_in Data for encryption
+   * @param data_out where the encrypted data is written to
+   * @param result Encrypted results
+   * @return gpg_error_t
+   */
+  gpg_error_t EncryptSymmetric(GpgData& data_in, GpgData& data_out,
+                               GpgEncrResult& result);
+
+  /**
+   * @brief Call the interface provided by gpgme to perform encryption and
+   * signature operations at the same time.
+   *
+   * @param keys List of public keys
+   * @param signers Private key for signatures
+   * @param data_in Data for operation
+   * @param data_out where the encrypted data is written to
+   * @param encr_result Encrypted results
+   * @param sign_result Signature result
+   * @return gpgme_error_t
+   */
+  gpgme_error_t EncryptSign(KeyListPtr keys, KeyListPtr signers,
+                            GpgData& data_in, GpgData& data_out,
+                            GpgEncrResult& encr_result,
+                            GpgSignResult& sign_result);
+
+  /**
+   * @brief Call the interface provided by gpgme for decryption operation
+   *
+   * @param data_in data that needs to be decrypted
+   * @param data_out where the decrypted data is written to
+   * @param result the result of the operation
+   * @return error code
+   */
+  gpgme_error_t Decrypt(GpgData& data_in, GpgData& data_out,
+                        GpgDecrResult& result);
+
+  /**
+   * @brief Call the interface provided by gpgme to perform decryption and
+   * verification operations at the same time.
+   *
+   * @param data_in data to be manipulated
+   * @param data_out where the decrypted data is written to
+   * @param decrypt_result the result of the decrypting operation
+   * @param verify_result the result of the verifying operation
+   * @return error code
+   */
+  gpgme_error_t DecryptVerify(GpgData& data_in, GpgData& data_out,
+                              GpgDecrResult& decrypt_result,
+                              GpgVerifyResult& verify_result);
+
+  /**
+   * @brief Call the interface provided by gpgme for verification operation
+   * If sig_data is nullptr, data_in is treated as a normal or clear text
+   * signature and the signed plaintext is written to data_out.
+   *
+   * @param data_in data that needs to be verified
+   * @param sig_data detached signature, can be nullptr
+   * @param data_out where the signed plaintext is written to
+   * @param result the result of the operation
+   * @return error code
+   */
+  gpgme_error_t Verify(GpgData& data_in, GpgData* sig_data, GpgData& data_out,
+                       GpgVerifyResult& result) const;
+
+  /**
+   * @brief Call the interface provided by gpgme for signing operation
+   *
+   * @param signers private keys for signing operations
+   * @param data_in data that needs to be signed
+   * @param data_out where the signature is written to
+   * @param mode signing mode
+   * @param result the result of the operation
+   * @return error code
+   */
+  gpg_error_t Sign(KeyListPtr signers, GpgData& data_in, GpgData& data_out,
+                   gpgme_sig_mode_t mode, GpgSignResult& result);
+
+  /**
+   * @brief Call the interface provided by gpgme for signing operation with
+   * the signers already set by SetSigners(), useful when many inputs are
+   * signed by the same keys
+   *
+   * @param data_in data that needs to be signed
+   * @param data_out where the signature is written to
+   * @param mode signing mode
+   * @param result the result of the operation
+   * @return error code
+   */
+  gpg_error_t Sign(GpgData& data_in, GpgData& data_out, gpgme_sig_mode_t mode,
+                   GpgSignResult& result);
+
   /**
    * @brief  Set the private key for signatures, this operation is a global
    * operation.
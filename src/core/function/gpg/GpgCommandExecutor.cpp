@@ -30,6 +30,26 @@
 #include "GpgFunctionObject.h"
 #include "core/thread/TaskRunnerGetter.h"
 
+namespace {
+
+/// the callback waiting for the result, appended first by the caller
+using ProcessCallback = GpgFrontend::Thread::Task::DataObject::Layout<
+    std::function<void(int, std::string, std::string)>>;
+
+/// the command to run, popped by the process runner
+using ProcessArguments = GpgFrontend::Thread::Task::DataObject::Layout<
+    std::string, std::vector<std::string>, std::function<void(QProcess *)>>;
+
+/// exit code, stdout and stderr, appended by the process runner
+using ProcessResult =
+    GpgFrontend::Thread::Task::DataObject::Layout<int, std::string,
+                                                  std::string>;
+
+/// how often a long running command checks for the cancellation of its task
+constexpr int kLongRunningPollInterval = 100;
+
+}  // namespace
+
 GpgFrontend::GpgCommandExecutor::GpgCommandExecutor(int channel)
     : SingletonFunctionObject<GpgCommandExecutor>(channel) {}
 
@@ -42,14 +62,12 @@ void GpgFrontend::GpgCommandExecutor::Execute(
   Thread::Task::TaskCallback result_callback =
       [](int rtn, Thread::Task::DataObjectPtr data_object) {
         SPDLOG_DEBUG("data object use count: {}", data_object.use_count());
-        if (data_object->GetObjectSize() != 4)
+        if (data_object->GetObjectSize() != 2)
           throw std::runtime_error("invalid data object size");
 
-        auto exit_code = data_object->PopObject<int>();
-        auto process_stdout = data_object->PopObject<std::string>();
-        auto process_stderr = data_object->PopObject<std::string>();
-        auto callback = data_object->PopObject<
-            std::function<void(int, std::string, std::string)>>();
+        auto [exit_code, process_stdout, process_stderr] =
+            ProcessResult::Pop(*data_object);
+        auto [callback] = ProcessCallback::Pop(*data_object);
 
         // call callback
         callback(exit_code, process_stdout, process_stderr);
@@ -60,15 +78,16 @@ void GpgFrontend::GpgCommandExecutor::Execute(
     SPDLOG_DEBUG("process runner called, data object size: {}",
                  data_object->GetObjectSize());
 
-    if (data_object->GetObjectSize() != 4)
+    if (data_object->GetObjectSize() != 2)
       throw std::runtime_error("invalid data object size");
 
     // get arguments
-    auto cmd = data_object->PopObject<std::string>();
+    std::string cmd;
+    std::vector<std::string> arguments;
+    std::function<void(QProcess *)> interact_func;
+    std::tie(cmd, arguments, interact_func) =
+        ProcessArguments::Pop(*data_object);
     SPDLOG_DEBUG("get cmd: {}", cmd);
-    auto arguments = data_object->PopObject<std::vector<std::string>>();
-    auto interact_func =
-        data_object->PopObject<std::function<void(QProcess *)>>();
 
     auto *cmd_process = new QProcess();
     cmd_process->setProcessChannelMode(QProcess::MergedChannels);
@@ -122,9 +141,8 @@ void GpgFrontend::GpgCommandExecutor::Execute(
 
     // transfer result
     SPDLOG_DEBUG("runner append object");
-    data_object->AppendObject(std::move(process_stderr));
-    data_object->AppendObject(std::move(process_stdout));
-    data_object->AppendObject(std::move(exit_code));
+    ProcessResult::Append(*data_object, exit_code, std::move(process_stdout),
+                          std::move(process_stderr));
     SPDLOG_DEBUG("runner append object done");
 
     return 0;
@@ -133,10 +151,9 @@ void GpgFrontend::GpgCommandExecutor::Execute(
   // data transfer into task
   auto data_object = std::make_shared<Thread::Task::DataObject>();
   SPDLOG_DEBUG("executor append object");
-  data_object->AppendObject(std::move(callback));
-  data_object->AppendObject(std::move(interact_func));
-  data_object->AppendObject(std::move(arguments));
-  data_object->AppendObject(std::move(std::string{cmd}));
+  ProcessCallback::Append(*data_object, std::move(callback));
+  ProcessArguments::Append(*data_object, cmd, std::move(arguments),
+                           std::move(interact_func));
   SPDLOG_DEBUG("executor append object done");
 
   auto *process_task = new GpgFrontend::Thread::Task(
@@ -156,6 +173,59 @@ void GpgFrontend::GpgCommandExecutor::Execute(
   looper.exec();
 }
 
+void GpgFrontend::GpgCommandExecutor::ExecuteLongRunning(
+    std::string cmd, std::vector<std::string> arguments,
+    std::function<void(int, std::string, std::string)> callback,
+    std::function<void(const std::string &)> line_func) {
+  SPDLOG_DEBUG("called cmd {} arguments size: {}", cmd, arguments.size());
+
+  QStringList q_arguments;
+  for (const auto &argument : arguments)
+    q_arguments.append(QString::fromStdString(argument));
+
+  // runs on the calling thread, so that it is the one killing the process
+  QProcess cmd_process;
+  cmd_process.setProgram(QString::fromStdString(cmd));
+  cmd_process.setArguments(q_arguments);
+  cmd_process.start();
+
+  auto *task = Thread::Task::GetCurrentTask();
+  std::string process_stdout;
+  auto read_lines = [&]() {
+    while (cmd_process.canReadLine()) {
+      auto line = cmd_process.readLine().toStdString();
+      process_stdout += line;
+      line_func(line);
+    }
+  };
+
+  bool killed = false;
+  while (!cmd_process.waitForFinished(kLongRunningPollInterval)) {
+    // not started at all
+    if (cmd_process.state() == QProcess::NotRunning) break;
+
+    read_lines();
+    if (!killed && task != nullptr && task->IsCancelled()) {
+      SPDLOG_DEBUG("task cancelled, killing command: {}", cmd);
+      cmd_process.kill();
+      killed = true;
+    }
+  }
+  read_lines();
+  process_stdout += cmd_process.readAllStandardOutput().toStdString();
+
+  int exit_code = cmd_process.exitCode();
+  if (cmd_process.error() == QProcess::FailedToStart ||
+      cmd_process.exitStatus() != QProcess::NormalExit) {
+    SPDLOG_ERROR("error in executing command: {} error: {}", cmd,
+                 cmd_process.error());
+    exit_code = -1;
+  }
+
+  callback(exit_code, std::move(process_stdout),
+           cmd_process.readAllStandardError().toStdString());
+}
+
 void GpgFrontend::GpgCommandExecutor::ExecuteConcurrently(
     std::string cmd, std::vector<std::string> arguments,
     std::function<void(int, std::string, std::string)> callback,
@@ -164,14 +234,12 @@ void GpgFrontend::GpgCommandExecutor::ExecuteConcurrently(
 
   Thread::Task::TaskCallback result_callback =
       [](int rtn, Thread::Task::DataObjectPtr data_object) {
-        if (data_object->GetObjectSize() != 4)
+        if (data_object->GetObjectSize() != 2)
           throw std::runtime_error("invalid data object size");
 
-        auto exit_code = data_object->PopObject<int>();
-        auto process_stdout = data_object->PopObject<std::string>();
-        auto process_stderr = data_object->PopObject<std::string>();
-        auto callback = data_object->PopObject<
-            std::function<void(int, std::string, std::string)>>();
+        auto [exit_code, process_stdout, process_stderr] =
+            ProcessResult::Pop(*data_object);
+        auto [callback] = ProcessCallback::Pop(*data_object);
 
         // call callback
         callback(exit_code, process_stdout, process_stderr);
@@ -182,15 +250,16 @@ void GpgFrontend::GpgCommandExecutor::ExecuteConcurrently(
     SPDLOG_DEBUG("process runner called, data object size: {}",
                  data_object->GetObjectSize());
 
-    if (data_object->GetObjectSize() != 4)
+    if (data_object->GetObjectSize() != 2)
       throw std::runtime_error("invalid data object size");
 
     SPDLOG_DEBUG("runner pop object");
     // get arguments
-    auto cmd = data_object->PopObject<std::string>();
-    auto arguments = data_object->PopObject<std::vector<std::string>>();
-    auto interact_func =
-        data_object->PopObject<std::function<void(QProcess *)>>();
+    std::string cmd;
+    std::vector<std::string> arguments;
+    std::function<void(QProcess *)> interact_func;
+    std::tie(cmd, arguments, interact_func) =
+        ProcessArguments::Pop(*data_object);
     SPDLOG_DEBUG("runner pop object done");
 
     auto *cmd_process = new QProcess();
@@ -246,9 +315,8 @@ void GpgFrontend::GpgCommandExecutor::ExecuteConcurrently(
 
     // transfer result
     SPDLOG_DEBUG("runner append object");
-    data_object->AppendObject(std::move(process_stderr));
-    data_object->AppendObject(std::move(process_stdout));
-    data_object->AppendObject(std::move(exit_code));
+    ProcessResult::Append(*data_object, exit_code, std::move(process_stdout),
+                          std::move(process_stderr));
     SPDLOG_DEBUG("runner append object done");
 
     return 0;
@@ -256,10 +324,9 @@ void GpgFrontend::GpgCommandExecutor::ExecuteConcurrently(
 
   // data transfer into task
   auto data_object = std::make_shared<Thread::Task::DataObject>();
-  data_object->AppendObject(std::move(callback));
-  data_object->AppendObject(std::move(interact_func));
-  data_object->AppendObject(std::move(arguments));
-  data_object->AppendObject(std::move(std::string{cmd}));
+  ProcessCallback::Append(*data_object, std::move(callback));
+  ProcessArguments::Append(*data_object, cmd, std::move(arguments),
+                           std::move(interact_func));
 
   auto *process_task = new GpgFrontend::Thread::Task(
       std::move(runner), fmt::format("ExecuteConcurrently/{}", cmd),
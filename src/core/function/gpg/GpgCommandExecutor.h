@@ -66,6 +66,24 @@ class GPGFRONTEND_CORE_EXPORT GpgCommandExecutor
           [](int, std::string, std::string) {},
       std::function<void(QProcess *)> interact_func = [](QProcess *) {});
 
+  /**
+   * @brief Executing a command that may run for a long time, without the
+   * timeout of Execute. It runs on the calling thread and is killed once the
+   * task running on this thread is cancelled.
+   *
+   * @param cmd command
+   * @param arguments Command parameters
+   * @param callback called with the exit code (-1 if the command did not
+   * finish normally), stdout and stderr
+   * @param line_func called with every line written to stdout, as soon as
+   * it arrives
+   */
+  void ExecuteLongRunning(
+      std::string cmd, std::vector<std::string> arguments,
+      std::function<void(int, std::string, std::string)> callback,
+      std::function<void(const std::string &)> line_func =
+          [](const std::string &) {});
+
   void ExecuteConcurrently(
       std::string cmd, std::vector<std::string> arguments,
       std::function<void(int, std::string, std::string)> callback,
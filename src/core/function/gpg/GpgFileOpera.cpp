@@ -27,12 +27,703 @@
  */
 #include "GpgFileOpera.h"
 
+#include <algorithm>
+#include <atomic>
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "GpgBasicOperator.h"
+#include "GpgCommandExecutor.h"
 #include "GpgConstants.h"
-#include "function/FileOperator.h"
+#include "GpgKeyGetter.h"
+#include "GpgStatusParser.h"
+#include "core/GpgContext.h"
+#include "core/GpgCoreInit.h"
+#include "core/function/ArchiveFileOperator.h"
+#include "core/function/GlobalSettingStation.h"
+#include "core/thread/Task.h"
+
+namespace {
+
+constexpr size_t kPipeSize = 1024 * 1024;  ///< bytes buffered between stages
+
+/**
+ * @brief remove the output file of a failed operation
+ *
+ * @param path output path
+ */
+void remove_output_file(const std::filesystem::path& path) {
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  if (ec) SPDLOG_WARN("cannot remove output file: {}", ec.message());
+}
+
+/**
+ * @brief throw if writing out_path would overwrite in_path, the output is
+ * truncated before anything of the input is read
+ *
+ * @param in_path input path
+ * @param out_path output path
+ */
+void check_distinct_paths(const std::filesystem::path& in_path,
+                          const std::filesystem::path& out_path) {
+  std::error_code ec;
+  // false with an error if out_path does not exist yet
+  if (std::filesystem::equivalent(in_path, out_path, ec))
+    throw std::runtime_error("input and output are the same file");
+}
+
+/**
+ * @brief progress of a batch, shared by its workers, which don't run the task
+ * themselves
+ *
+ */
+struct BatchProgress {
+  GpgFrontend::Thread::Task* task;     ///< task the batch runs in
+  uint64_t total;                      ///< bytes of all the inputs
+  std::atomic<uint64_t> processed{0};  ///< bytes read by all the workers
+};
+
+/**
+ * @brief progress of the batch the worker running on this thread belongs to
+ *
+ */
+thread_local BatchProgress* current_batch_progress = nullptr;
+
+/**
+ * @brief while alive, report the bytes gpgme reads from data_in to the task
+ * running on this thread and let the task cancel the gpg operation. On the
+ * worker of a batch, the bytes are added to the progress of the batch. Does
+ * nothing when the calling thread does not run a task.
+ */
+class TaskProgressHook {
+ public:
+  /**
+   * @brief Construct a new Task Progress Hook object
+   *
+   * @param channel channel of the context running the operation
+   * @param data_in input of the operation
+   * @param total size of the input, 0 to rely on the progress of gpgme
+   */
+  TaskProgressHook(int channel, GpgFrontend::GpgData& data_in, uint64_t total)
+      : task_(GpgFrontend::Thread::Task::GetCurrentTask()),
+        ctx_(GpgFrontend::GpgContext::GetInstance(channel)),
+        total_(total) {
+    if (task_ == nullptr && current_batch_progress != nullptr) {
+      // workers stop once the task is cancelled, the file being processed is
+      // aborted through its read callback
+      data_in.SetProgressFunc([batch = current_batch_progress,
+                               last = uint64_t{0}](uint64_t processed) mutable {
+        if (processed > last) {
+          batch->task->UpdateProgress(batch->processed += processed - last,
+                                      batch->total);
+          last = processed;
+        }
+        return !batch->task->IsCancelled();
+      });
+      return;
+    }
+    if (task_ == nullptr) return;
+
+    data_in.SetProgressFunc([this](uint64_t processed) {
+      if (total_ != 0) task_->UpdateProgress(processed, total_);
+      return !task_->IsCancelled();
+    });
+    gpgme_set_progress_cb(ctx_, progress_cb, this);
+    // gpgme_cancel() only works with an external event loop, the async
+    // variant is the one that may be called from another thread
+    task_->SetCancelHandler([ctx = ctx_]() { gpgme_cancel_async(ctx); });
+  }
+
+  ~TaskProgressHook() {
+    if (task_ == nullptr) return;
+    task_->SetCancelHandler(nullptr);
+    gpgme_set_progress_cb(ctx_, nullptr, nullptr);
+  }
+
+  TaskProgressHook(const TaskProgressHook&) = delete;
+  TaskProgressHook& operator=(const TaskProgressHook&) = delete;
+
+ private:
+  GpgFrontend::Thread::Task* task_;  ///< nullptr if there is no task
+  gpgme_ctx_t ctx_;                  ///<
+  uint64_t total_;                   ///<
+
+  static void progress_cb(void* opaque, const char* what, int type,
+                          int current, int total) {
+    auto* hook = static_cast<TaskProgressHook*>(opaque);
+    // the own byte count is more precise when the input size is known
+    if (hook->total_ != 0 || total <= 0) return;
+    hook->task_->UpdateProgress(current, total);
+  }
+};
+
+/**
+ * @brief joins a thread feeding or draining a data exchanger when it goes out
+ * of scope, also when the gpg operation throws. The exchanger is closed
+ * first, so the thread can't stay blocked on it.
+ *
+ */
+class ExchangerThreadJoiner {
+ public:
+  ExchangerThreadJoiner(std::thread& thread, std::function<void()> close)
+      : thread_(thread), close_(std::move(close)) {}
+
+  ~ExchangerThreadJoiner() {
+    close_();
+    if (thread_.joinable()) thread_.join();
+  }
+
+  ExchangerThreadJoiner(const ExchangerThreadJoiner&) = delete;
+  ExchangerThreadJoiner& operator=(const ExchangerThreadJoiner&) = delete;
+
+ private:
+  std::thread& thread_;          ///<
+  std::function<void()> close_;  ///<
+};
+
+/**
+ * @brief hidden directory inside the target directory an archive is
+ * extracted into, its entries are renamed into the target only after the
+ * archive is decrypted and authenticated. It is removed on any failure, so
+ * no unauthenticated plaintext is left on disk.
+ *
+ */
+class ArchiveStagingDirectory {
+ public:
+  explicit ArchiveStagingDirectory(const std::filesystem::path& out_dir)
+      : out_dir_(out_dir),
+        path_(out_dir /
+              (".gpgfrontend-partial-" +
+               boost::uuids::to_string(boost::uuids::random_generator()()))) {
+    std::filesystem::create_directories(path_);
+  }
+
+  ~ArchiveStagingDirectory() {
+    if (committed_) return;
+    std::error_code ec;
+    std::filesystem::remove_all(path_, ec);
+    if (ec) SPDLOG_WARN("cannot remove staging directory: {}", ec.message());
+  }
+
+  ArchiveStagingDirectory(const ArchiveStagingDirectory&) = delete;
+  ArchiveStagingDirectory& operator=(const ArchiveStagingDirectory&) = delete;
+
+  [[nodiscard]] const std::filesystem::path& GetPath() const { return path_; }
+
+  /**
+   * @brief move the extracted entries into the target directory
+   *
+   */
+  void Commit() {
+    move_entries(path_, out_dir_);
+    std::filesystem::remove(path_);
+    committed_ = true;
+  }
+
+ private:
+  std::filesystem::path out_dir_;  ///<
+  std::filesystem::path path_;     ///<
+  bool committed_ = false;         ///<
+
+  /**
+   * @brief move the entries of from into to, directories existing on both
+   * sides are merged and files are replaced
+   *
+   * @param from
+   * @param to
+   */
+  static void move_entries(const std::filesystem::path& from,
+                           const std::filesystem::path& to) {
+    std::filesystem::create_directories(to);
+    for (const auto& entry : std::filesystem::directory_iterator(from)) {
+      auto target = to / entry.path().filename();
+      // symlinks are never followed, neither in the archive nor in the target
+      if (std::filesystem::is_directory(entry.symlink_status()) &&
+          std::filesystem::is_directory(
+              std::filesystem::symlink_status(target))) {
+        move_entries(entry.path(), target);
+        std::filesystem::remove(entry.path());
+      } else {
+        std::filesystem::rename(entry.path(), target);
+      }
+    }
+  }
+};
+
+/**
+ * @brief true if a signature of the result doesn't match the data
+ *
+ * @param result verify result
+ * @return bool
+ */
+bool has_bad_signature(const GpgFrontend::GpgVerifyResult& result) {
+  if (result == nullptr) return false;
+  for (auto* sign = result->signatures; sign != nullptr; sign = sign->next) {
+    if (gpg_err_code(sign->status) == GPG_ERR_BAD_SIGNATURE) return true;
+  }
+  return false;
+}
+
+/**
+ * @brief size of a file, 0 if unknown
+ *
+ * @param path path of the file
+ * @return uint64_t
+ */
+uint64_t size_of_file(const std::filesystem::path& path) {
+  std::error_code ec;
+  auto size = std::filesystem::file_size(path, ec);
+  return ec ? 0 : size;
+}
+
+/**
+ * @brief sum of the sizes of the regular files in a directory
+ *
+ * @param dir path of the directory
+ * @return uint64_t
+ */
+uint64_t size_of_directory(const std::filesystem::path& dir) {
+  uint64_t size = 0;
+  std::error_code ec;
+  for (std::filesystem::recursive_directory_iterator
+           it(dir, std::filesystem::directory_options::skip_permission_denied,
+              ec),
+       end;
+       !ec && it != end; it.increment(ec)) {
+    if (it->is_regular_file(ec)) size += size_of_file(it->path());
+  }
+  return size;
+}
+
+/**
+ * @brief whether in_path is large enough to be handed to the gpg binary
+ * directly instead of going through gpgme, set by the
+ * advanced.gpg_process_threshold_mb setting, 0 (the default) disables it
+ *
+ * @param channel channel of the context running the operation
+ * @param in_path input path
+ * @return true if the gpg process should be used
+ */
+bool use_gpg_process(int channel, const std::filesystem::path& in_path) {
+  auto threshold_mb =
+      GpgFrontend::GlobalSettingStation::GetInstance().LookupSettings(
+          "advanced.gpg_process_threshold_mb", 0);
+  if (threshold_mb <= 0) return false;
+  if (GpgFrontend::GpgContext::GetInstance(channel).GetInfo().AppPath.empty())
+    return false;
+  return size_of_file(in_path) >=
+         static_cast<uint64_t>(threshold_mb) * 1024 * 1024;
+}
+
+/**
+ * @brief run the gpg binary of a context on files, with the status lines
+ * written to stdout. The progress it reports is passed to the task running on
+ * this thread, which kills the process when cancelled.
+ *
+ * @param channel channel of the context
+ * @param arguments arguments of the operation
+ * @param total size of the input, used when gpg doesn't report one
+ * @param output output of the process
+ * @return int exit code
+ */
+int run_gpg_process(int channel, const std::vector<std::string>& arguments,
+                    uint64_t total, std::string& output) {
+  auto& ctx = GpgFrontend::GpgContext::GetInstance(channel);
+
+  std::vector<std::string> full_arguments = {
+      "--batch", "--yes", "--no-tty", "--status-fd", "1",
+      "--enable-progress-filter"};
+  if (ctx.GetInfo().DatabasePath != "default") {
+    full_arguments.emplace_back("--homedir");
+    full_arguments.push_back(ctx.GetInfo().DatabasePath);
+  }
+  full_arguments.insert(full_arguments.end(), arguments.begin(),
+                        arguments.end());
+
+  auto* task = GpgFrontend::Thread::Task::GetCurrentTask();
+  int exit_code = -1;
+  GpgFrontend::GpgCommandExecutor::GetInstance(channel).ExecuteLongRunning(
+      ctx.GetInfo().AppPath, full_arguments,
+      [&](int p_exit_code, const std::string& p_out, const std::string&) {
+        exit_code = p_exit_code;
+        output = p_out;
+      },
+      [&](const std::string& line) {
+        uint64_t current = 0, line_total = 0;
+        if (task == nullptr || !GpgFrontend::GpgStatusParser::ParseProgress(
+                                   line, current, line_total))
+          return;
+        if (line_total == 0) line_total = total;
+        if (line_total != 0) task->UpdateProgress(current, line_total);
+      });
+  return exit_code;
+}
+
+/**
+ * @brief the error of a gpg process, GPG_ERR_CANCELED if the task running on
+ * this thread was cancelled and so the process killed
+ *
+ * @param err error reported by the process
+ * @return GpgFrontend::GpgError
+ */
+GpgFrontend::GpgError gpg_process_error(GpgFrontend::GpgError err) {
+  auto* task = GpgFrontend::Thread::Task::GetCurrentTask();
+  if (err != GPG_ERR_NO_ERROR && task != nullptr && task->IsCancelled())
+    return gpg_error(GPG_ERR_CANCELED);
+  return err;
+}
+
+/**
+ * @brief stream in_path through a gpg operation into out_path, the output
+ * file is removed if the operation fails
+ *
+ * @param channel channel of the context running the operation
+ * @param in_path input path
+ * @param out_path output path
+ * @param opera operation on the input and output data
+ * @return GpgFrontend::GpgError
+ */
+template <typename Opera>
+GpgFrontend::GpgError run_file_opera(int channel,
+                                     const std::filesystem::path& in_path,
+                                     const std::filesystem::path& out_path,
+                                     Opera&& opera) {
+  check_distinct_paths(in_path, out_path);
+
+  GpgFrontend::GpgError err;
+  {
+    GpgFrontend::GpgData data_in(in_path, false);
+    if (!data_in.IsGood()) throw std::runtime_error("read file error");
+    GpgFrontend::GpgData data_out(out_path, true);
+    if (!data_out.IsGood()) throw std::runtime_error("write file error");
+
+    TaskProgressHook hook(channel, data_in, size_of_file(in_path));
+
+    err = opera(data_in, data_out);
+    // a truncated output must not be reported as a success
+    if (!data_out.CloseFile() &&
+        GpgFrontend::check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
+      err = gpg_error(GPG_ERR_EIO);
+  }
+
+  // don't leave a partial output behind
+  if (GpgFrontend::check_gpg_error_2_err_code(err) != GPG_ERR_NO_ERROR)
+    remove_output_file(out_path);
+
+  return err;
+}
+
+/**
+ * @brief archive in_dir on a producer thread and stream it through a gpg
+ * operation into out_path, the output file is removed if anything fails
+ *
+ * @param channel channel of the context running the operation
+ * @param in_dir directory to archive
+ * @param out_path output path
+ * @param opera operation on the archive data and the output data
+ * @return GpgFrontend::GpgError
+ */
+template <typename Opera>
+GpgFrontend::GpgError run_directory_opera(int channel,
+                                          const std::filesystem::path& in_dir,
+                                          const std::filesystem::path& out_path,
+                                          Opera&& opera) {
+  auto exchanger = std::make_shared<GpgFrontend::DataExchanger>(kPipeSize);
+
+  GpgFrontend::GpgError err;
+  bool archive_error = false;
+  {
+    GpgFrontend::GpgData data_out(out_path, true);
+    if (!data_out.IsGood()) throw std::runtime_error("write file error");
+
+    GpgFrontend::GpgData data_in(
+        [exchanger](void* buffer, size_t size) -> gpgme_ssize_t {
+          return exchanger->Read(static_cast<char*>(buffer), size);
+        },
+        nullptr);
+
+    // the archive headers are not counted, close enough for a progress bar
+    TaskProgressHook hook(channel, data_in, size_of_directory(in_dir));
+
+    std::thread producer([&]() {
+      try {
+        GpgFrontend::ArchiveFileOperator::NewArchive2DataExchanger(in_dir,
+                                                                   exchanger);
+      } catch (const std::exception& e) {
+        SPDLOG_ERROR("archive directory error: {}", e.what());
+        archive_error = true;
+      }
+    });
+    {
+      // unblock the producer if gpgme stopped reading early
+      ExchangerThreadJoiner joiner(producer,
+                                   [exchanger]() { exchanger->CloseRead(); });
+      err = opera(data_in, data_out);
+    }
+
+    // a truncated output must not be reported as a success
+    if (!data_out.CloseFile() &&
+        GpgFrontend::check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
+      err = gpg_error(GPG_ERR_EIO);
+  }
+
+  if (archive_error ||
+      GpgFrontend::check_gpg_error_2_err_code(err) != GPG_ERR_NO_ERROR)
+    remove_output_file(out_path);
+
+  if (archive_error) throw std::runtime_error("archive directory error");
+  return err;
+}
+
+/**
+ * @brief stream in_path through a gpg operation into an archive extractor
+ * running on a consumer thread
+ *
+ * @param channel channel of the context running the operation
+ * @param in_path input path
+ * @param out_dir directory the archive is extracted into
+ * @param opera operation on the input data and the archive data
+ * @return GpgFrontend::GpgError
+ */
+template <typename Opera>
+GpgFrontend::GpgError run_archive_opera(int channel,
+                                        const std::filesystem::path& in_path,
+                                        const std::filesystem::path& out_dir,
+                                        Opera&& opera) {
+  auto exchanger = std::make_shared<GpgFrontend::DataExchanger>(kPipeSize);
+  ArchiveStagingDirectory staging(out_dir);
+
+  GpgFrontend::GpgError err;
+  bool archive_error = false;
+  {
+    GpgFrontend::GpgData data_in(in_path, false);
+    if (!data_in.IsGood()) throw std::runtime_error("read file error");
+
+    GpgFrontend::GpgData data_out(
+        nullptr, [exchanger](const void* buffer, size_t size) -> gpgme_ssize_t {
+          auto ret = exchanger->Write(static_cast<const char*>(buffer), size);
+          // the extractor gave up
+          if (ret < 0) errno = EPIPE;
+          return ret;
+        });
+
+    TaskProgressHook hook(channel, data_in, size_of_file(in_path));
+
+    std::thread consumer([&]() {
+      try {
+        GpgFrontend::ArchiveFileOperator::ExtractArchiveFromDataExchanger(
+            exchanger, staging.GetPath());
+      } catch (const std::exception& e) {
+        SPDLOG_ERROR("extract archive error: {}", e.what());
+        archive_error = true;
+      }
+    });
+    // end of the archive data
+    ExchangerThreadJoiner joiner(consumer, [&]() { exchanger->CloseWrite(); });
+
+    err = opera(data_in, data_out);
+  }
+
+  // the extractor also fails when gpgme stops early, the gpgme result tells
+  // the user why
+  if (GpgFrontend::check_gpg_error_2_err_code(err) != GPG_ERR_NO_ERROR)
+    return err;
+  if (archive_error) throw std::runtime_error("extract archive error");
+
+  staging.Commit();
+  return err;
+}
+
+/**
+ * @brief convert a utf-8 path to std::filesystem::path
+ *
+ * @param path utf-8 path
+ * @return std::filesystem::path
+ */
+std::filesystem::path to_path(const std::string& path) {
+#ifdef WINDOWS
+  return std::filesystem::path(QString::fromStdString(path).toStdU16String());
+#else
+  return std::filesystem::path(path);
+#endif
+}
+
+/**
+ * @brief sum of the sizes of the inputs of a batch
+ *
+ * @param paths paths of the batch
+ * @return uint64_t
+ */
+uint64_t size_of_batch(const std::vector<GpgFrontend::FilePathPair>& paths) {
+  uint64_t total = 0;
+  for (const auto& path : paths) total += size_of_file(to_path(path.first));
+  return total;
+}
+
+/**
+ * @brief worker channels leased by a batch, given back when it is destroyed
+ *
+ */
+class WorkerChannelLease {
+ public:
+  WorkerChannelLease(int base_channel, int count)
+      : channels_(GpgFrontend::LeaseWorkerChannels(base_channel, count)) {}
+
+  ~WorkerChannelLease() { GpgFrontend::ReleaseWorkerChannels(channels_); }
+
+  WorkerChannelLease(const WorkerChannelLease&) = delete;
+  WorkerChannelLease& operator=(const WorkerChannelLease&) = delete;
+
+  [[nodiscard]] const std::vector<int>& GetChannels() const {
+    return channels_;
+  }
+
+ private:
+  std::vector<int> channels_;  ///<
+};
+
+/**
+ * @brief run opera(channel, index) for every index in [0, count) on parallel
+ * workers, every worker is bound to a gpg context leased for this batch only
+ * and calls setup(channel) once before taking any work. The workers stop
+ * taking work once the task running on the calling thread is cancelled.
+ *
+ * @param base_channel channel whose settings are used by the workers
+ * @param count number of work items
+ * @param total bytes read by all the items, the progress of the task
+ * @param workers requested number of workers, 0 means one per cpu core
+ * @param setup per worker setup
+ * @param opera work on one item, must not throw
+ * @return int number of workers actually used, 0 if no worker context could
+ * be created
+ */
+template <typename Setup, typename Opera>
+int run_in_workers(int base_channel, size_t count, uint64_t total, int workers,
+                   Setup&& setup, Opera&& opera) {
+  if (workers <= 0)
+    workers = static_cast<int>(std::thread::hardware_concurrency());
+  workers = std::clamp(workers, 1,
+                       static_cast<int>(std::min<size_t>(
+                           std::max<size_t>(count, 1),
+                           GpgFrontend::GPGFRONTEND_MAX_WORKER_CHANNELS)));
+
+  // the base channel is not used, it may be driven by the gpg runner
+  WorkerChannelLease lease(base_channel, workers);
+  const auto& channels = lease.GetChannels();
+  if (channels.empty()) return 0;
+
+  auto* task = GpgFrontend::Thread::Task::GetCurrentTask();
+  BatchProgress progress{task, total};
+  // a key is asked once per batch, never across batches
+  GpgFrontend::GpgBatchPassphrases passphrases;
+  std::atomic<size_t> next_index{0};
+  auto worker = [&](int channel) {
+    if (task != nullptr) current_batch_progress = &progress;
+    auto& ctx = GpgFrontend::GpgContext::GetInstance(channel);
+    ctx.SetBatchPassphrases(&passphrases);
+    setup(channel);
+    for (size_t i; (i = next_index++) < count;) {
+      if (task != nullptr && task->IsCancelled()) break;
+      opera(channel, i);
+    }
+    // the channel goes back to the pool
+    ctx.SetBatchPassphrases(nullptr);
+  };
+
+  std::vector<std::thread> threads;
+  for (auto channel : channels) threads.emplace_back(worker, channel);
+  for (auto& thread : threads) thread.join();
+
+  return static_cast<int>(channels.size());
+}
+
+/**
+ * @brief run one file of a batch, record its time, size and outcome
+ *
+ * @param paths input and output path
+ * @param item item to fill
+ * @param opera operation on the file
+ */
+template <typename Result, typename Opera>
+void run_batch_item(const GpgFrontend::FilePathPair& paths,
+                    GpgFrontend::GpgFileOperaItem<Result>& item,
+                    Opera&& opera) {
+  auto begin = std::chrono::steady_clock::now();
+  item.in_path = paths.first;
+  item.out_path = paths.second;
+
+  auto in_path_std = to_path(paths.first);
+  std::error_code ec;
+  auto size = std::filesystem::file_size(in_path_std, ec);
+  if (!ec) item.bytes = size;
+
+  try {
+    item.error = opera(in_path_std, to_path(paths.second), item.result);
+  } catch (const std::exception& e) {
+    SPDLOG_ERROR("batch item {} failed: {}", paths.first, e.what());
+    item.error = gpg_error(GPG_ERR_EIO);
+  }
+
+  item.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - begin);
+}
+
+/**
+ * @brief sum up the items of a batch, the items left behind by a cancelled
+ * batch are marked as cancelled, all of them fail if there was no worker
+ *
+ * @param paths paths of the batch
+ * @param items items of the batch
+ * @param workers number of workers used, 0 if none could be created
+ * @param begin time the batch started
+ * @return GpgFrontend::GpgFileOperaStats
+ */
+template <typename Result>
+GpgFrontend::GpgFileOperaStats collect_batch_stats(
+    const std::vector<GpgFrontend::FilePathPair>& paths,
+    std::vector<GpgFrontend::GpgFileOperaItem<Result>>& items, int workers,
+    std::chrono::steady_clock::time_point begin) {
+  GpgFrontend::GpgFileOperaStats stats;
+  stats.total = items.size();
+  stats.workers = workers;
+  for (size_t i = 0; i < items.size(); i++) {
+    auto& item = items[i];
+    if (item.in_path.empty()) {
+      item.in_path = paths[i].first;
+      item.out_path = paths[i].second;
+      item.error = gpg_error(workers == 0 ? GPG_ERR_NOT_OPERATIONAL
+                                          : GPG_ERR_CANCELED);
+    }
+
+    stats.bytes += item.bytes;
+    if (GpgFrontend::check_gpg_error_2_err_code(item.error) !=
+        GPG_ERR_NO_ERROR)
+      stats.failed++;
+  }
+  stats.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - begin);
+
+  SPDLOG_DEBUG("batch done, files: {} failed: {} workers: {} {} bytes/s",
+               stats.total, stats.failed, stats.workers, stats.Throughput());
+  return stats;
+}
+
+}  // namespace
+
+double GpgFrontend::GpgFileOperaStats::Throughput() const {
+  if (elapsed.count() <= 0) return 0;
+  return static_cast<double>(bytes) * 1000 /
+         static_cast<double>(elapsed.count());
+}
 
 GpgFrontend::GpgFileOpera::GpgFileOpera(int channel)
     : SingletonFunctionObject<GpgFileOpera>(channel) {}
@@ -50,22 +741,37 @@ GpgFrontend::GpgError GpgFrontend::GpgFileOpera::EncryptFile(
   auto out_path_std = std::filesystem::path(out_path);
 #endif
 
-  std::string in_buffer;
-  if (!FileOperator::ReadFileStd(in_path_std, in_buffer)) {
-    throw std::runtime_error("read file error");
-  }
-
-  std::unique_ptr<std::string> out_buffer = nullptr;
+  // gpg runs with --yes and would truncate the input
+  check_distinct_paths(in_path_std, out_path_std);
+  if (use_gpg_process(_channel, in_path_std)) {
+    // same as GPGME_ENCRYPT_ALWAYS_TRUST
+    std::vector<std::string> arguments = {"--trust-model", "always"};
+    for (const auto& key : *keys) {
+      arguments.emplace_back("--recipient");
+      arguments.push_back(key.GetFingerprint());
+    }
+    if (GpgContext::GetInstance(_channel).GetInitArgs().ascii)
+      arguments.emplace_back("--armor");
+    arguments.insert(arguments.end(),
+                     {"--output", out_path, "--encrypt", in_path});
 
-  auto err = GpgBasicOperator::GetInstance(_channel).Encrypt(
-      std::move(keys), in_buffer, out_buffer, result);
+    std::string output;
+    auto exit_code = run_gpg_process(_channel, arguments,
+                                     size_of_file(in_path_std), output);
+    GpgStatusParser parser(output);
+    result = parser.GetEncrResult();
 
-  if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
-    if (!FileOperator::WriteFileStd(out_path_std, *out_buffer)) {
-      throw std::runtime_error("write_buffer_to_file error");
-    };
+    auto err = gpg_process_error(parser.GetEncrError(exit_code));
+    if (err != GPG_ERR_NO_ERROR) remove_output_file(out_path_std);
+    return err;
+  }
 
-  return err;
+  return run_file_opera(
+      _channel, in_path_std, out_path_std,
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance(_channel).Encrypt(
+            std::move(keys), data_in, data_out, result);
+      });
 }
 
 GpgFrontend::GpgError GpgFrontend::GpgFileOpera::DecryptFile(
@@ -81,23 +787,30 @@ GpgFrontend::GpgError GpgFrontend::GpgFileOpera::DecryptFile(
   auto out_path_std = std::filesystem::path(out_path);
 #endif
 
-  std::string in_buffer;
-  if (!FileOperator::ReadFileStd(in_path_std, in_buffer)) {
-    throw std::runtime_error("read file error");
-  }
-  std::unique_ptr<std::string> out_buffer;
-
-  auto err =
-      GpgBasicOperator::GetInstance().Decrypt(in_buffer, out_buffer, result);
+  // gpg runs with --yes and would truncate the input
+  check_distinct_paths(in_path_std, out_path_std);
+  // without pinentry, the passphrase must be asked by our own dialog
+  if (GpgContext::GetInstance().GetInitArgs().use_pinentry &&
+      use_gpg_process(GPGFRONTEND_DEFAULT_CHANNEL, in_path_std)) {
+    std::string output;
+    auto exit_code = run_gpg_process(
+        GPGFRONTEND_DEFAULT_CHANNEL,
+        {"--output", out_path, "--decrypt", in_path},
+        size_of_file(in_path_std), output);
+    GpgStatusParser parser(output);
+    result = parser.GetDecrResult();
 
-  assert(check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR);
-
-  if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
-    if (!FileOperator::WriteFileStd(out_path_std, *out_buffer)) {
-      throw std::runtime_error("write_buffer_to_file error");
-    };
+    auto err = gpg_process_error(parser.GetDecrError(exit_code));
+    if (err != GPG_ERR_NO_ERROR) remove_output_file(out_path_std);
+    return err;
+  }
 
-  return err;
+  return run_file_opera(
+      GPGFRONTEND_DEFAULT_CHANNEL, in_path_std, out_path_std,
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance().Decrypt(data_in, data_out,
+                                                       result);
+      });
 }
 
 gpgme_error_t GpgFrontend::GpgFileOpera::SignFile(KeyListPtr keys,
@@ -115,21 +828,13 @@ gpgme_error_t GpgFrontend::GpgFileOpera::SignFile(KeyListPtr keys,
   auto out_path_std = std::filesystem::path(out_path);
 #endif
 
-  std::string in_buffer;
-  if (!FileOperator::ReadFileStd(in_path_std, in_buffer)) {
-    throw std::runtime_error("read file error");
-  }
-  std::unique_ptr<std::string> out_buffer;
-
-  auto err = GpgBasicOperator::GetInstance(_channel).Sign(
-      std::move(keys), in_buffer, out_buffer, GPGME_SIG_MODE_DETACH, result);
-
-  if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
-    if (!FileOperator::WriteFileStd(out_path_std, *out_buffer)) {
-      throw std::runtime_error("write_buffer_to_file error");
-    };
-
-  return err;
+  return run_file_opera(
+      _channel, in_path_std, out_path_std,
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance(_channel).Sign(
+            std::move(keys), data_in, data_out, GPGME_SIG_MODE_DETACH,
+            result);
+      });
 }
 
 gpgme_error_t GpgFrontend::GpgFileOpera::VerifyFile(
@@ -145,21 +850,26 @@ gpgme_error_t GpgFrontend::GpgFileOpera::VerifyFile(
   auto sign_path_std = std::filesystem::path(sign_path);
 #endif
 
-  std::string in_buffer;
-  if (!FileOperator::ReadFileStd(data_path_std, in_buffer)) {
-    throw std::runtime_error("read file error");
-  }
-  std::unique_ptr<std::string> sign_buffer = nullptr;
-  if (!sign_path.empty()) {
-    std::string sign_buffer_str;
-    if (!FileOperator::ReadFileStd(sign_path_std, sign_buffer_str)) {
-      throw std::runtime_error("read file error");
-    }
-    sign_buffer = std::make_unique<std::string>(sign_buffer_str);
+  GpgData data_in(data_path_std, false);
+  if (!data_in.IsGood()) throw std::runtime_error("read file error");
+  TaskProgressHook hook(_channel, data_in, size_of_file(data_path_std));
+
+  // the signed plaintext of an opaque signature is not needed here
+  GpgData data_out([](void*, size_t) -> gpgme_ssize_t { return 0; },
+                   [](const void*, size_t size) -> gpgme_ssize_t {
+                     return static_cast<gpgme_ssize_t>(size);
+                   });
+
+  if (sign_path.empty()) {
+    return GpgBasicOperator::GetInstance(_channel).Verify(data_in, nullptr,
+                                                          data_out, result);
   }
-  auto err = GpgBasicOperator::GetInstance(_channel).Verify(
-      in_buffer, sign_buffer, result);
-  return err;
+
+  GpgData sig_data(sign_path_std, false);
+  if (!sig_data.IsGood()) throw std::runtime_error("read file error");
+
+  return GpgBasicOperator::GetInstance(_channel).Verify(data_in, &sig_data,
+                                                        data_out, result);
 }
 
 gpg_error_t GpgFrontend::GpgFileOpera::EncryptSignFile(
@@ -176,22 +886,13 @@ gpg_error_t GpgFrontend::GpgFileOpera::EncryptSignFile(
   auto out_path_std = std::filesystem::path(out_path);
 #endif
 
-  std::string in_buffer;
-  if (!FileOperator::ReadFileStd(in_path_std, in_buffer)) {
-    throw std::runtime_error("read file error");
-  }
-  std::unique_ptr<std::string> out_buffer = nullptr;
-
-  auto err = GpgBasicOperator::GetInstance(_channel).EncryptSign(
-      std::move(keys), std::move(signer_keys), in_buffer, out_buffer, encr_res,
-      sign_res);
-
-  if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
-    if (!FileOperator::WriteFileStd(out_path_std, *out_buffer)) {
-      throw std::runtime_error("write_buffer_to_file error");
-    };
-
-  return err;
+  return run_file_opera(
+      _channel, in_path_std, out_path_std,
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance(_channel).EncryptSign(
+            std::move(keys), std::move(signer_keys), data_in, data_out,
+            encr_res, sign_res);
+      });
 }
 
 gpg_error_t GpgFrontend::GpgFileOpera::DecryptVerifyFile(
@@ -207,22 +908,14 @@ gpg_error_t GpgFrontend::GpgFileOpera::DecryptVerifyFile(
   auto out_path_std = std::filesystem::path(out_path);
 #endif
 
-  std::string in_buffer;
-  if (!FileOperator::ReadFileStd(in_path_std, in_buffer)) {
-    throw std::runtime_error("read file error");
-  }
-
-  std::unique_ptr<std::string> out_buffer = nullptr;
-  auto err = GpgBasicOperator::GetInstance().DecryptVerify(
-      in_buffer, out_buffer, decr_res, verify_res);
-
-  if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
-    if (!FileOperator::WriteFileStd(out_path_std, *out_buffer)) {
-      throw std::runtime_error("write file error");
-    };
-
-  return err;
+  return run_file_opera(
+      GPGFRONTEND_DEFAULT_CHANNEL, in_path_std, out_path_std,
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance().DecryptVerify(
+            data_in, data_out, decr_res, verify_res);
+      });
 }
+
 unsigned int GpgFrontend::GpgFileOpera::EncryptFileSymmetric(
     const std::string& in_path, const std::string& out_path,
     GpgFrontend::GpgEncrResult& result, int _channel) {
@@ -236,19 +929,205 @@ unsigned int GpgFrontend::GpgFileOpera::EncryptFileSymmetric(
   auto out_path_std = std::filesystem::path(out_path);
 #endif
 
-  std::string in_buffer;
-  if (!FileOperator::ReadFileStd(in_path_std, in_buffer)) {
-    throw std::runtime_error("read file error");
+  return run_file_opera(
+      _channel, in_path_std, out_path_std,
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance(_channel).EncryptSymmetric(
+            data_in, data_out, result);
+      });
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgFileOpera::EncryptDirectory(
+    KeyListPtr keys, const std::string& in_path, const std::string& out_path,
+    GpgEncrResult& result, int _channel) {
+  return run_directory_opera(
+      _channel, to_path(in_path), to_path(out_path),
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance(_channel).Encrypt(
+            std::move(keys), data_in, data_out, result);
+      });
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgFileOpera::EncryptDirectorySymmetric(
+    const std::string& in_path, const std::string& out_path,
+    GpgEncrResult& result, int _channel) {
+  return run_directory_opera(
+      _channel, to_path(in_path), to_path(out_path),
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance(_channel).EncryptSymmetric(
+            data_in, data_out, result);
+      });
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgFileOpera::EncryptSignDirectory(
+    KeyListPtr keys, KeyListPtr signer_keys, const std::string& in_path,
+    const std::string& out_path, GpgEncrResult& encr_res,
+    GpgSignResult& sign_res, int _channel) {
+  return run_directory_opera(
+      _channel, to_path(in_path), to_path(out_path),
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance(_channel).EncryptSign(
+            std::move(keys), std::move(signer_keys), data_in, data_out,
+            encr_res, sign_res);
+      });
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgFileOpera::DecryptArchive(
+    const std::string& in_path, const std::string& out_path,
+    GpgDecrResult& result) {
+  return run_archive_opera(
+      GPGFRONTEND_DEFAULT_CHANNEL, to_path(in_path), to_path(out_path),
+      [&](GpgData& data_in, GpgData& data_out) {
+        return GpgBasicOperator::GetInstance().Decrypt(data_in, data_out,
+                                                       result);
+      });
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgFileOpera::DecryptVerifyArchive(
+    const std::string& in_path, const std::string& out_path,
+    GpgDecrResult& decr_res, GpgVerifyResult& verify_res) {
+  return run_archive_opera(
+      GPGFRONTEND_DEFAULT_CHANNEL, to_path(in_path), to_path(out_path),
+      [&](GpgData& data_in, GpgData& data_out) {
+        auto err = GpgBasicOperator::GetInstance().DecryptVerify(
+            data_in, data_out, decr_res, verify_res);
+        // a tampered archive is not extracted
+        if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR &&
+            has_bad_signature(verify_res))
+          err = gpg_error(GPG_ERR_BAD_SIGNATURE);
+        return err;
+      });
+}
+
+GpgFrontend::GpgFileOperaStats GpgFrontend::GpgFileOpera::EncryptFiles(
+    KeyListPtr keys, const std::vector<FilePathPair>& paths,
+    std::vector<GpgFileOperaItem<GpgEncrResult>>& items, int workers,
+    int _channel) {
+  auto begin = std::chrono::steady_clock::now();
+  items.clear();
+  items.resize(paths.size());
+
+  auto used_workers = run_in_workers(
+      _channel, paths.size(), size_of_batch(paths), workers, [](int) {},
+      [&](int channel, size_t index) {
+        run_batch_item(
+            paths[index], items[index],
+            [&](const std::filesystem::path& in_path_std,
+                const std::filesystem::path& out_path_std,
+                GpgEncrResult& result) {
+              // keys are reference counted, copies are cheap
+              auto keys_copy = GpgKeyGetter::GetInstance().GetKeysCopy(keys);
+              return run_file_opera(
+                  channel, in_path_std, out_path_std,
+                  [&](GpgData& data_in, GpgData& data_out) {
+                    return GpgBasicOperator::GetInstance(channel).Encrypt(
+                        std::move(keys_copy), data_in, data_out, result);
+                  });
+            });
+      });
+
+  return collect_batch_stats(paths, items, used_workers, begin);
+}
+
+GpgFrontend::GpgFileOperaStats GpgFrontend::GpgFileOpera::VerifyFiles(
+    const std::vector<FilePathPair>& paths,
+    std::vector<GpgFileOperaItem<GpgVerifyResult>>& items, int workers,
+    int _channel) {
+  auto begin = std::chrono::steady_clock::now();
+  items.clear();
+  items.resize(paths.size());
+
+  auto used_workers = run_in_workers(
+      _channel, paths.size(), size_of_batch(paths), workers, [](int) {},
+      [&](int channel, size_t index) {
+        run_batch_item(
+            paths[index], items[index],
+            [&](const std::filesystem::path& data_path_std,
+                const std::filesystem::path& sign_path_std,
+                GpgVerifyResult& result) {
+              GpgData data_in(data_path_std, false);
+              if (!data_in.IsGood())
+                throw std::runtime_error("read file error");
+              GpgData sig_data(sign_path_std, false);
+              if (!sig_data.IsGood())
+                throw std::runtime_error("read file error");
+              TaskProgressHook hook(channel, data_in,
+                                    size_of_file(data_path_std));
+
+              GpgData data_out;
+              return GpgBasicOperator::GetInstance(channel).Verify(
+                  data_in, &sig_data, data_out, result);
+            });
+      });
+
+  return collect_batch_stats(paths, items, used_workers, begin);
+}
+
+GpgFrontend::GpgFileOperaStats GpgFrontend::GpgFileOpera::SignFiles(
+    KeyListPtr keys, const std::vector<FilePathPair>& paths,
+    std::vector<GpgFileOperaItem<GpgSignResult>>& items, int workers,
+    int _channel) {
+  auto begin = std::chrono::steady_clock::now();
+  items.clear();
+  items.resize(paths.size());
+
+  const auto* sig_extension =
+      GpgContext::GetInstance(_channel).GetInitArgs().ascii ? ".asc" : ".sig";
+
+  auto used_workers = run_in_workers(
+      _channel, paths.size(), size_of_batch(paths), workers,
+      [&](int channel) {
+        // the context is leased to this batch, cleared when given back
+        GpgBasicOperator::GetInstance(channel).SetSigners(*keys);
+      },
+      [&](int channel, size_t index) {
+        auto in_out = paths[index];
+        if (in_out.second.empty()) in_out.second = in_out.first + sig_extension;
+
+        run_batch_item(
+            in_out, items[index],
+            [&](const std::filesystem::path& in_path_std,
+                const std::filesystem::path& out_path_std,
+                GpgSignResult& result) {
+              return run_file_opera(
+                  channel, in_path_std, out_path_std,
+                  [&](GpgData& data_in, GpgData& data_out) {
+                    return GpgBasicOperator::GetInstance(channel).Sign(
+                        data_in, data_out, GPGME_SIG_MODE_DETACH, result);
+                  });
+            });
+      });
+
+  return collect_batch_stats(paths, items, used_workers, begin);
+}
+
+std::vector<GpgFrontend::FilePathPair>
+GpgFrontend::GpgFileOpera::CollectSignaturePairs(const std::string& dir_path) {
+  std::vector<FilePathPair> pairs;
+
+  std::error_code ec;
+  auto it =
+      std::filesystem::recursive_directory_iterator(to_path(dir_path), ec);
+  if (ec) {
+    SPDLOG_ERROR("cannot open manifest directory: {}", ec.message());
+    return pairs;
   }
 
-  std::unique_ptr<std::string> out_buffer;
-  auto err = GpgBasicOperator::GetInstance(_channel).EncryptSymmetric(
-      in_buffer, out_buffer, result);
+  for (const auto& entry : it) {
+    if (!entry.is_regular_file(ec)) continue;
 
-  if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
-    if (!FileOperator::WriteFileStd(out_path_std, *out_buffer)) {
-      throw std::runtime_error("write_buffer_to_file error");
-    };
+    const auto& sign_path = entry.path();
+    auto extension = sign_path.extension().u8string();
+    if (extension != ".sig" && extension != ".asc") continue;
 
-  return err;
+    auto data_path = sign_path;
+    data_path.replace_extension();
+    if (!std::filesystem::is_regular_file(data_path, ec)) continue;
+
+    pairs.emplace_back(data_path.u8string(), sign_path.u8string());
+  }
+
+  // keep the report stable between runs
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
 }
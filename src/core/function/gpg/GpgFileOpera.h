@@ -29,12 +29,52 @@
 #ifndef GPGFRONTEND_GPGFILEOPERA_H
 #define GPGFRONTEND_GPGFILEOPERA_H
 
+#include <chrono>
+#include <utility>
+#include <vector>
+
 #include "core/GpgConstants.h"
 #include "core/GpgContext.h"
 #include "core/GpgModel.h"
 
 namespace GpgFrontend {
 
+using FilePathPair = std::pair<std::string, std::string>;  ///< in, out path
+
+/**
+ * @brief the outcome of one file in a batch operation
+ *
+ * @tparam Result result type of the gpg operation
+ */
+template <typename Result>
+struct GpgFileOperaItem {
+  std::string in_path;                     ///<
+  std::string out_path;                    ///<
+  GpgError error = GPG_ERR_NO_ERROR;       ///<
+  Result result = nullptr;                 ///<
+  uint64_t bytes = 0;                      ///< size of the input file
+  std::chrono::milliseconds elapsed = {};  ///< time spent on this file
+};
+
+/**
+ * @brief aggregated statistics of a batch operation
+ *
+ */
+struct GPGFRONTEND_CORE_EXPORT GpgFileOperaStats {
+  size_t total = 0;                        ///< number of files
+  size_t failed = 0;                       ///< number of failed files
+  uint64_t bytes = 0;                      ///< bytes of all input files
+  int workers = 0;                         ///< number of parallel workers
+  std::chrono::milliseconds elapsed = {};  ///< wall time of the batch
+
+  /**
+   * @brief input bytes processed per second
+   *
+   * @return double
+   */
+  [[nodiscard]] double Throughput() const;
+};
+
 /**
  * @brief Executive files related to the basic operations that are provided by
  * GpgBasicOperator
@@ -146,6 +186,148 @@ class GPGFRONTEND_CORE_EXPORT GpgFileOpera
                                     const std::string& out_path,
                                     GpgDecrResult& decr_res,
                                     GpgVerifyResult& verify_res);
+
+  /**
+   * @brief Encrypt a directory as a tar archive in a single pass, the archive
+   * is streamed into gpgme while it is created, no temporary tarball is
+   * written and the memory used is bounded.
+   *
+   * @param keys Used public key
+   * @param in_path path of the directory
+   * @param out_path path of the encrypted archive
+   * @param result Encrypted results
+   * @param _channel Channel in context
+   * @return GpgError
+   */
+  static GpgError EncryptDirectory(KeyListPtr keys, const std::string& in_path,
+                                   const std::string& out_path,
+                                   GpgEncrResult& result,
+                                   int _channel = GPGFRONTEND_DEFAULT_CHANNEL);
+
+  /**
+   * @brief Encrypt a directory as a tar archive in a single pass with a
+   * symmetric cipher
+   *
+   * @param in_path path of the directory
+   * @param out_path path of the encrypted archive
+   * @param result Encrypted results
+   * @param _channel Channel in context
+   * @return GpgError
+   */
+  static GpgError EncryptDirectorySymmetric(
+      const std::string& in_path, const std::string& out_path,
+      GpgEncrResult& result, int _channel = GPGFRONTEND_DEFAULT_CHANNEL);
+
+  /**
+   * @brief Encrypt and sign a directory as a tar archive in a single pass
+   *
+   * @param keys Used public key
+   * @param signer_keys signers
+   * @param in_path path of the directory
+   * @param out_path path of the encrypted archive
+   * @param encr_res Encrypted results
+   * @param sign_res Signature result
+   * @param _channel Channel in context
+   * @return GpgError
+   */
+  static GpgError EncryptSignDirectory(
+      KeyListPtr keys, KeyListPtr signer_keys, const std::string& in_path,
+      const std::string& out_path, GpgEncrResult& encr_res,
+      GpgSignResult& sign_res, int _channel = GPGFRONTEND_DEFAULT_CHANNEL);
+
+  /**
+   * @brief Decrypt an encrypted tar archive and extract it in a single pass,
+   * the extraction starts with the first decrypted bytes and no plaintext
+   * tarball is written. The entries are extracted into a hidden directory
+   * inside out_path and renamed into place only once the archive is
+   * decrypted and its integrity is checked, nothing is left behind on
+   * failure.
+   *
+   * @param in_path path of the encrypted archive
+   * @param out_path directory the archive is extracted into
+   * @param result Decrypted results
+   * @return GpgError
+   */
+  static GpgError DecryptArchive(const std::string& in_path,
+                                 const std::string& out_path,
+                                 GpgDecrResult& result);
+
+  /**
+   * @brief Decrypt, verify and extract an encrypted tar archive in a single
+   * pass, like DecryptArchive. A bad signature fails the operation and the
+   * archive is not extracted.
+   *
+   * @param in_path path of the encrypted archive
+   * @param out_path directory the archive is extracted into
+   * @param decr_res Decrypted results
+   * @param verify_res Verify results
+   * @return GpgError
+   */
+  static GpgError DecryptVerifyArchive(const std::string& in_path,
+                                       const std::string& out_path,
+                                       GpgDecrResult& decr_res,
+                                       GpgVerifyResult& verify_res);
+
+  /**
+   * @brief Encrypt many files, the files are spread over parallel workers,
+   * each of them owns a gpg context (and so a gpg process) cloned from the
+   * given channel.
+   *
+   * @param keys Used public key
+   * @param paths pairs of input and output path
+   * @param items result of every file, in the order of paths
+   * @param workers number of workers, 0 means one per cpu core
+   * @param _channel Channel whose settings are used by the workers
+   * @return GpgFileOperaStats
+   */
+  static GpgFileOperaStats EncryptFiles(
+      KeyListPtr keys, const std::vector<FilePathPair>& paths,
+      std::vector<GpgFileOperaItem<GpgEncrResult>>& items, int workers = 0,
+      int _channel = GPGFRONTEND_DEFAULT_CHANNEL);
+
+  /**
+   * @brief Verify many detached signatures on parallel workers, the data and
+   * the signature files are streamed. In the items, in_path is the data file
+   * and out_path is the signature file.
+   *
+   * @param paths pairs of data and signature path
+   * @param items result of every pair, in the order of paths
+   * @param workers number of workers, 0 means one per cpu core
+   * @param _channel Channel whose settings are used by the workers
+   * @return GpgFileOperaStats
+   */
+  static GpgFileOperaStats VerifyFiles(
+      const std::vector<FilePathPair>& paths,
+      std::vector<GpgFileOperaItem<GpgVerifyResult>>& items, int workers = 0,
+      int _channel = GPGFRONTEND_DEFAULT_CHANNEL);
+
+  /**
+   * @brief Make detached signatures of many files on parallel workers, the
+   * signers are set once per worker. An empty output path means the input
+   * path with ".asc" (ascii channel) or ".sig" appended.
+   *
+   * @param keys signers
+   * @param paths pairs of input and signature path
+   * @param items result of every file, in the order of paths
+   * @param workers number of workers, 0 means one per cpu core
+   * @param _channel Channel whose settings are used by the workers
+   * @return GpgFileOperaStats
+   */
+  static GpgFileOperaStats SignFiles(
+      KeyListPtr keys, const std::vector<FilePathPair>& paths,
+      std::vector<GpgFileOperaItem<GpgSignResult>>& items, int workers = 0,
+      int _channel = GPGFRONTEND_DEFAULT_CHANNEL);
+
+  /**
+   * @brief Collect the data and signature pairs of a manifest directory, every
+   * .sig or .asc file with a data file next to it (the same name without the
+   * extension) is a pair.
+   *
+   * @param dir_path directory to scan recursively
+   * @return std::vector<FilePathPair>
+   */
+  static std::vector<FilePathPair> CollectSignaturePairs(
+      const std::string& dir_path);
 };
 
 }  // namespace GpgFrontend
@@ -30,13 +30,192 @@
 
 #include <gpg-error.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <iterator>
 #include <mutex>
+#include <set>
 #include <shared_mutex>
+#include <thread>
 #include <utility>
 
 #include "GpgConstants.h"
+#include "core/function/FileOperator.h"
+#include "core/function/GlobalSettingStation.h"
 #include "model/GpgKey.h"
 
+namespace {
+
+std::mutex changed_keys_mutex;       ///< guards the two variables below
+std::set<std::string> changed_keys;  ///< keys changed since the last refresh
+bool keyring_changed = false;        ///< a change not bound to some keys
+
+/**
+ * @brief normalize a key id or fingerprint for the search index
+ *
+ * @param id key id or fingerprint
+ * @return std::string upper case, without 0x prefix
+ */
+std::string normalize_id(const std::string& id) {
+  auto begin = id.rfind("0x", 0) == 0 || id.rfind("0X", 0) == 0 ? 2 : 0;
+  std::string ret = id.substr(begin);
+  std::transform(ret.begin(), ret.end(), ret.begin(),
+                 [](unsigned char c) { return std::toupper(c); });
+  return ret;
+}
+
+/**
+ * @brief normalize a user id or email address for the uid index
+ *
+ * @param uid user id or email address
+ * @return std::string lower case
+ */
+std::string normalize_uid(const std::string& uid) {
+  std::string ret = uid;
+  std::transform(ret.begin(), ret.end(), ret.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return ret;
+}
+
+constexpr int kKeyCacheVersion = 1;  ///< format of the on-disk key cache
+
+/// keyrings smaller than this are listed in one go, see
+/// GpgKeyGetter::list_keys_in_parallel()
+constexpr std::size_t kParallelListingMinKeys = 512;
+constexpr std::size_t kMaxListingWorkers = 8;  ///< contexts listing at once
+
+/**
+ * @brief the size and modification time of the files holding a keyring,
+ * any change to the keyring changes at least one of them
+ *
+ * @param home gnupg home directory
+ * @return nlohmann::json
+ */
+nlohmann::json keyring_stamp(const std::filesystem::path& home) {
+  // keybox, legacy keyring, trust db, keyboxd db and the secret keys
+  const char* const kKeyringFiles[] = {
+      "pubring.kbx",
+      "pubring.gpg",
+      "trustdb.gpg",
+      "public-keys.d/pubring.db",
+      "public-keys.d/pubring.db-wal",
+      "private-keys-v1.d",
+  };
+
+  auto stamp = nlohmann::json::array();
+  for (const auto* name : kKeyringFiles) {
+    std::error_code ec;
+    const auto path = home / name;
+    const auto status = std::filesystem::status(path, ec);
+    if (ec || !std::filesystem::exists(status)) {
+      stamp.push_back({name, -1, -1});
+      continue;
+    }
+
+    int64_t size = 0;
+    if (std::filesystem::is_regular_file(status))
+      size = static_cast<int64_t>(std::filesystem::file_size(path, ec));
+    auto mtime = std::filesystem::last_write_time(path, ec)
+                     .time_since_epoch()
+                     .count();
+    stamp.push_back({name, size, static_cast<int64_t>(mtime)});
+  }
+  return stamp;
+}
+
+/**
+ * @brief the file caching the key summary of a keyring, next to the data
+ * object store
+ *
+ * @param home gnupg home directory
+ * @return std::filesystem::path
+ */
+std::filesystem::path key_cache_path(const std::filesystem::path& home) {
+  auto name =
+      QCryptographicHash::hash(QByteArray::fromStdString(home.u8string()),
+                               QCryptographicHash::Sha256)
+          .toHex()
+          .toStdString();
+  return GpgFrontend::GlobalSettingStation::GetInstance().GetAppDataPath() /
+         "key_cache" / (name + ".json");
+}
+
+/**
+ * @brief whether the key summary is cached on disk
+ *
+ * @return bool
+ */
+bool key_cache_enabled() {
+  return GpgFrontend::GlobalSettingStation::GetInstance().LookupSettings(
+      "general.persist_key_cache", true);
+}
+
+}  // namespace
+
+GpgFrontend::GpgKeyCacheSnapshot::KeyPtr
+GpgFrontend::GpgKeyCacheSnapshot::Find(const std::string& id) const {
+  auto it = keys.find(id);
+  if (it != keys.end()) return it->second;
+
+  auto index_it = search_index.find(normalize_id(id));
+  if (index_it == search_index.end()) return nullptr;
+  it = keys.find(index_it->second);
+  return it != keys.end() ? it->second : nullptr;
+}
+
+void GpgFrontend::GpgKeyCacheSnapshot::Insert(GpgKey key) {
+  auto id = key.GetId();
+  Erase(id);
+
+  search_index[normalize_id(key.GetFingerprint())] = id;
+  for (const auto& subkey : key.GetSubKeysView()) {
+    search_index[normalize_id(subkey.GetID())] = id;
+    search_index[normalize_id(subkey.GetFingerprint())] = id;
+  }
+
+  for (const auto& uid : key.GetUIDsView()) {
+    uid_index[normalize_uid(uid.GetUID())].push_back(id);
+    if (!uid.GetEmail().empty())
+      uid_index[normalize_uid(uid.GetEmail())].push_back(id);
+  }
+
+  keys.emplace(id, std::make_shared<const GpgKey>(std::move(key)));
+}
+
+void GpgFrontend::GpgKeyCacheSnapshot::Erase(const std::string& key_id) {
+  auto it = keys.find(key_id);
+  if (it == keys.end()) return;
+  const auto& key = *it->second;
+
+  auto erase_search = [&](const std::string& alias) {
+    auto index_it = search_index.find(normalize_id(alias));
+    // a subkey may be shared by several keys
+    if (index_it != search_index.end() && index_it->second == key_id)
+      search_index.erase(index_it);
+  };
+  erase_search(key.GetFingerprint());
+  for (const auto& subkey : key.GetSubKeysView()) {
+    erase_search(subkey.GetID());
+    erase_search(subkey.GetFingerprint());
+  }
+
+  auto erase_uid = [&](const std::string& uid) {
+    auto index_it = uid_index.find(normalize_uid(uid));
+    if (index_it == uid_index.end()) return;
+    auto& ids = index_it->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), key_id), ids.end());
+    if (ids.empty()) uid_index.erase(index_it);
+  };
+  for (const auto& uid : key.GetUIDsView()) {
+    erase_uid(uid.GetUID());
+    if (!uid.GetEmail().empty()) erase_uid(uid.GetEmail());
+  }
+
+  keys.erase(it);
+}
+
 GpgFrontend::GpgKeyGetter::GpgKeyGetter(int channel)
     : SingletonFunctionObject<GpgKeyGetter>(channel) {
   SPDLOG_DEBUG("called channel: {}", channel);
@@ -51,7 +230,11 @@ GpgFrontend::GpgKey GpgFrontend::GpgKeyGetter::GetKey(const std::string& fpr,
   }
 
   gpgme_key_t _p_key = nullptr;
-  gpgme_get_key(ctx_, fpr.c_str(), &_p_key, 1);
+  {
+    // the context is shared with the cache refreshes
+    std::lock_guard<std::mutex> lock(keys_cache_mutex_);
+    gpgme_get_key(ctx_, fpr.c_str(), &_p_key, 1);
+  }
   if (_p_key == nullptr) {
     SPDLOG_WARN("GpgKeyGetter GetKey Private _p_key Null fpr", fpr);
     return GetPubkey(fpr);
@@ -69,19 +252,75 @@ GpgFrontend::GpgKey GpgFrontend::GpgKeyGetter::GetPubkey(const std::string& fpr,
   }
 
   gpgme_key_t _p_key = nullptr;
-  gpgme_get_key(ctx_, fpr.c_str(), &_p_key, 0);
+  {
+    std::lock_guard<std::mutex> lock(keys_cache_mutex_);
+    gpgme_get_key(ctx_, fpr.c_str(), &_p_key, 0);
+  }
   if (_p_key == nullptr) SPDLOG_WARN("GpgKeyGetter GetKey _p_key Null", fpr);
   return GpgKey(std::move(_p_key));
 }
 
+GpgFrontend::GpgKey GpgFrontend::GpgKeyGetter::GetDetailedKey(
+    const std::string& id) {
+  {
+    std::lock_guard<std::mutex> lock(detailed_keys_cache_mutex_);
+    auto it = detailed_keys_cache_.find(id);
+    if (it != detailed_keys_cache_.end()) return it->second;
+  }
+
+  gpgme_key_t _p_key = nullptr;
+  {
+    // the context is shared with the cache refreshes, which list keys in
+    // the light mode
+    std::lock_guard<std::mutex> lock(keys_cache_mutex_);
+    auto mode = gpgme_get_keylist_mode(ctx_);
+    check_gpg_error(gpgme_set_keylist_mode(
+        ctx_, mode | GPGME_KEYLIST_MODE_SIGS |
+                  GPGME_KEYLIST_MODE_SIG_NOTATIONS |
+                  GPGME_KEYLIST_MODE_WITH_TOFU));
+    gpgme_get_key(ctx_, id.c_str(), &_p_key, 1);
+    if (_p_key == nullptr) gpgme_get_key(ctx_, id.c_str(), &_p_key, 0);
+    check_gpg_error(gpgme_set_keylist_mode(ctx_, mode));
+  }
+  if (_p_key == nullptr) {
+    SPDLOG_WARN("GpgKeyGetter GetDetailedKey _p_key Null: {}", id);
+    return GpgKey();
+  }
+
+  auto key = GpgKey(std::move(_p_key));
+  std::lock_guard<std::mutex> lock(detailed_keys_cache_mutex_);
+  detailed_keys_cache_.insert_or_assign(id, key);
+  return key;
+}
+
+GpgFrontend::KeyCacheSnapshotPtr
+GpgFrontend::GpgKeyGetter::GetKeyCacheSnapshot() const {
+  return std::atomic_load(&keys_cache_);
+}
+
+GpgFrontend::KeyLinkListPtr GpgFrontend::GpgKeyGetter::GetKeysByUID(
+    const std::string& uid) {
+  auto snapshot = GetKeyCacheSnapshot();
+
+  auto keys_list = std::make_unique<GpgKeyLinkList>();
+  auto it = snapshot->uid_index.find(normalize_uid(uid));
+  if (it == snapshot->uid_index.end()) return keys_list;
+
+  for (const auto& id : it->second) {
+    auto key_it = snapshot->keys.find(id);
+    if (key_it != snapshot->keys.end())
+      keys_list->push_back(key_it->second->Copy());
+  }
+  return keys_list;
+}
+
 GpgFrontend::KeyLinkListPtr GpgFrontend::GpgKeyGetter::FetchKey() {
-  // get the lock
-  std::lock_guard<std::mutex> lock(keys_cache_mutex_);
+  auto snapshot = GetKeyCacheSnapshot();
 
   auto keys_list = std::make_unique<GpgKeyLinkList>();
 
-  for (const auto& [key, value] : keys_cache_) {
-    keys_list->push_back(value.Copy());
+  for (const auto& [key, value] : snapshot->keys) {
+    keys_list->push_back(value->Copy());
   }
   return keys_list;
 }
@@ -89,57 +328,230 @@ GpgFrontend::KeyLinkListPtr GpgFrontend::GpgKeyGetter::FetchKey() {
 void GpgFrontend::GpgKeyGetter::FlushKeyCache() {
   SPDLOG_DEBUG("called channel id: {}", GetChannel());
 
-  // clear the keys cache
-  keys_cache_.clear();
+  // readers keep using the current snapshot until the new one is complete
+  std::lock_guard<std::mutex> lock(keys_cache_mutex_);
+  auto snapshot = std::make_shared<GpgKeyCacheSnapshot>();
+  // taken before listing, a change while listing makes the saved cache stale
+  auto stamp = keyring_stamp(GetGnuPGHome());
 
-  // init
-  GpgError err = gpgme_op_keylist_start(ctx_, nullptr, 0);
+  snapshot->complete_stamp = stamp;
 
-  // for debug
-  assert(check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR);
+  // the keyring didn't change since it was listed completely, so the keys to
+  // list are known and the listing can be split
+  std::vector<std::string> fingerprints;
+  auto current = GetKeyCacheSnapshot();
+  if (current->complete_stamp == stamp) {
+    fingerprints.reserve(current->summary.Size());
+    for (std::size_t row = 0; row < current->summary.Size(); row++) {
+      fingerprints.push_back(current->summary.GetFingerprint(row));
+    }
+  }
 
-  // return when error
-  if (check_gpg_error_2_err_code(err) != GPG_ERR_NO_ERROR) return;
+  std::vector<GpgKey> listed_keys;
+  if (!list_keys_in_parallel(fingerprints, listed_keys)) {
+    // init
+    GpgError err = gpgme_op_keylist_start(ctx_, nullptr, 0);
+
+    // for debug
+    assert(check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR);
+
+    // return when error
+    if (check_gpg_error_2_err_code(err) != GPG_ERR_NO_ERROR) return;
 
-  {
-    // get the lock
-    std::lock_guard<std::mutex> lock(keys_cache_mutex_);
     gpgme_key_t key;
     while ((err = gpgme_op_keylist_next(ctx_, &key)) == GPG_ERR_NO_ERROR) {
-      auto gpg_key = GpgKey(std::move(key));
+      listed_keys.emplace_back(std::move(key));
+    }
 
-      // detect if the key is in a smartcard
-      // if so, try to get full information using gpgme_get_key()
-      // this maybe a bug in gpgme
-      if (gpg_key.IsHasCardKey()) {
-        gpg_key = GetKey(gpg_key.GetId(), false);
-      }
+    // for debug
+    assert(check_gpg_error_2_err_code(err, GPG_ERR_EOF) == GPG_ERR_EOF);
 
-      keys_cache_.insert({gpg_key.GetId(), std::move(gpg_key)});
-    }
+    // a partial listing is never taken for a complete one
+    if (check_gpg_error_2_err_code(err, GPG_ERR_EOF) != GPG_ERR_EOF)
+      snapshot->complete_stamp = nullptr;
+
+    err = gpgme_op_keylist_end(ctx_);
+    assert(check_gpg_error_2_err_code(err, GPG_ERR_EOF) == GPG_ERR_NO_ERROR);
+
+    reload_card_keys(ctx_, listed_keys);
   }
 
+  for (auto& gpg_key : listed_keys) snapshot->Insert(std::move(gpg_key));
+
   SPDLOG_DEBUG("cache address: {} object address: {}",
-               static_cast<void*>(&keys_cache_), static_cast<void*>(this));
+               static_cast<void*>(snapshot.get()), static_cast<void*>(this));
 
-  // for debug
-  assert(check_gpg_error_2_err_code(err, GPG_ERR_EOF) == GPG_ERR_EOF);
+  snapshot->summary.Build(snapshot->keys);
+  std::atomic_store(&keys_cache_, KeyCacheSnapshotPtr(snapshot));
+  save_key_cache(*snapshot, stamp);
 
-  err = gpgme_op_keylist_end(ctx_);
-  assert(check_gpg_error_2_err_code(err, GPG_ERR_EOF) == GPG_ERR_NO_ERROR);
+  std::lock_guard<std::mutex> detailed_lock(detailed_keys_cache_mutex_);
+  detailed_keys_cache_.clear();
+}
+
+bool GpgFrontend::GpgKeyGetter::LoadKeyCache() {
+  if (GetChannel() != GetDefaultChannel() || !key_cache_enabled())
+    return false;
+
+  const auto home = GetGnuPGHome();
+  if (home.empty()) return false;
+  const auto path = key_cache_path(home);
+
+  std::string buffer;
+  if (!std::filesystem::exists(path) ||
+      !FileOperator::ReadFileStd(path, buffer))
+    return false;
+
+  auto snapshot = std::make_shared<GpgKeyCacheSnapshot>();
+  snapshot->from_disk = true;
+  try {
+    auto json = nlohmann::json::parse(buffer);
+    if (json.at("version").get<int>() != kKeyCacheVersion ||
+        json.at("stamp") != keyring_stamp(home)) {
+      SPDLOG_DEBUG("key cache on disk is stale: {}", path.u8string());
+      return false;
+    }
+    if (!snapshot->summary.FromJson(json.at("summary"))) return false;
+    snapshot->complete_stamp = json.value("complete_stamp", nlohmann::json());
+  } catch (...) {
+    SPDLOG_ERROR("failed to load key cache: {}", path.u8string());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(keys_cache_mutex_);
+  // never replace keys which are already loaded
+  auto current = GetKeyCacheSnapshot();
+  if (!current->keys.empty() || current->summary.Size() != 0) return false;
+
+  SPDLOG_DEBUG("key cache loaded from disk, keys: {}",
+               snapshot->summary.Size());
+  std::atomic_store(&keys_cache_, KeyCacheSnapshotPtr(std::move(snapshot)));
+  return true;
+}
+
+void GpgFrontend::GpgKeyGetter::UpdateKeyCache(
+    const std::vector<std::string>& ids) {
+  SPDLOG_DEBUG("called channel id: {} keys: {}", GetChannel(), ids.size());
+  if (ids.empty()) return;
+
+  // there are no keys to update yet
+  if (GetKeyCacheSnapshot()->from_disk) {
+    FlushKeyCache();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(keys_cache_mutex_);
+  auto stamp = keyring_stamp(GetGnuPGHome());
+
+  // list the keys the same way FlushKeyCache() does, only fewer of them
+  std::vector<GpgKey> listed_keys;
+  if (!list_keys(ctx_, ids, false, listed_keys)) return;
+  reload_card_keys(ctx_, listed_keys);
+
+  // the keys are shared with the current snapshot, only the maps are copied
+  auto snapshot =
+      std::make_shared<GpgKeyCacheSnapshot>(*GetKeyCacheSnapshot());
+  // keys changed without a record would slip through a partitioned listing
+  snapshot->complete_stamp = nullptr;
+
+  // drop the keys which are gone, e.g. deleted ones
+  for (const auto& id : ids) {
+    auto cached_key = snapshot->Find(id);
+    if (cached_key == nullptr) continue;
+
+    auto key_id = cached_key->GetId();
+    auto listed = std::any_of(
+        listed_keys.begin(), listed_keys.end(),
+        [&](const GpgKey& listed_key) { return listed_key.GetId() == key_id; });
+    if (!listed) snapshot->Erase(key_id);
+  }
+
+  for (auto& gpg_key : listed_keys) snapshot->Insert(std::move(gpg_key));
+
+  snapshot->summary.Build(snapshot->keys);
+  std::atomic_store(&keys_cache_, KeyCacheSnapshotPtr(snapshot));
+  save_key_cache(*snapshot, stamp);
+
+  std::lock_guard<std::mutex> detailed_lock(detailed_keys_cache_mutex_);
+  detailed_keys_cache_.clear();
+}
+
+void GpgFrontend::GpgKeyGetter::MarkKeysChanged(
+    const std::vector<std::string>& ids) {
+  std::lock_guard<std::mutex> lock(changed_keys_mutex);
+  changed_keys.insert(ids.begin(), ids.end());
+}
+
+void GpgFrontend::GpgKeyGetter::MarkKeyringChanged() {
+  std::lock_guard<std::mutex> lock(changed_keys_mutex);
+  keyring_changed = true;
+}
+
+void GpgFrontend::GpgKeyGetter::RefreshKeyCaches() {
+  std::vector<std::string> ids;
+  bool flush;
+  {
+    std::lock_guard<std::mutex> lock(changed_keys_mutex);
+    ids.assign(changed_keys.begin(), changed_keys.end());
+    // nothing recorded, the change came from somewhere we don't track
+    flush = keyring_changed || ids.empty();
+    changed_keys.clear();
+    keyring_changed = false;
+  }
+
+  for (const auto& channel_id : GetAllChannelId()) {
+    if (flush) {
+      GetInstance(channel_id).FlushKeyCache();
+    } else {
+      GetInstance(channel_id).UpdateKeyCache(ids);
+    }
+  }
 }
 
 GpgFrontend::KeyListPtr GpgFrontend::GpgKeyGetter::GetKeys(
     const KeyIdArgsListPtr& ids) {
+  auto snapshot = GetKeyCacheSnapshot();
+
+  std::vector<std::string> misses;
+  for (const auto& id : *ids) {
+    if (snapshot->Find(id) == nullptr) misses.push_back(id);
+  }
+
+  // resolve all the misses with one listing, as GetKey() does: secret keys
+  // first, then public keys
+  GpgKeyCacheSnapshot fetched;
+  if (!misses.empty()) {
+    std::lock_guard<std::mutex> lock(keys_cache_mutex_);
+
+    std::vector<GpgKey> listed_keys;
+    list_keys(ctx_, misses, true, listed_keys);
+    for (auto& gpg_key : listed_keys) fetched.Insert(std::move(gpg_key));
+
+    std::vector<std::string> public_misses;
+    for (const auto& id : misses) {
+      if (fetched.Find(id) == nullptr) public_misses.push_back(id);
+    }
+
+    listed_keys.clear();
+    list_keys(ctx_, public_misses, false, listed_keys);
+    for (auto& gpg_key : listed_keys) fetched.Insert(std::move(gpg_key));
+  }
+
   auto keys = std::make_unique<KeyArgsList>();
-  for (const auto& id : *ids) keys->emplace_back(GetKey(id));
+  for (const auto& id : *ids) {
+    auto key = snapshot->Find(id);
+    if (key == nullptr) key = fetched.Find(id);
+    if (key == nullptr) {
+      SPDLOG_WARN("GpgKeyGetter GetKeys key not found: {}", id);
+    }
+    keys->push_back(key != nullptr ? *key : GpgKey());
+  }
   return keys;
 }
 
 GpgFrontend::KeyLinkListPtr GpgFrontend::GpgKeyGetter::GetKeysCopy(
     const GpgFrontend::KeyLinkListPtr& keys) {
-  // get the lock
-  std::lock_guard<std::mutex> lock(ctx_mutex_);
+  // copies only take gpgme key references, no lock needed
   auto keys_copy = std::make_unique<GpgKeyLinkList>();
   for (const auto& key : *keys) keys_copy->emplace_back(key.Copy());
   return keys_copy;
@@ -147,8 +559,7 @@ GpgFrontend::KeyLinkListPtr GpgFrontend::GpgKeyGetter::GetKeysCopy(
 
 GpgFrontend::KeyListPtr GpgFrontend::GpgKeyGetter::GetKeysCopy(
     const GpgFrontend::KeyListPtr& keys) {
-  // get the lock
-  std::lock_guard<std::mutex> lock(ctx_mutex_);
+  // copies only take gpgme key references, no lock needed
   auto keys_copy = std::make_unique<KeyArgsList>();
   for (const auto& key : *keys) keys_copy->emplace_back(key.Copy());
   return keys_copy;
@@ -156,12 +567,178 @@ GpgFrontend::KeyListPtr GpgFrontend::GpgKeyGetter::GetKeysCopy(
 
 GpgFrontend::GpgKey GpgFrontend::GpgKeyGetter::get_key_in_cache(
     const std::string& id) {
-  std::lock_guard<std::mutex> lock(keys_cache_mutex_);
-  if (keys_cache_.find(id) != keys_cache_.end()) {
-    std::lock_guard<std::mutex> lock(ctx_mutex_);
-    // return a copy of the key in cache
-    return keys_cache_[id].Copy();
+  auto key = GetKeyCacheSnapshot()->Find(id);
+  if (key != nullptr) {
+    // return a copy of the key in cache, a cheap reference
+    return *key;
   }
   // return a bad key
   return GpgKey();
 }
+
+void GpgFrontend::GpgKeyGetter::save_key_cache(
+    const GpgKeyCacheSnapshot& snapshot, const nlohmann::json& keyring_stamp) {
+  if (GetChannel() != GetDefaultChannel() || !key_cache_enabled()) return;
+
+  const auto home = GetGnuPGHome();
+  if (home.empty()) return;
+  const auto path = key_cache_path(home);
+
+  nlohmann::json json;
+  json["version"] = kKeyCacheVersion;
+  json["stamp"] = keyring_stamp;
+  if (!snapshot.complete_stamp.is_null())
+    json["complete_stamp"] = snapshot.complete_stamp;
+  json["summary"] = snapshot.summary.ToJson();
+
+  try {
+    std::filesystem::create_directories(path.parent_path());
+    // write aside and rename, a crash never leaves a truncated cache
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    if (!FileOperator::WriteFileStd(tmp_path, json.dump())) {
+      SPDLOG_ERROR("failed to write key cache: {}", tmp_path.u8string());
+      return;
+    }
+    std::filesystem::rename(tmp_path, path);
+  } catch (const std::filesystem::filesystem_error& e) {
+    SPDLOG_ERROR("failed to save key cache: {}", e.what());
+  }
+}
+
+std::filesystem::path GpgFrontend::GpgKeyGetter::GetGnuPGHome() const {
+  for (auto engine_info = gpgme_ctx_get_engine_info(ctx_);
+       engine_info != nullptr; engine_info = engine_info->next) {
+    if (engine_info->protocol == GPGME_PROTOCOL_OpenPGP &&
+        engine_info->home_dir != nullptr)
+      return std::filesystem::u8path(engine_info->home_dir);
+  }
+
+  // the context uses the default home directory
+  const auto* home_dir = gpgme_get_dirinfo("homedir");
+  if (home_dir == nullptr) return {};
+  return std::filesystem::u8path(home_dir);
+}
+
+bool GpgFrontend::GpgKeyGetter::list_keys(
+    gpgme_ctx_t ctx, const std::vector<std::string>& patterns,
+    bool secret_only, std::vector<GpgKey>& keys) {
+  // keep the gpg command lines reasonably short
+  constexpr std::size_t kPatternsPerListing = 256;
+
+  for (std::size_t begin = 0; begin < patterns.size();
+       begin += kPatternsPerListing) {
+    auto end = std::min(patterns.size(), begin + kPatternsPerListing);
+
+    std::vector<const char*> c_patterns;
+    for (auto i = begin; i < end; i++) {
+      c_patterns.push_back(patterns[i].c_str());
+    }
+    c_patterns.push_back(nullptr);
+
+    GpgError err = gpgme_op_keylist_ext_start(ctx, c_patterns.data(),
+                                              secret_only ? 1 : 0, 0);
+    if (check_gpg_error_2_err_code(err) != GPG_ERR_NO_ERROR) return false;
+
+    gpgme_key_t key;
+    while ((err = gpgme_op_keylist_next(ctx, &key)) == GPG_ERR_NO_ERROR) {
+      keys.emplace_back(std::move(key));
+    }
+    gpgme_op_keylist_end(ctx);
+    // a listing stopped by an error is partial
+    if (check_gpg_error_2_err_code(err, GPG_ERR_EOF) != GPG_ERR_EOF)
+      return false;
+  }
+  return true;
+}
+
+void GpgFrontend::GpgKeyGetter::reload_card_keys(gpgme_ctx_t ctx,
+                                                 std::vector<GpgKey>& keys) {
+  // the public listing lacks some information of the keys in a smartcard,
+  // this maybe a bug in gpgme. list them again as secret keys, all at once.
+  std::vector<std::string> card_key_ids;
+  for (const auto& key : keys) {
+    if (key.IsHasCardKey()) card_key_ids.push_back(key.GetId());
+  }
+  if (card_key_ids.empty()) return;
+
+  std::vector<GpgKey> card_keys;
+  if (!list_keys(ctx, card_key_ids, true, card_keys)) return;
+
+  std::unordered_map<std::string, GpgKey> card_keys_by_id;
+  for (auto& key : card_keys) {
+    auto id = key.GetId();
+    card_keys_by_id.insert_or_assign(std::move(id), std::move(key));
+  }
+  for (auto& key : keys) {
+    auto it = card_keys_by_id.find(key.GetId());
+    if (it != card_keys_by_id.end()) key = it->second;
+  }
+}
+
+bool GpgFrontend::GpgKeyGetter::list_keys_in_parallel(
+    const std::vector<std::string>& fingerprints, std::vector<GpgKey>& keys) {
+  if (fingerprints.size() < kParallelListingMinKeys) return false;
+
+  auto workers = std::min<std::size_t>(
+      {std::max(std::thread::hardware_concurrency(), 1U), kMaxListingWorkers,
+       fingerprints.size() / (kParallelListingMinKeys / 2)});
+  if (workers < 2) return false;
+
+  // the contexts are kept for the next flush, they are cheap while idle
+  while (listing_ctx_.size() < workers) {
+    auto args = ctx_.GetInitArgs();
+    // used right away from this thread, which maybe has no event loop
+    args.sync_init = true;
+    auto ctx = std::make_unique<GpgContext>(args);
+    if (!ctx->good()) break;
+    listing_ctx_.push_back(std::move(ctx));
+  }
+  workers = std::min(workers, listing_ctx_.size());
+  if (workers < 2) return false;
+
+  SPDLOG_DEBUG("list keys in parallel, keys: {} workers: {}",
+               fingerprints.size(), workers);
+
+  std::vector<std::vector<GpgKey>> partitions(workers);
+  std::vector<char> succeeded(workers, 0);
+  const auto partition_size = (fingerprints.size() + workers - 1) / workers;
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < workers; i++) {
+    threads.emplace_back([&, i]() {
+      auto begin = std::min(fingerprints.size(), i * partition_size);
+      auto end = std::min(fingerprints.size(), begin + partition_size);
+      std::vector<std::string> patterns(fingerprints.begin() + begin,
+                                        fingerprints.begin() + end);
+
+      gpgme_ctx_t ctx = *listing_ctx_[i];
+      if (!list_keys(ctx, patterns, false, partitions[i])) return;
+      reload_card_keys(ctx, partitions[i]);
+      succeeded[i] = 1;
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  std::size_t listed = 0;
+  for (std::size_t i = 0; i < workers; i++) {
+    if (!succeeded[i]) {
+      SPDLOG_WARN("parallel key listing failed, partition: {}", i);
+      return false;
+    }
+    listed += partitions[i].size();
+  }
+  // a key is gone, the keyring changed after all
+  if (listed != fingerprints.size()) {
+    SPDLOG_WARN("parallel key listing missed keys, expected: {} listed: {}",
+                fingerprints.size(), listed);
+    return false;
+  }
+
+  // merged on this thread, the snapshot is published in one swap later
+  keys.reserve(keys.size() + listed);
+  for (auto& partition : partitions) {
+    std::move(partition.begin(), partition.end(), std::back_inserter(keys));
+  }
+  return true;
+}
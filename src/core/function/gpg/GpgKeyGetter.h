@@ -29,7 +29,10 @@
 #ifndef GPGFRONTEND_ZH_CN_TS_GPGKEYGETTER_H
 #define GPGFRONTEND_ZH_CN_TS_GPGKEYGETTER_H
 
+#include <filesystem>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "core/GpgContext.h"
@@ -38,6 +41,75 @@
 
 namespace GpgFrontend {
 
+/**
+ * @brief an immutable view of the key cache. A refresh builds a new snapshot
+ * and publishes it as a whole, so readers never lock and never see a half
+ * updated cache.
+ *
+ */
+struct GPGFRONTEND_CORE_EXPORT GpgKeyCacheSnapshot {
+  using KeyPtr = std::shared_ptr<const GpgKey>;  ///<
+
+  std::map<std::string, KeyPtr> keys;  ///< key id to key
+
+  /**
+   * @brief fingerprint, subkey ids and subkey fingerprints (upper case, no
+   * 0x prefix) to key id
+   *
+   */
+  std::unordered_map<std::string, std::string> search_index;
+
+  /**
+   * @brief lower case user ids and email addresses to key ids
+   *
+   */
+  std::unordered_map<std::string, std::vector<std::string>> uid_index;
+
+  /**
+   * @brief flat summary of the keys for listing and filtering, rebuilt
+   * before the snapshot is published
+   *
+   */
+  GpgKeySummaryTable summary;
+
+  bool from_disk = false;  ///< only the summary is loaded, from the disk cache
+
+  /**
+   * @brief the keyring stamp taken before the whole keyring was listed into
+   * this snapshot, null once the snapshot is patched by UpdateKeyCache().
+   * While the keyring still has this stamp the keys of the summary are all
+   * the keys there are, so they can be listed again in parallel.
+   *
+   */
+  nlohmann::json complete_stamp;
+
+  /**
+   * @brief find a key
+   *
+   * @param id key id, fingerprint, subkey id or subkey fingerprint
+   * @return KeyPtr nullptr if not found
+   */
+  [[nodiscard]] KeyPtr Find(const std::string& id) const;
+
+  /**
+   * @brief add a key and index it, replacing the key with the same id. Only
+   * used while the snapshot is being built.
+   *
+   * @param key
+   */
+  void Insert(GpgKey key);
+
+  /**
+   * @brief remove a key and its index entries. Only used while the snapshot
+   * is being built.
+   *
+   * @param key_id
+   */
+  void Erase(const std::string& key_id);
+};
+
+using KeyCacheSnapshotPtr = std::shared_ptr<const GpgKeyCacheSnapshot>;  ///<
+
 /**
  * @brief
  *
@@ -61,6 +133,16 @@ class GPGFRONTEND_CORE_EXPORT GpgKeyGetter
    */
   GpgKey GetKey(const std::string& id, bool use_cache = true);
 
+  /**
+   * @brief Get the key with its signatures, signature notations and tofu
+   * info, which the cached keys are listed without. The result is cached
+   * until the next refresh of the key cache.
+   *
+   * @param id key id or fingerprint
+   * @return GpgKey
+   */
+  GpgKey GetDetailedKey(const std::string& id);
+
   /**
    * @brief Get the Keys object
    *
@@ -77,6 +159,30 @@ class GPGFRONTEND_CORE_EXPORT GpgKeyGetter
    */
   GpgKey GetPubkey(const std::string& id, bool use_cache = true);
 
+  /**
+   * @brief Get the current snapshot of the key cache, it stays valid and
+   * unchanged while it is held, without any locking
+   *
+   * @return KeyCacheSnapshotPtr
+   */
+  [[nodiscard]] KeyCacheSnapshotPtr GetKeyCacheSnapshot() const;
+
+  /**
+   * @brief Get the gnupg home directory of the context
+   *
+   * @return std::filesystem::path empty if unknown
+   */
+  [[nodiscard]] std::filesystem::path GetGnuPGHome() const;
+
+  /**
+   * @brief Get the keys having a user id or an email address, only the cache
+   * is searched
+   *
+   * @param uid full user id or email address, case insensitive
+   * @return KeyLinkListPtr
+   */
+  KeyLinkListPtr GetKeysByUID(const std::string& uid);
+
   /**
    * @brief Get all the keys by receiving a linked list
    *
@@ -90,6 +196,47 @@ class GPGFRONTEND_CORE_EXPORT GpgKeyGetter
    */
   void FlushKeyCache();
 
+  /**
+   * @brief publish the key summary saved on disk by the last refresh, if the
+   * keyring files didn't change since. Only the summary is loaded, the keys
+   * still have to be fetched by FlushKeyCache().
+   *
+   * @return true if the summary is loaded
+   */
+  bool LoadKeyCache();
+
+  /**
+   * @brief reload only the given keys into the cache, the keys which are no
+   * longer in the keyring are dropped from it
+   *
+   * @param ids fingerprints or ids of the keys
+   */
+  void UpdateKeyCache(const std::vector<std::string>& ids);
+
+  /**
+   * @brief record the keys changed by an operation, so that the next
+   * RefreshKeyCaches() only has to reload them
+   *
+   * @param ids fingerprints or ids of the keys
+   */
+  static void MarkKeysChanged(const std::vector<std::string>& ids);
+
+  /**
+   * @brief record a change whose effect can't be narrowed down to some keys,
+   * e.g. an owner trust change alters the validity of other keys, so that the
+   * next RefreshKeyCaches() reloads the whole keyring
+   *
+   */
+  static void MarkKeyringChanged();
+
+  /**
+   * @brief bring the key cache of every channel up to date with the changes
+   * recorded since the last call. The whole keyring is only listed again if
+   * a change could not be narrowed down or nothing was recorded at all.
+   *
+   */
+  static void RefreshKeyCaches();
+
   /**
    * @brief Get the Keys Copy object
    *
@@ -115,30 +262,91 @@ class GPGFRONTEND_CORE_EXPORT GpgKeyGetter
       GpgContext::GetInstance(SingletonFunctionObject::GetChannel());
 
   /**
-   * @brief shared mutex for the keys cache
+   * @brief the published key cache, only accessed through std::atomic_load
+   * and std::atomic_store
    *
    */
-  mutable std::mutex ctx_mutex_;
+  KeyCacheSnapshotPtr keys_cache_ = std::make_shared<GpgKeyCacheSnapshot>();
 
   /**
-   * @brief cache the keys with key id
+   * @brief serializes the writers of the keys cache and every use of ctx_,
+   * which is not thread safe. Readers of the snapshot don't take it.
    *
    */
-  std::map<std::string, GpgKey> keys_cache_;
+  mutable std::mutex keys_cache_mutex_;
 
   /**
-   * @brief shared mutex for the keys cache
+   * @brief keys listed by GetDetailedKey(), dropped on every refresh
    *
    */
-  mutable std::mutex keys_cache_mutex_;
+  std::unordered_map<std::string, GpgKey> detailed_keys_cache_;
+
+  /**
+   * @brief guards detailed_keys_cache_
+   *
+   */
+  mutable std::mutex detailed_keys_cache_mutex_;
+
+  /**
+   * @brief contexts listing the partitions of the keyring in parallel,
+   * created on first use and guarded by keys_cache_mutex_
+   *
+   */
+  std::vector<std::unique_ptr<GpgContext>> listing_ctx_;
 
   /**
    * @brief Get the Key object
    *
-   * @param id
+   * @param id key id, fingerprint, subkey id or subkey fingerprint
    * @return GpgKey
    */
   GpgKey get_key_in_cache(const std::string& id);
+
+  /**
+   * @brief list the keys matching the patterns with as few keylist
+   * operations as possible, nobody else may use the context meanwhile
+   *
+   * @param ctx context to list with, e.g. ctx_ with keys_cache_mutex_ held
+   * @param patterns key ids or fingerprints
+   * @param secret_only list secret keys only
+   * @param keys the listed keys are appended to it
+   * @return false if a listing failed
+   */
+  static bool list_keys(gpgme_ctx_t ctx,
+                        const std::vector<std::string>& patterns,
+                        bool secret_only, std::vector<GpgKey>& keys);
+
+  /**
+   * @brief replace the smartcard backed keys with complete listings of
+   * them, nobody else may use the context meanwhile
+   *
+   * @param ctx context to list with, e.g. ctx_ with keys_cache_mutex_ held
+   * @param keys
+   */
+  static void reload_card_keys(gpgme_ctx_t ctx, std::vector<GpgKey>& keys);
+
+  /**
+   * @brief list the keys of a complete snapshot again, split into partitions
+   * listed on separate contexts at once, keys_cache_mutex_ must be held
+   *
+   * @param fingerprints fingerprints of all the keys in the keyring
+   * @param keys the listed keys are appended to it
+   * @return false if it's not worth it or a partition failed, then nothing
+   * is appended
+   */
+  bool list_keys_in_parallel(const std::vector<std::string>& fingerprints,
+                             std::vector<GpgKey>& keys);
+
+  /**
+   * @brief save the summary of a snapshot to disk, keys_cache_mutex_ must be
+   * held
+   *
+   * @param snapshot
+   * @param keyring_stamp the keyring state before the keys were listed
+   */
+  void save_key_cache(const GpgKeyCacheSnapshot& snapshot,
+                      const nlohmann::json& keyring_stamp);
+
 };
 }  // namespace GpgFrontend
 
@@ -53,13 +53,16 @@ GpgFrontend::GpgImportInformation GpgFrontend::GpgKeyImportExporter::ImportKey(
   result = gpgme_op_import_result(ctx_);
   gpgme_import_status_t status = result->imports;
   auto import_info = std::make_unique<GpgImportInformation>(result);
+  std::vector<std::string> fprs;
   while (status != nullptr) {
     GpgImportedKey key;
     key.import_status = static_cast<int>(status->status);
     key.fpr = status->fpr;
     import_info->importedKeys.emplace_back(key);
+    if (status->fpr != nullptr) fprs.emplace_back(status->fpr);
     status = status->next;
   }
+  GpgKeyGetter::MarkKeysChanged(fprs);
 
   return *import_info;
 }
@@ -58,6 +58,7 @@ bool GpgFrontend::GpgKeyManager::SignKey(
 
   auto err = check_gpg_error(gpgme_op_keysign(
       ctx_, gpgme_key_t(target), uid.c_str(), expires_time_t, flags));
+  GpgKeyGetter::MarkKeysChanged({target.GetFingerprint()});
 
   return check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR;
 }
@@ -66,6 +67,7 @@ bool GpgFrontend::GpgKeyManager::RevSign(
     const GpgFrontend::GpgKey& key,
     const GpgFrontend::SignIdArgsListPtr& signature_id) {
   auto& key_getter = GpgKeyGetter::GetInstance();
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
 
   for (const auto& sign_id : *signature_id) {
     auto signing_key = key_getter.GetKey(sign_id.first);
@@ -93,6 +95,7 @@ bool GpgFrontend::GpgKeyManager::SetExpire(
 
   auto err = check_gpg_error(
       gpgme_op_setexpire(ctx_, gpgme_key_t(key), expires_time, sub_fprs, 0));
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
 
   return check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR;
 }
@@ -183,6 +186,8 @@ bool GpgFrontend::GpgKeyManager::SetOwnerTrustLevel(const GpgKey& key,
   auto err = gpgme_op_interact(ctx_, gpgme_key_t(key), 0,
                                GpgKeyManager::interactor_cb_fnc,
                                (void*)&handel_struct, data_out);
+  // the validity of the keys certified by this key changes too
+  GpgKeyGetter::MarkKeyringChanged();
   if (err != GPG_ERR_NO_ERROR) {
     SPDLOG_ERROR("fail to set owner trust level {} to key {}, err: {}",
                  trust_level, key.GetId(), gpgme_strerror(err));
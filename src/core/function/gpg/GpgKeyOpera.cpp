@@ -62,6 +62,7 @@ void GpgFrontend::GpgKeyOpera::DeleteKeys(
       SPDLOG_WARN("GpgKeyOpera DeleteKeys get key failed", tmp);
     }
   }
+  GpgKeyGetter::MarkKeysChanged(*key_ids);
 }
 
 /**
@@ -93,6 +94,7 @@ GpgFrontend::GpgError GpgFrontend::GpgKeyOpera::SetExpire(
     err = gpgme_op_setexpire(ctx_, gpgme_key_t(key), expires_time,
                              subkey_fpr.c_str(), 0);
 
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
   return err;
 }
 
@@ -219,6 +221,7 @@ GpgFrontend::GpgError GpgFrontend::GpgKeyOpera::GenerateKey(
   if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR) {
     auto temp_result = _new_result(gpgme_op_genkey_result(ctx_));
     std::swap(temp_result, result);
+    if (result->fpr != nullptr) GpgKeyGetter::MarkKeysChanged({result->fpr});
   }
 
   return check_gpg_error(err);
@@ -259,6 +262,7 @@ GpgFrontend::GpgError GpgFrontend::GpgKeyOpera::GenerateSubkey(
 
   auto err =
       gpgme_op_createsubkey(ctx_, gpgme_key_t(key), algo, 0, expires, flags);
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
   return check_gpg_error(err);
 }
 
@@ -269,6 +273,7 @@ GpgFrontend::GpgError GpgFrontend::GpgKeyOpera::ModifyPassword(
     return GPG_ERR_NOT_SUPPORTED;
   }
   auto err = gpgme_op_passwd(ctx_, gpgme_key_t(key), 0);
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
   return check_gpg_error(err);
 }
 GpgFrontend::GpgError GpgFrontend::GpgKeyOpera::ModifyTOFUPolicy(
@@ -278,6 +283,7 @@ GpgFrontend::GpgError GpgFrontend::GpgKeyOpera::ModifyTOFUPolicy(
     return GPG_ERR_NOT_SUPPORTED;
   }
   auto err = gpgme_op_tofu_policy(ctx_, gpgme_key_t(key), tofu_policy);
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
   return check_gpg_error(err);
 }
 
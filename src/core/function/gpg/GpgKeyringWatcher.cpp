@@ -0,0 +1,202 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/function/gpg/GpgKeyringWatcher.h"
+
+#include <boost/algorithm/string.hpp>
+#include <vector>
+
+#include "core/GpgContext.h"
+#include "core/function/gpg/GpgCommandExecutor.h"
+#include "core/function/gpg/GpgKeyGetter.h"
+#include "core/thread/Task.h"
+#include "core/thread/TaskRunnerGetter.h"
+
+namespace {
+
+constexpr int kDebounceInterval = 1000;  ///< ms without change before a check
+
+}  // namespace
+
+GpgFrontend::GpgKeyringWatcher::GpgKeyringWatcher(QObject* parent)
+    : QObject(parent),
+      watcher_(new QFileSystemWatcher(this)),
+      debounce_timer_(new QTimer(this)),
+      home_(GpgKeyGetter::GetInstance().GetGnuPGHome()) {
+  debounce_timer_->setSingleShot(true);
+  debounce_timer_->setInterval(kDebounceInterval);
+
+  connect(watcher_, &QFileSystemWatcher::fileChanged, this,
+          &GpgKeyringWatcher::slot_path_changed);
+  connect(watcher_, &QFileSystemWatcher::directoryChanged, this,
+          &GpgKeyringWatcher::slot_path_changed);
+  connect(debounce_timer_, &QTimer::timeout, this,
+          &GpgKeyringWatcher::slot_check_keyring);
+
+  if (home_.empty()) {
+    SPDLOG_WARN("gnupg home directory unknown, keyring not watched");
+    return;
+  }
+
+  // the first listing is only kept to compare the next ones with
+  slot_check_keyring();
+}
+
+void GpgFrontend::GpgKeyringWatcher::slot_path_changed(const QString& path) {
+  SPDLOG_DEBUG("keyring path changed: {}", path.toStdString());
+  debounce_timer_->start();
+}
+
+void GpgFrontend::GpgKeyringWatcher::slot_check_keyring() {
+  watch_paths();
+
+  // the task may outlive the watcher, it only shares the digests with it
+  auto* check_task = new Thread::Task(
+      [state = key_digests_](Thread::Task::DataObjectPtr) -> int {
+        std::map<std::string, std::string> key_digests;
+        if (!list_key_digests(key_digests)) return -1;
+
+        std::vector<std::string> changed_keys;
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          if (state->loaded) {
+            const auto& last_digests = state->digests;
+            // new or modified keys
+            for (const auto& [fpr, digest] : key_digests) {
+              auto it = last_digests.find(fpr);
+              if (it == last_digests.end() || it->second != digest)
+                changed_keys.push_back(fpr);
+            }
+            // deleted keys
+            for (const auto& [fpr, digest] : last_digests) {
+              if (key_digests.count(fpr) == 0) changed_keys.push_back(fpr);
+            }
+          }
+          state->digests = std::move(key_digests);
+          state->loaded = true;
+        }
+
+        if (changed_keys.empty()) return 0;
+        SPDLOG_DEBUG("keys changed outside: {}", changed_keys.size());
+
+        // only the changed keys are reloaded by the next refresh
+        GpgKeyGetter::MarkKeysChanged(changed_keys);
+        return 1;
+      },
+      "check_keyring_task", nullptr,
+      // called on the thread of the watcher, where the pointer can be checked
+      [self = QPointer<GpgKeyringWatcher>(this)](
+          int rtn, const Thread::Task::DataObjectPtr&) {
+        if (rtn == 1 && self != nullptr) emit self->SignalKeyringChanged();
+      });
+
+  Thread::TaskRunnerGetter::GetInstance()
+      .GetTaskRunner(Thread::TaskRunnerGetter::kTaskRunnerType_GPG)
+      ->PostTask(check_task, Thread::Task::kTaskPriority_Background);
+}
+
+void GpgFrontend::GpgKeyringWatcher::watch_paths() {
+  // keybox, legacy keyring, trust db, keyboxd db and its write ahead log,
+  // where most of its writes land, and the secret keys. not
+  // the home directory itself, gpg creates lock files there on every run.
+  const char* const kWatchedPaths[] = {
+      "pubring.kbx",
+      "pubring.gpg",
+      "trustdb.gpg",
+      "public-keys.d/pubring.db",
+      "public-keys.d/pubring.db-wal",
+      "private-keys-v1.d",
+  };
+
+  const auto watched = watcher_->files() + watcher_->directories();
+  for (const auto* name : kWatchedPaths) {
+    auto path = QString::fromStdString((home_ / name).u8string());
+    if (!watched.contains(path) && QFileInfo::exists(path))
+      watcher_->addPath(path);
+  }
+}
+
+bool GpgFrontend::GpgKeyringWatcher::list_key_digests(
+    std::map<std::string, std::string>& key_digests) {
+  auto& ctx = GpgContext::GetInstance();
+
+  std::vector<std::string> arguments = {"--batch", "--no-tty", "--with-colons",
+                                        "--fixed-list-mode",
+                                        "--with-fingerprint"};
+  if (ctx.GetInfo().GnupgVersion >= "2.1.0")
+    arguments.emplace_back("--with-secret");
+  if (ctx.GetInfo().DatabasePath != "default") {
+    arguments.emplace_back("--homedir");
+    arguments.push_back(ctx.GetInfo().DatabasePath);
+  }
+  arguments.emplace_back("--list-keys");
+
+  int exit_code = -1;
+  std::string output;
+  GpgCommandExecutor::GetInstance().Execute(
+      ctx.GetInfo().AppPath, arguments,
+      [&](int p_exit_code, const std::string& p_out, const std::string&) {
+        exit_code = p_exit_code;
+        output = p_out;
+      });
+  if (exit_code != 0) {
+    SPDLOG_ERROR("failed to list the keyring, exit code: {}", exit_code);
+    return false;
+  }
+
+  std::vector<std::string> lines;
+  boost::split(lines, output, boost::is_any_of("\n"));
+
+  // a key is the records from its pub line to the next one
+  std::string fpr;
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  auto finish_key = [&]() {
+    if (!fpr.empty()) key_digests[fpr] = hash.result().toHex().toStdString();
+    fpr.clear();
+    hash.reset();
+  };
+
+  bool in_key = false;
+  for (const auto& line : lines) {
+    if (boost::starts_with(line, "pub:")) {
+      finish_key();
+      in_key = true;
+    }
+    if (!in_key) continue;
+
+    if (fpr.empty() && boost::starts_with(line, "fpr:")) {
+      std::vector<std::string> fields;
+      boost::split(fields, line, boost::is_any_of(":"));
+      if (fields.size() > 9) fpr = fields[9];
+    }
+    hash.addData(line.data(), static_cast<int>(line.size()));
+    hash.addData("\n", 1);
+  }
+  finish_key();
+  return true;
+}
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_GPGKEYRINGWATCHER_H
+#define GPGFRONTEND_GPGKEYRINGWATCHER_H
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/GpgConstants.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief watches the keyring files of the default channel, so changes made
+ * by other gpg processes reach the key cache.
+ *
+ * Bursts of changes are debounced. The keyring is then listed through the
+ * gpg binary, and only the keys whose listing changed are marked with
+ * GpgKeyGetter::MarkKeysChanged() before SignalKeyringChanged() is emitted.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT GpgKeyringWatcher : public QObject {
+  Q_OBJECT
+ public:
+  /**
+   * @brief Construct a new Gpg Keyring Watcher object, it must live in a
+   * thread running an event loop
+   *
+   * @param parent
+   */
+  explicit GpgKeyringWatcher(QObject* parent = nullptr);
+
+ signals:
+  /**
+   * @brief some keys changed, they are marked in GpgKeyGetter and only
+   * wait for GpgKeyGetter::RefreshKeyCaches()
+   *
+   */
+  void SignalKeyringChanged();
+
+ private slots:
+  /**
+   * @brief a watched path changed, restart the debounce timer
+   *
+   * @param path
+   */
+  void slot_path_changed(const QString& path);
+
+  /**
+   * @brief list the keyring in the background and mark the changed keys
+   *
+   */
+  void slot_check_keyring();
+
+ private:
+  /**
+   * @brief (re)add the keyring files, they are often replaced by renaming
+   * which drops them from the watcher
+   *
+   */
+  void watch_paths();
+
+  /**
+   * @brief list the keyring with the gpg binary
+   *
+   * @param key_digests fingerprint to a digest of the listing of the key
+   * @return false if gpg failed
+   */
+  static bool list_key_digests(
+      std::map<std::string, std::string>& key_digests);
+
+  /**
+   * @brief the last listing, shared with the check running on the gpg
+   * thread, which may outlive the watcher
+   *
+   */
+  struct KeyDigests {
+    std::mutex mutex;                            ///<
+    std::map<std::string, std::string> digests;  ///< last listing
+    bool loaded = false;                         ///<
+  };
+
+  QFileSystemWatcher* watcher_;  ///<
+  QTimer* debounce_timer_;       ///<
+  std::filesystem::path home_;   ///< gnupg home directory
+
+  std::shared_ptr<KeyDigests> key_digests_ =
+      std::make_shared<KeyDigests>();  ///<
+};
+
+}  // namespace GpgFrontend
+
+#endif  // GPGFRONTEND_GPGKEYRINGWATCHER_H
@@ -0,0 +1,317 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "GpgStatusParser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <list>
+#include <sstream>
+
+namespace {
+
+constexpr const char* kStatusPrefix = "[GNUPG:] ";
+
+/**
+ * @brief an encryption result with the storage it points into
+ *
+ */
+struct EncrResultHolder {
+  _gpgme_op_encrypt_result result = {};        ///<
+  std::list<_gpgme_invalid_key> invalid_keys;  ///<
+  std::list<std::string> strings;              ///<
+};
+
+/**
+ * @brief a decryption result with the storage it points into
+ *
+ */
+struct DecrResultHolder {
+  _gpgme_op_decrypt_result result = {};    ///<
+  std::list<_gpgme_recipient> recipients;  ///<
+  std::list<std::string> strings;          ///<
+};
+
+/**
+ * @brief undo the percent escaping of gpg status arguments
+ *
+ * @param str escaped string
+ * @return std::string
+ */
+std::string percent_unescape(const std::string& str) {
+  std::string ret;
+  ret.reserve(str.size());
+  for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] == '%' && i + 2 < str.size() &&
+        std::isxdigit(static_cast<unsigned char>(str[i + 1])) &&
+        std::isxdigit(static_cast<unsigned char>(str[i + 2]))) {
+      ret.push_back(
+          static_cast<char>(std::stoi(str.substr(i + 1, 2), nullptr, 16)));
+      i += 2;
+    } else {
+      ret.push_back(str[i]);
+    }
+  }
+  return ret;
+}
+
+/**
+ * @brief map the reason code of INV_RECP to the error gpgme reports
+ *
+ * @param reason reason code
+ * @return gpgme_error_t
+ */
+gpgme_error_t inv_recp_reason(int reason) {
+  switch (reason) {
+    case 1:
+      return gpg_error(GPG_ERR_NO_PUBKEY);
+    case 2:
+      return gpg_error(GPG_ERR_AMBIGUOUS_NAME);
+    case 3:
+      return gpg_error(GPG_ERR_WRONG_KEY_USAGE);
+    case 4:
+      return gpg_error(GPG_ERR_CERT_REVOKED);
+    case 5:
+      return gpg_error(GPG_ERR_CERT_EXPIRED);
+    case 9:
+      return gpg_error(GPG_ERR_NO_SECKEY);
+    case 10:
+      return gpg_error(GPG_ERR_NOT_TRUSTED);
+    case 13:
+      return gpg_error(GPG_ERR_KEY_DISABLED);
+    case 14:
+      return gpg_error(GPG_ERR_INV_USER_ID);
+    default:
+      return gpg_error(GPG_ERR_GENERAL);
+  }
+}
+
+/**
+ * @brief map an OpenPGP public key algorithm id to gpgme's enumeration
+ *
+ * @param algo OpenPGP algorithm id
+ * @return gpgme_pubkey_algo_t
+ */
+gpgme_pubkey_algo_t pubkey_algo(int algo) {
+  switch (algo) {
+    case 18:
+      return GPGME_PK_ECDH;
+    case 19:
+      return GPGME_PK_ECDSA;
+    case 22:
+      return GPGME_PK_EDDSA;
+    default:
+      return static_cast<gpgme_pubkey_algo_t>(algo);
+  }
+}
+
+/**
+ * @brief parse an integer argument
+ *
+ * @param str argument
+ * @return long long 0 if it is not a number
+ */
+long long to_number(const std::string& str) {
+  try {
+    return std::stoll(str);
+  } catch (...) {
+    return 0;
+  }
+}
+
+/**
+ * @brief split a status line into its keyword and arguments
+ *
+ * @param line line without its line break
+ * @param keyword status keyword
+ * @param args arguments
+ * @return false if the line is not a status line
+ */
+bool parse_status_line(std::string line, std::string& keyword,
+                       std::vector<std::string>& args) {
+  if (!line.empty() && line.back() == '\r') line.pop_back();
+  if (line.rfind(kStatusPrefix, 0) != 0) return false;
+
+  std::istringstream line_stream(line.substr(std::strlen(kStatusPrefix)));
+  line_stream >> keyword;
+  for (std::string arg; line_stream >> arg;) args.push_back(arg);
+  return true;
+}
+
+/**
+ * @brief bytes in a unit of a PROGRESS line
+ *
+ * @param unit unit, may be empty
+ * @return uint64_t
+ */
+uint64_t progress_unit_size(const std::string& unit) {
+  uint64_t size = 1;
+  for (const auto* prefix : {"KiB", "MiB", "GiB", "TiB"}) {
+    size *= 1024;
+    if (unit == prefix) return size;
+  }
+  return 1;
+}
+
+}  // namespace
+
+GpgFrontend::GpgStatusParser::GpgStatusParser(const std::string& output) {
+  std::istringstream stream(output);
+  for (std::string line; std::getline(stream, line);) {
+    StatusLine status;
+    if (parse_status_line(line, status.first, status.second))
+      lines_.push_back(std::move(status));
+  }
+}
+
+bool GpgFrontend::GpgStatusParser::ParseProgress(std::string line,
+                                                 uint64_t& current,
+                                                 uint64_t& total) {
+  if (!line.empty() && line.back() == '\n') line.pop_back();
+
+  std::string keyword;
+  std::vector<std::string> args;
+  // PROGRESS <what> <char> <cur> <total> [<units>]
+  if (!parse_status_line(line, keyword, args) || keyword != "PROGRESS" ||
+      args.size() < 4)
+    return false;
+
+  auto unit_size = progress_unit_size(args.size() >= 5 ? args[4] : "");
+  current =
+      static_cast<uint64_t>(std::max(to_number(args[2]), 0LL)) * unit_size;
+  total = static_cast<uint64_t>(std::max(to_number(args[3]), 0LL)) * unit_size;
+  return true;
+}
+
+bool GpgFrontend::GpgStatusParser::has(const std::string& keyword) const {
+  for (const auto& [line_keyword, args] : lines_) {
+    if (line_keyword == keyword) return true;
+  }
+  return false;
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgStatusParser::reported_error() const {
+  for (const auto& [keyword, args] : lines_) {
+    if ((keyword == "ERROR" || keyword == "FAILURE") && args.size() >= 2) {
+      auto err = static_cast<GpgError>(to_number(args[1]));
+      if (err != GPG_ERR_NO_ERROR) return err;
+    }
+  }
+  return GPG_ERR_NO_ERROR;
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgStatusParser::GetEncrError(
+    int exit_code) const {
+  // also catches a process that could not be started at all
+  if (exit_code == 0 && has("END_ENCRYPTION")) return GPG_ERR_NO_ERROR;
+
+  if (has("INV_RECP")) return gpg_error(GPG_ERR_UNUSABLE_PUBKEY);
+  auto err = reported_error();
+  return err != GPG_ERR_NO_ERROR ? err : gpg_error(GPG_ERR_GENERAL);
+}
+
+GpgFrontend::GpgError GpgFrontend::GpgStatusParser::GetDecrError(
+    int exit_code) const {
+  if (exit_code == 0 && has("DECRYPTION_OKAY")) return GPG_ERR_NO_ERROR;
+
+  if (has("NODATA")) return gpg_error(GPG_ERR_NO_DATA);
+  if (has("NO_SECKEY") && !has("DECRYPTION_OKAY"))
+    return gpg_error(GPG_ERR_NO_SECKEY);
+  if (has("DECRYPTION_FAILED")) return gpg_error(GPG_ERR_DECRYPT_FAILED);
+  auto err = reported_error();
+  return err != GPG_ERR_NO_ERROR ? err : gpg_error(GPG_ERR_GENERAL);
+}
+
+GpgFrontend::GpgEncrResult GpgFrontend::GpgStatusParser::GetEncrResult()
+    const {
+  auto holder = std::make_shared<EncrResultHolder>();
+
+  _gpgme_invalid_key* last = nullptr;
+  for (const auto& [keyword, args] : lines_) {
+    if (keyword != "INV_RECP" || args.empty()) continue;
+
+    auto& key = holder->invalid_keys.emplace_back();
+    key = {};
+    key.reason = inv_recp_reason(static_cast<int>(to_number(args[0])));
+    if (args.size() >= 2) {
+      key.fpr = holder->strings.emplace_back(percent_unescape(args[1])).data();
+    }
+
+    if (last == nullptr) {
+      holder->result.invalid_recipients = &key;
+    } else {
+      last->next = &key;
+    }
+    last = &key;
+  }
+
+  return {holder, &holder->result};
+}
+
+GpgFrontend::GpgDecrResult GpgFrontend::GpgStatusParser::GetDecrResult()
+    const {
+  auto holder = std::make_shared<DecrResultHolder>();
+
+  _gpgme_recipient* last = nullptr;
+  for (const auto& [keyword, args] : lines_) {
+    if (keyword == "ENC_TO" && !args.empty()) {
+      auto& recipient = holder->recipients.emplace_back();
+      recipient = {};
+      std::strncpy(recipient._keyid, args[0].c_str(),
+                   sizeof(recipient._keyid) - 1);
+      recipient.keyid = recipient._keyid;
+      if (args.size() >= 2)
+        recipient.pubkey_algo =
+            pubkey_algo(static_cast<int>(to_number(args[1])));
+
+      if (last == nullptr) {
+        holder->result.recipients = &recipient;
+      } else {
+        last->next = &recipient;
+      }
+      last = &recipient;
+    } else if (keyword == "PLAINTEXT" && args.size() >= 3) {
+      holder->result.file_name =
+          holder->strings.emplace_back(percent_unescape(args[2])).data();
+    } else if (keyword == "DECRYPTION_COMPLIANCE_MODE" && !args.empty()) {
+      holder->result.is_de_vs = args[0] == "23";
+    }
+  }
+
+  // the recipients whose secret key is missing
+  for (const auto& [keyword, args] : lines_) {
+    if (keyword != "NO_SECKEY" || args.empty()) continue;
+    for (auto& recipient : holder->recipients) {
+      if (args[0] == recipient.keyid)
+        recipient.status = gpg_error(GPG_ERR_NO_SECKEY);
+    }
+  }
+
+  return {holder, &holder->result};
+}
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_GPGSTATUSPARSER_H
+#define GPGFRONTEND_GPGSTATUSPARSER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/GpgConstants.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief turns the --status-fd output of a gpg process into the error and the
+ * result structures gpgme would have returned for the same operation, so the
+ * result analysers work on both
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT GpgStatusParser {
+ public:
+  /**
+   * @brief Construct a new Gpg Status Parser object
+   *
+   * @param output output of the process, lines not starting with "[GNUPG:] "
+   * are ignored
+   */
+  explicit GpgStatusParser(const std::string& output);
+
+  /**
+   * @brief parse a PROGRESS line, as written by a gpg process started with
+   * --enable-progress-filter
+   *
+   * @param line line of the output
+   * @param current bytes processed
+   * @param total bytes to process, 0 if unknown
+   * @return true if the line is a PROGRESS line
+   */
+  static bool ParseProgress(std::string line, uint64_t& current,
+                            uint64_t& total);
+
+  /**
+   * @brief Get the error of an encryption
+   *
+   * @param exit_code exit code of the process
+   * @return GpgError
+   */
+  [[nodiscard]] GpgError GetEncrError(int exit_code) const;
+
+  /**
+   * @brief Get the error of a decryption
+   *
+   * @param exit_code exit code of the process
+   * @return GpgError
+   */
+  [[nodiscard]] GpgError GetDecrError(int exit_code) const;
+
+  /**
+   * @brief Get the result of an encryption
+   *
+   * @return GpgEncrResult
+   */
+  [[nodiscard]] GpgEncrResult GetEncrResult() const;
+
+  /**
+   * @brief Get the result of a decryption
+   *
+   * @return GpgDecrResult
+   */
+  [[nodiscard]] GpgDecrResult GetDecrResult() const;
+
+ private:
+  using StatusLine = std::pair<std::string, std::vector<std::string>>;
+
+  std::vector<StatusLine> lines_;  ///< keyword and arguments
+
+  /**
+   * @brief
+   *
+   * @param keyword status keyword
+   * @return true if the process reported the keyword
+   */
+  [[nodiscard]] bool has(const std::string& keyword) const;
+
+  /**
+   * @brief the error code of the first ERROR or FAILURE line
+   *
+   * @return GpgError GPG_ERR_NO_ERROR if there is none
+   */
+  [[nodiscard]] GpgError reported_error() const;
+};
+
+}  // namespace GpgFrontend
+
+#endif  // GPGFRONTEND_GPGSTATUSPARSER_H
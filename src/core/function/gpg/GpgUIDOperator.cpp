@@ -28,6 +28,7 @@
 
 #include "GpgUIDOperator.h"
 
+#include "GpgKeyGetter.h"
 #include "boost/format.hpp"
 
 GpgFrontend::GpgUIDOperator::GpgUIDOperator(int channel)
@@ -36,6 +37,7 @@ GpgFrontend::GpgUIDOperator::GpgUIDOperator(int channel)
 bool GpgFrontend::GpgUIDOperator::AddUID(const GpgFrontend::GpgKey& key,
                                          const std::string& uid) {
   auto err = gpgme_op_adduid(ctx_, gpgme_key_t(key), uid.c_str(), 0);
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
   if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
     return true;
   else
@@ -46,6 +48,7 @@ bool GpgFrontend::GpgUIDOperator::RevUID(const GpgFrontend::GpgKey& key,
                                          const std::string& uid) {
   auto err =
       check_gpg_error(gpgme_op_revuid(ctx_, gpgme_key_t(key), uid.c_str(), 0));
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
   if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
     return true;
   else
@@ -56,6 +59,7 @@ bool GpgFrontend::GpgUIDOperator::SetPrimaryUID(const GpgFrontend::GpgKey& key,
                                                 const std::string& uid) {
   auto err = check_gpg_error(gpgme_op_set_uid_flag(
       ctx_, gpgme_key_t(key), uid.c_str(), "primary", nullptr));
+  GpgKeyGetter::MarkKeysChanged({key.GetFingerprint()});
   if (check_gpg_error_2_err_code(err) == GPG_ERR_NO_ERROR)
     return true;
   else
@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "GpgVerifyBatchResultAnalyse.h"
+
+#include <boost/format.hpp>
+
+#include "GpgFrontend.h"
+#include "function/gpg/GpgKeyGetter.h"
+
+GpgFrontend::GpgVerifyBatchResultAnalyse::GpgVerifyBatchResultAnalyse(
+    std::vector<GpgFileOperaItem<GpgVerifyResult>> items,
+    GpgFileOperaStats stats)
+    : items_(std::move(items)), stats_(stats) {}
+
+void GpgFrontend::GpgVerifyBatchResultAnalyse::do_analyse() {
+  stream_ << "[#] " << _("Verify Operation") << " ";
+  if (stats_.failed == 0)
+    stream_ << "[" << _("Success") << "]" << std::endl;
+  else
+    stream_ << "[" << _("Failed") << "]" << std::endl;
+
+  stream_ << "[>] "
+          << boost::format(_("%1% file(s), %2% failed, %3% ms")) %
+                 stats_.total % stats_.failed % stats_.elapsed.count()
+          << std::endl;
+
+  size_t good_count = 0;
+  for (const auto& item : items_) {
+    stream_ << std::endl << "[>] " << item.in_path << std::endl;
+
+    int file_status;
+    if (gpgme_err_code(item.error) != GPG_ERR_NO_ERROR) {
+      stream_ << "    " << _("Failed") << ": " << gpgme_strerror(item.error)
+              << std::endl;
+      file_status = -1;
+    } else if (item.result == nullptr || item.result->signatures == nullptr) {
+      stream_ << "    "
+              << _("Could not find information that can be used for "
+                   "verification.")
+              << std::endl;
+      file_status = 0;
+    } else {
+      file_status = analyse_signatures(item.result->signatures);
+    }
+
+    if (file_status > 0) good_count++;
+    set_status(file_status);
+  }
+
+  stream_ << std::endl
+          << "[>] "
+          << boost::format(_("%1% of %2% file(s) have good signatures")) %
+                 good_count % items_.size()
+          << std::endl;
+}
+
+int GpgFrontend::GpgVerifyBatchResultAnalyse::analyse_signatures(
+    gpgme_signature_t sign) {
+  int status = 1;
+  for (; sign != nullptr; sign = sign->next) {
+    auto fpr = std::string(sign->fpr == nullptr ? "" : sign->fpr);
+
+    stream_ << "    " << gpgme_strerror(sign->status);
+    if (gpg_err_code(sign->status) == GPG_ERR_NO_ERROR &&
+        !(sign->summary & GPGME_SIGSUM_VALID))
+      stream_ << " (" << _("Signature Not Fully Valid.") << ")";
+    stream_ << std::endl;
+
+    const auto& signer = get_signer(fpr);
+    stream_ << "    " << _("Signed By") << ": "
+            << (signer.empty() ? "<" + std::string(_("Unknown")) + ">"
+                               : signer)
+            << " " << GpgFrontend::beautify_fingerprint(fpr) << std::endl;
+
+    switch (gpg_err_code(sign->status)) {
+      case GPG_ERR_NO_ERROR:
+      case GPG_ERR_KEY_EXPIRED:
+        if (signer.empty()) status = std::min(status, 0);
+        break;
+      case GPG_ERR_NO_PUBKEY:
+        status = std::min(status, -2);
+        break;
+      default:
+        status = std::min(status, -1);
+    }
+  }
+  return status;
+}
+
+const std::string& GpgFrontend::GpgVerifyBatchResultAnalyse::get_signer(
+    const std::string& fpr) {
+  auto it = signers_.find(fpr);
+  if (it != signers_.end()) return it->second;
+
+  std::string uid;
+  if (!fpr.empty()) {
+    auto key = GpgFrontend::GpgKeyGetter::GetInstance().GetKey(fpr);
+    if (key.IsGood()) {
+      auto uids = key.GetUIDs();
+      // a key may come without any user id
+      if (!uids->empty()) uid = uids->front().GetUID();
+    }
+  }
+  return signers_.emplace(fpr, std::move(uid)).first->second;
+}
@@ -0,0 +1,88 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_GPGVERIFYBATCHRESULTANALYSE_H
+#define GPGFRONTEND_GPGVERIFYBATCHRESULTANALYSE_H
+
+#include <map>
+#include <vector>
+
+#include "GpgResultAnalyse.h"
+#include "core/function/gpg/GpgFileOpera.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief Analyse the results of a batch verification, one report for all the
+ * files. Every signer key is looked up only once for the whole batch.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT GpgVerifyBatchResultAnalyse
+    : public GpgResultAnalyse {
+ public:
+  /**
+   * @brief Construct a new Verify Batch Result Analyse object
+   *
+   * @param items results of the files
+   * @param stats statistics of the batch
+   */
+  explicit GpgVerifyBatchResultAnalyse(
+      std::vector<GpgFileOperaItem<GpgVerifyResult>> items,
+      GpgFileOperaStats stats);
+
+ private:
+  /**
+   * @brief
+   *
+   */
+  void do_analyse() override;
+
+  /**
+   * @brief analyse the signatures of one file
+   *
+   * @param sign first signature
+   * @return int status of the file
+   */
+  int analyse_signatures(gpgme_signature_t sign);
+
+  /**
+   * @brief Get the signer uid, the key is looked up once per fingerprint
+   *
+   * @param fpr fingerprint of the signer
+   * @return std::string empty if the key is not found
+   */
+  const std::string& get_signer(const std::string& fpr);
+
+  std::vector<GpgFileOperaItem<GpgVerifyResult>> items_;  ///<
+  GpgFileOperaStats stats_;                                ///<
+  std::map<std::string, std::string> signers_;             ///< fpr -> uid
+};
+
+}  // namespace GpgFrontend
+
+#endif  // GPGFRONTEND_GPGVERIFYBATCHRESULTANALYSE_H
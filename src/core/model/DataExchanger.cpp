@@ -0,0 +1,90 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/model/DataExchanger.h"
+
+#include <algorithm>
+#include <cstring>
+
+GpgFrontend::DataExchanger::DataExchanger(size_t size)
+    : buffer_(std::max<size_t>(size, 1)) {}
+
+ssize_t GpgFrontend::DataExchanger::Write(const char* buffer, size_t size) {
+  size_t written = 0;
+  while (written < size) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock,
+                   [this] { return size_ < buffer_.size() || read_closed_; });
+    if (read_closed_) return -1;
+
+    // copy into the free space, at most up to the end of the ring
+    auto tail = (head_ + size_) % buffer_.size();
+    auto len = std::min({size - written, buffer_.size() - size_,
+                         buffer_.size() - tail});
+    memcpy(buffer_.data() + tail, buffer + written, len);
+    size_ += len;
+    written += len;
+
+    not_empty_.notify_one();
+  }
+  return static_cast<ssize_t>(written);
+}
+
+ssize_t GpgFrontend::DataExchanger::Read(char* buffer, size_t size) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this] {
+    return size_ > 0 || write_closed_ || read_closed_;
+  });
+  if (read_closed_) return -1;
+  if (size_ == 0) return 0;
+
+  size_t read = 0;
+  while (read < size && size_ > 0) {
+    auto len = std::min({size - read, size_, buffer_.size() - head_});
+    memcpy(buffer + read, buffer_.data() + head_, len);
+    head_ = (head_ + len) % buffer_.size();
+    size_ -= len;
+    read += len;
+  }
+
+  not_full_.notify_one();
+  return static_cast<ssize_t>(read);
+}
+
+void GpgFrontend::DataExchanger::CloseWrite() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  write_closed_ = true;
+  not_empty_.notify_all();
+}
+
+void GpgFrontend::DataExchanger::CloseRead() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  read_closed_ = true;
+  not_full_.notify_all();
+  not_empty_.notify_all();
+}
@@ -0,0 +1,101 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_DATAEXCHANGER_H
+#define GPGFRONTEND_DATAEXCHANGER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "core/GpgFrontendCore.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief A bounded byte pipe between two threads, e.g. a producer pushing
+ * archive data and gpgme pulling it through a callback backed GpgData.
+ * Writes block while the pipe is full and reads block while it is empty, so
+ * the memory used is bounded by the size of the pipe.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT DataExchanger {
+ public:
+  /**
+   * @brief Construct a new Data Exchanger object
+   *
+   * @param size capacity of the pipe in bytes
+   */
+  explicit DataExchanger(size_t size);
+
+  /**
+   * @brief write all the bytes into the pipe
+   *
+   * @param buffer
+   * @param size
+   * @return ssize_t size, or -1 if the read side is closed
+   */
+  ssize_t Write(const char* buffer, size_t size);
+
+  /**
+   * @brief read at most size bytes from the pipe
+   *
+   * @param buffer
+   * @param size
+   * @return ssize_t bytes read, 0 at the end of the data, -1 if the read side
+   * is closed
+   */
+  ssize_t Read(char* buffer, size_t size);
+
+  /**
+   * @brief no more data will be written, the reader gets the end of data
+   * after the remaining bytes
+   *
+   */
+  void CloseWrite();
+
+  /**
+   * @brief no more data will be read, pending and further writes fail
+   *
+   */
+  void CloseRead();
+
+ private:
+  std::mutex mutex_;                   ///<
+  std::condition_variable not_full_;   ///<
+  std::condition_variable not_empty_;  ///<
+  std::vector<char> buffer_;           ///< ring buffer
+  size_t head_ = 0;                    ///< position of the first byte
+  size_t size_ = 0;                    ///< bytes in the ring buffer
+  bool write_closed_ = false;          ///<
+  bool read_closed_ = false;           ///<
+};
+
+}  // namespace GpgFrontend
+
+#endif  // GPGFRONTEND_DATAEXCHANGER_H
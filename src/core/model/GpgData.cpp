@@ -28,6 +28,12 @@
 
 #include "core/model/GpgData.h"
 
+#include <cerrno>
+
+struct gpgme_data_cbs GpgFrontend::GpgData::data_cbs_ = {
+    GpgFrontend::GpgData::read_cb, GpgFrontend::GpgData::write_cb,
+    GpgFrontend::GpgData::seek_cb, nullptr};
+
 GpgFrontend::GpgData::GpgData() {
   gpgme_data_t data;
 
@@ -47,32 +53,179 @@ GpgFrontend::GpgData::GpgData(void* buffer, size_t size, bool copy) {
   data_ref_ = std::unique_ptr<struct gpgme_data, _data_ref_deleter>(data);
 }
 
+GpgFrontend::GpgData::GpgData(ReadFunc read_func, WriteFunc write_func,
+                              SeekFunc seek_func)
+    : read_func_(std::move(read_func)),
+      write_func_(std::move(write_func)),
+      seek_func_(std::move(seek_func)) {
+  init_from_cbs();
+}
+
+GpgFrontend::GpgData::GpgData(const std::filesystem::path& path, bool write) {
+#ifdef WINDOWS
+  file_ = std::make_unique<QFile>(QString::fromStdU16String(path.u16string()));
+#else
+  file_ = std::make_unique<QFile>(QString::fromStdString(path.u8string()));
+#endif
+
+  if (!file_->open(write ? QIODevice::WriteOnly | QIODevice::Truncate
+                         : QIODevice::ReadOnly)) {
+    SPDLOG_ERROR("failed to open file: {}", path.u8string());
+    return;
+  }
+
+  auto* file = file_.get();
+  if (write) {
+    write_func_ = [file](const void* buffer, size_t size) -> gpgme_ssize_t {
+      auto ret = file->write(static_cast<const char*>(buffer), size);
+      if (ret < 0) errno = EIO;
+      return ret;
+    };
+  } else {
+    read_func_ = [file](void* buffer, size_t size) -> gpgme_ssize_t {
+      auto ret = file->read(static_cast<char*>(buffer), size);
+      if (ret < 0) errno = EIO;
+      return ret;
+    };
+  }
+
+  seek_func_ = [file](gpgme_off_t offset, int whence) -> gpgme_off_t {
+    qint64 base = 0;
+    switch (whence) {
+      case SEEK_SET:
+        break;
+      case SEEK_CUR:
+        base = file->pos();
+        break;
+      case SEEK_END:
+        base = file->size();
+        break;
+      default:
+        errno = EINVAL;
+        return -1;
+    }
+    if (!file->seek(base + offset)) {
+      errno = EINVAL;
+      return -1;
+    }
+    return file->pos();
+  };
+
+  init_from_cbs();
+}
+
+GpgFrontend::GpgData::GpgData(ByteArray& sink) {
+  write_func_ = [&sink](const void* buffer, size_t size) -> gpgme_ssize_t {
+    sink.append(static_cast<const char*>(buffer), size);
+    return static_cast<gpgme_ssize_t>(size);
+  };
+
+  init_from_cbs();
+}
+
+bool GpgFrontend::GpgData::IsGood() const { return data_ref_ != nullptr; }
+
+void GpgFrontend::GpgData::SetProgressFunc(ProgressFunc progress_func) {
+  progress_func_ = std::move(progress_func);
+}
+
+bool GpgFrontend::GpgData::CloseFile() {
+  if (file_ == nullptr || !file_->isOpen()) return true;
+
+  // QFile buffers the writes, a full disk may only show up here
+  bool good = file_->error() == QFileDevice::NoError && file_->flush();
+  file_->close();
+  good = good && file_->error() == QFileDevice::NoError;
+  if (!good)
+    SPDLOG_ERROR("failed to write file: {} error: {}",
+                 file_->fileName().toStdString(),
+                 file_->errorString().toStdString());
+  return good;
+}
+
+void GpgFrontend::GpgData::init_from_cbs() {
+  gpgme_data_t data;
+
+  auto err = gpgme_data_new_from_cbs(&data, &data_cbs_, this);
+  assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
+  if (gpgme_err_code(err) != GPG_ERR_NO_ERROR) return;
+
+  data_ref_ = std::unique_ptr<struct gpgme_data, _data_ref_deleter>(data);
+}
+
+gpgme_ssize_t GpgFrontend::GpgData::read_cb(void* handle, void* buffer,
+                                            size_t size) {
+  auto* data = static_cast<GpgData*>(handle);
+  if (data->read_func_ == nullptr) {
+    errno = EBADF;
+    return -1;
+  }
+  return data->report_progress(data->read_func_(buffer, size));
+}
+
+gpgme_ssize_t GpgFrontend::GpgData::write_cb(void* handle, const void* buffer,
+                                             size_t size) {
+  auto* data = static_cast<GpgData*>(handle);
+  if (data->write_func_ == nullptr) {
+    errno = EBADF;
+    return -1;
+  }
+  return data->report_progress(data->write_func_(buffer, size));
+}
+
+gpgme_ssize_t GpgFrontend::GpgData::report_progress(gpgme_ssize_t ret) {
+  if (ret <= 0 || progress_func_ == nullptr) return ret;
+  transferred_ += ret;
+  if (!progress_func_(transferred_)) {
+    errno = ECANCELED;
+    return -1;
+  }
+  return ret;
+}
+
+gpgme_off_t GpgFrontend::GpgData::seek_cb(void* handle, gpgme_off_t offset,
+                                          int whence) {
+  auto* data = static_cast<GpgData*>(handle);
+  if (data->seek_func_ == nullptr) {
+    errno = ESPIPE;
+    return -1;
+  }
+  return data->seek_func_(offset, whence);
+}
+
 /**
  * Read gpgme-Data to QByteArray
  *   mainly from http://basket.kde.org/ (kgpgme.cpp)
  */
-#define BUF_SIZE (32 * 1024)
-
 GpgFrontend::ByteArrayPtr GpgFrontend::GpgData::Read2Buffer() {
-  gpgme_off_t ret = gpgme_data_seek(*this, 0, SEEK_SET);
   ByteArrayPtr out_buffer = std::make_unique<std::string>();
 
-  if (ret) {
+  // learn the final size first, memory and file backed data can tell it
+  gpgme_off_t size = gpgme_data_seek(*this, 0, SEEK_END);
+  if (size > 0) out_buffer->resize(static_cast<size_t>(size));
+
+  if (gpgme_data_seek(*this, 0, SEEK_SET)) {
     gpgme_error_t err = gpgme_err_code_from_errno(errno);
     assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
-  } else {
-    char buf[BUF_SIZE + 2];
+    out_buffer->clear();
+    return out_buffer;
+  }
 
-    while ((ret = gpgme_data_read(*this, buf, BUF_SIZE)) > 0) {
-      const size_t size = out_buffer->size();
-      out_buffer->resize(static_cast<int>(size + ret));
-      memcpy(out_buffer->data() + size, buf, ret);
-    }
-    if (ret < 0) {
-      gpgme_error_t err = gpgme_err_code_from_errno(errno);
-      assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
-    }
+  // read straight into the output buffer, no intermediate copy
+  size_t offset = 0;
+  gpgme_ssize_t ret = 0;
+  while (offset < out_buffer->size()) {
+    ret = gpgme_data_read(*this, out_buffer->data() + offset,
+                          out_buffer->size() - offset);
+    if (ret <= 0) break;
+    offset += static_cast<size_t>(ret);
+  }
+  if (ret < 0) {
+    gpgme_error_t err = gpgme_err_code_from_errno(errno);
+    assert(gpgme_err_code(err) == GPG_ERR_NO_ERROR);
   }
+
+  out_buffer->resize(offset);
   return out_buffer;
 }
 
@@ -38,6 +38,11 @@ namespace GpgFrontend {
  */
 class GpgData {
  public:
+  using ReadFunc = std::function<gpgme_ssize_t(void*, size_t)>;         ///<
+  using WriteFunc = std::function<gpgme_ssize_t(const void*, size_t)>;  ///<
+  using SeekFunc = std::function<gpgme_off_t(gpgme_off_t, int)>;        ///<
+  using ProgressFunc = std::function<bool(uint64_t)>;                   ///<
+
   /**
    * @brief Construct a new Gpg Data object
    *
@@ -53,6 +58,74 @@ class GpgData {
    */
   GpgData(void* buffer, size_t size, bool copy = true);
 
+  /**
+   * @brief Construct a new Gpg Data object backed by callbacks, gpgme pulls
+   * data from read_func and pushes data into write_func chunk by chunk, so
+   * nothing is buffered in memory by this object.
+   *
+   * @param read_func called when gpgme reads data, return -1 on error
+   * @param write_func called when gpgme writes data, return -1 on error
+   * @param seek_func called when gpgme seeks, can be empty
+   */
+  GpgData(ReadFunc read_func, WriteFunc write_func,
+          SeekFunc seek_func = nullptr);
+
+  /**
+   * @brief Construct a new Gpg Data object backed by a file, the content of
+   * the file is streamed through callbacks instead of being loaded into memory
+   *
+   * @param path path of the file
+   * @param write create (or truncate) the file and write into it
+   */
+  GpgData(const std::filesystem::path& path, bool write);
+
+  /**
+   * @brief Construct a new Gpg Data object whose output is appended directly
+   * to a caller-owned buffer, so it never has to be copied out afterwards.
+   * The buffer must outlive this object.
+   *
+   * @param sink buffer the output is appended to
+   */
+  explicit GpgData(ByteArray& sink);
+
+  /**
+   * @brief prohibit copy and move, gpgme holds the address of this object
+   *
+   */
+  GpgData(const GpgData&) = delete;
+
+  /**
+   * @brief prohibit copy and move, gpgme holds the address of this object
+   *
+   * @return GpgData&
+   */
+  GpgData& operator=(const GpgData&) = delete;
+
+  /**
+   * @brief
+   *
+   * @return true if the underlying gpgme data object is ready
+   * @return false if the underlying file or callbacks can not be used
+   */
+  [[nodiscard]] bool IsGood() const;
+
+  /**
+   * @brief Set the function called with the number of bytes transferred so
+   * far each time gpgme reads or writes through the callbacks. Returning
+   * false aborts the operation with ECANCELED.
+   *
+   * @param progress_func
+   */
+  void SetProgressFunc(ProgressFunc progress_func);
+
+  /**
+   * @brief flush and close the file behind this data object, if any
+   *
+   * @return true if everything written reached the file
+   * @return false if writing, flushing or closing the file failed
+   */
+  bool CloseFile();
+
   /**
    * @brief
    *
@@ -61,7 +134,9 @@ class GpgData {
   operator gpgme_data_t();
 
   /**
-   * @brief
+   * @brief Read the whole content of this object into a new buffer, the size
+   * is learned up front when the data is seekable so the buffer is allocated
+   * only once.
    *
    * @return ByteArrayPtr
    */
@@ -78,8 +153,39 @@ class GpgData {
     }
   };
 
+  std::unique_ptr<QFile> file_ = nullptr;  ///< file behind this data object
+  ReadFunc read_func_ = nullptr;           ///<
+  WriteFunc write_func_ = nullptr;         ///<
+  SeekFunc seek_func_ = nullptr;           ///<
+  ProgressFunc progress_func_ = nullptr;   ///<
+  uint64_t transferred_ = 0;               ///< bytes read or written
+
+  // declared last, so it is released before the callbacks and the file
   std::unique_ptr<struct gpgme_data, _data_ref_deleter> data_ref_ =
       nullptr;  ///<
+
+  /**
+   * @brief create the gpgme data object from the callbacks above
+   *
+   */
+  void init_from_cbs();
+
+  /**
+   * @brief account the result of a read or write callback
+   *
+   * @param ret bytes transferred, or -1
+   * @return gpgme_ssize_t ret, or -1 if the progress function aborts
+   */
+  gpgme_ssize_t report_progress(gpgme_ssize_t ret);
+
+  static gpgme_ssize_t read_cb(void* handle, void* buffer, size_t size);
+
+  static gpgme_ssize_t write_cb(void* handle, const void* buffer,
+                                size_t size);
+
+  static gpgme_off_t seek_cb(void* handle, gpgme_off_t offset, int whence);
+
+  static struct gpgme_data_cbs data_cbs_;  ///< shared by all instances
 };
 
 }  // namespace GpgFrontend
@@ -28,17 +28,24 @@
 
 #include "core/model/GpgKey.h"
 
-#include <mutex>
+#include <algorithm>
 
 GpgFrontend::GpgKey::GpgKey(gpgme_key_t &&key) : key_ref_(std::move(key)) {}
 
 GpgFrontend::GpgKey::GpgKey(GpgKey &&k) noexcept { swap(key_ref_, k.key_ref_); }
 
+GpgFrontend::GpgKey::GpgKey(const GpgKey &k) : key_ref_(k.ref()) {}
+
 GpgFrontend::GpgKey &GpgFrontend::GpgKey::operator=(GpgKey &&k) noexcept {
   swap(key_ref_, k.key_ref_);
   return *this;
 }
 
+GpgFrontend::GpgKey &GpgFrontend::GpgKey::operator=(const GpgKey &k) {
+  if (this != &k) key_ref_.reset(k.ref());
+  return *this;
+}
+
 bool GpgFrontend::GpgKey::operator==(const GpgKey &o) const {
   return o.GetId() == this->GetId();
 }
@@ -149,9 +156,9 @@ bool GpgFrontend::GpgKey::IsHasAuthenticationCapability() const {
 }
 
 bool GpgFrontend::GpgKey::IsHasCardKey() const {
-  auto subkeys = GetSubKeys();
+  auto subkeys = GetSubKeysView();
   return std::any_of(
-      subkeys->begin(), subkeys->end(),
+      subkeys.begin(), subkeys.end(),
       [](const GpgSubKey &subkey) -> bool { return subkey.IsCardKey(); });
 }
 
@@ -189,9 +196,17 @@ std::unique_ptr<std::vector<GpgFrontend::GpgUID>> GpgFrontend::GpgKey::GetUIDs()
   return p_uids;
 }
 
+GpgFrontend::GpgKey::SubKeyView GpgFrontend::GpgKey::GetSubKeysView() const {
+  return SubKeyView(key_ref_->subkeys);
+}
+
+GpgFrontend::GpgKey::UIDView GpgFrontend::GpgKey::GetUIDsView() const {
+  return UIDView(key_ref_->uids);
+}
+
 bool GpgFrontend::GpgKey::IsHasActualSigningCapability() const {
-  auto subkeys = GetSubKeys();
-  if (std::any_of(subkeys->begin(), subkeys->end(),
+  auto subkeys = GetSubKeysView();
+  if (std::any_of(subkeys.begin(), subkeys.end(),
                   [](const GpgSubKey &subkey) -> bool {
                     return subkey.IsSecretKey() &&
                            subkey.IsHasSigningCapability() &&
@@ -204,8 +219,8 @@ bool GpgFrontend::GpgKey::IsHasActualSigningCapability() const {
 }
 
 bool GpgFrontend::GpgKey::IsHasActualAuthenticationCapability() const {
-  auto subkeys = GetSubKeys();
-  if (std::any_of(subkeys->begin(), subkeys->end(),
+  auto subkeys = GetSubKeysView();
+  if (std::any_of(subkeys.begin(), subkeys.end(),
                   [](const GpgSubKey &subkey) -> bool {
                     return subkey.IsSecretKey() &&
                            subkey.IsHasAuthenticationCapability() &&
@@ -232,8 +247,8 @@ bool GpgFrontend::GpgKey::IsHasActualCertificationCapability() const {
  * @return if key encrypt
  */
 bool GpgFrontend::GpgKey::IsHasActualEncryptionCapability() const {
-  auto subkeys = GetSubKeys();
-  if (std::any_of(subkeys->begin(), subkeys->end(),
+  auto subkeys = GetSubKeysView();
+  if (std::any_of(subkeys.begin(), subkeys.end(),
                   [](const GpgSubKey &subkey) -> bool {
                     return subkey.IsHasEncryptionCapability() &&
                            !subkey.IsDisabled() && !subkey.IsRevoked() &&
@@ -244,13 +259,11 @@ bool GpgFrontend::GpgKey::IsHasActualEncryptionCapability() const {
     return false;
 }
 
-GpgFrontend::GpgKey GpgFrontend::GpgKey::Copy() const {
-  {
-    const std::lock_guard<std::mutex> guard(gpgme_key_opera_mutex);
-    gpgme_key_ref(key_ref_.get());
-  }
-  auto *_new_key_ref = key_ref_.get();
-  return GpgKey(std::move(_new_key_ref));
+GpgFrontend::GpgKey GpgFrontend::GpgKey::Copy() const { return *this; }
+
+gpgme_key_t GpgFrontend::GpgKey::ref() const {
+  if (key_ref_ != nullptr) gpgme_key_ref(key_ref_.get());
+  return key_ref_.get();
 }
 
 void GpgFrontend::GpgKey::_key_ref_deleter::operator()(gpgme_key_t _key) {
@@ -29,8 +29,7 @@
 #ifndef GPGFRONTEND_GPGKEY_H
 #define GPGFRONTEND_GPGKEY_H
 
-#include <mutex>
-
+#include "GpgListView.h"
 #include "GpgSubKey.h"
 #include "GpgUID.h"
 
@@ -268,6 +267,23 @@ class GPGFRONTEND_CORE_EXPORT GpgKey {
    */
   [[nodiscard]] std::unique_ptr<std::vector<GpgUID>> GetUIDs() const;
 
+  using SubKeyView = GpgListView<GpgSubKey, gpgme_subkey_t>;  ///<
+  using UIDView = GpgListView<GpgUID, gpgme_user_id_t>;       ///<
+
+  /**
+   * @brief Get the subkeys without allocating, valid while the key lives
+   *
+   * @return SubKeyView
+   */
+  [[nodiscard]] SubKeyView GetSubKeysView() const;
+
+  /**
+   * @brief Get the user ids without allocating, valid while the key lives
+   *
+   * @return UIDView
+   */
+  [[nodiscard]] UIDView GetUIDsView() const;
+
   /**
    * @brief Construct a new Gpg Key object
    *
@@ -301,6 +317,14 @@ class GPGFRONTEND_CORE_EXPORT GpgKey {
    */
   GpgKey(GpgKey&& k) noexcept;
 
+  /**
+   * @brief Construct a new Gpg Key object sharing the same gpgme key, only
+   * its reference count is increased
+   *
+   * @param k
+   */
+  GpgKey(const GpgKey& k);
+
   /**
    * @brief
    *
@@ -309,6 +333,14 @@ class GPGFRONTEND_CORE_EXPORT GpgKey {
    */
   GpgKey& operator=(GpgKey&& k) noexcept;
 
+  /**
+   * @brief share the same gpgme key as k
+   *
+   * @param k
+   * @return GpgKey&
+   */
+  GpgKey& operator=(const GpgKey& k);
+
   /**
    * @brief
    *
@@ -343,7 +375,7 @@ class GPGFRONTEND_CORE_EXPORT GpgKey {
   explicit operator gpgme_key_t() const;
 
   /**
-   * @brief
+   * @brief same as the copy constructor
    *
    * @return GpgKey
    */
@@ -363,7 +395,12 @@ class GPGFRONTEND_CORE_EXPORT GpgKey {
 
   KeyRefHandler key_ref_ = nullptr;  ///<
 
-  mutable std::mutex gpgme_key_opera_mutex;  // mutex for gpgme key operations
+  /**
+   * @brief take a new reference of the gpgme key, gpgme does the locking
+   *
+   * @return gpgme_key_t
+   */
+  [[nodiscard]] gpgme_key_t ref() const;
 };
 
 }  // namespace GpgFrontend
@@ -0,0 +1,194 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/model/GpgKeySummaryTable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+
+void GpgFrontend::GpgKeySummaryTable::Build(
+    const std::map<std::string, KeyPtr>& keys) {
+  *this = GpgKeySummaryTable();
+
+  const auto size = keys.size();
+  keys_.reserve(size);
+  ids_.reserve(size);
+  fingerprints_.reserve(size);
+  names_.reserve(size);
+  emails_.reserve(size);
+  comments_.reserve(size);
+  flags_.reserve(size);
+  expire_times_.reserve(size);
+
+  std::unordered_map<std::string, uint32_t> interned;
+  auto intern = [&](std::string str) -> uint32_t {
+    auto it = interned.find(str);
+    if (it != interned.end()) return it->second;
+
+    auto index = static_cast<uint32_t>(strings_.size());
+    auto lower = str;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    interned.emplace(str, index);
+    strings_.push_back(std::move(str));
+    lower_strings_.push_back(std::move(lower));
+    return index;
+  };
+
+  for (const auto& [key_id, key] : keys) {
+    if (key == nullptr || !key->IsGood()) continue;
+
+    KeySummaryFlag::FlagType flags = 0;
+    if (key->IsPrivateKey()) flags |= KeySummaryFlag::SECRET;
+    if (key->IsHasMasterKey()) flags |= KeySummaryFlag::MASTER_KEY;
+    if (key->IsHasCardKey()) flags |= KeySummaryFlag::CARD_KEY;
+    if (key->IsExpired()) flags |= KeySummaryFlag::EXPIRED;
+    if (key->IsRevoked()) flags |= KeySummaryFlag::REVOKED;
+    if (key->IsDisabled()) flags |= KeySummaryFlag::DISABLED;
+    if (key->IsHasActualEncryptionCapability())
+      flags |= KeySummaryFlag::CAN_ENCRYPT;
+    if (key->IsHasActualSigningCapability()) flags |= KeySummaryFlag::CAN_SIGN;
+    if (key->IsHasActualCertificationCapability())
+      flags |= KeySummaryFlag::CAN_CERTIFY;
+    if (key->IsHasActualAuthenticationCapability())
+      flags |= KeySummaryFlag::CAN_AUTH;
+    if (key->IsHasCertificationCapability())
+      flags |= KeySummaryFlag::HAS_CERTIFY;
+    flags |= static_cast<KeySummaryFlag::FlagType>(key->GetOwnerTrustLevel())
+             << KeySummaryFlag::OWNER_TRUST_SHIFT;
+
+    keys_.push_back(key);
+    ids_.push_back(key->GetId());
+    fingerprints_.push_back(key->GetFingerprint());
+    names_.push_back(intern(key->GetName()));
+    emails_.push_back(intern(key->GetEmail()));
+    comments_.push_back(intern(key->GetComment()));
+    flags_.push_back(flags);
+    expire_times_.push_back(
+        static_cast<int64_t>(static_cast<gpgme_key_t>(*key)->subkeys->expires));
+  }
+}
+
+GpgFrontend::GpgKeySummaryTable::RowList
+GpgFrontend::GpgKeySummaryTable::Filter(
+    const std::string& keyword, KeySummaryFlag::FlagType required,
+    KeySummaryFlag::FlagType excluded) const {
+  // match every distinct string once, rows then only look up the result
+  std::vector<char> matched;
+  if (!keyword.empty()) {
+    matched.resize(lower_strings_.size());
+    for (std::size_t i = 0; i < lower_strings_.size(); i++)
+      matched[i] = lower_strings_[i].find(keyword) != std::string::npos;
+  }
+
+  RowList rows;
+  rows.reserve(flags_.size());
+  for (std::size_t row = 0; row < flags_.size(); row++) {
+    const auto flags = flags_[row];
+    if ((flags & required) != required || (flags & excluded) != 0) continue;
+    if (!keyword.empty() && !matched[names_[row]] && !matched[emails_[row]] &&
+        !matched[comments_[row]])
+      continue;
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+std::string GpgFrontend::GpgKeySummaryTable::GetOwnerTrust(
+    std::size_t row) const {
+  switch (GetOwnerTrustLevel(row)) {
+    case 0:
+      return _("Unknown");
+    case 1:
+      return _("Undefined");
+    case 2:
+      return _("Never");
+    case 3:
+      return _("Marginal");
+    case 4:
+      return _("Full");
+    case 5:
+      return _("Ultimate");
+  }
+  return "Invalid";
+}
+
+nlohmann::json GpgFrontend::GpgKeySummaryTable::ToJson() const {
+  nlohmann::json json;
+  json["ids"] = ids_;
+  json["fingerprints"] = fingerprints_;
+  json["names"] = names_;
+  json["emails"] = emails_;
+  json["comments"] = comments_;
+  json["flags"] = flags_;
+  json["expire_times"] = expire_times_;
+  json["strings"] = strings_;
+  return json;
+}
+
+bool GpgFrontend::GpgKeySummaryTable::FromJson(const nlohmann::json& json) {
+  *this = GpgKeySummaryTable();
+  try {
+    json.at("ids").get_to(ids_);
+    json.at("fingerprints").get_to(fingerprints_);
+    json.at("names").get_to(names_);
+    json.at("emails").get_to(emails_);
+    json.at("comments").get_to(comments_);
+    json.at("flags").get_to(flags_);
+    json.at("expire_times").get_to(expire_times_);
+    json.at("strings").get_to(strings_);
+  } catch (...) {
+    SPDLOG_ERROR("invalid key summary table");
+    *this = GpgKeySummaryTable();
+    return false;
+  }
+
+  const auto size = ids_.size();
+  auto valid_index = [&](uint32_t index) { return index < strings_.size(); };
+  if (fingerprints_.size() != size || names_.size() != size ||
+      emails_.size() != size || comments_.size() != size ||
+      flags_.size() != size || expire_times_.size() != size ||
+      !std::all_of(names_.begin(), names_.end(), valid_index) ||
+      !std::all_of(emails_.begin(), emails_.end(), valid_index) ||
+      !std::all_of(comments_.begin(), comments_.end(), valid_index)) {
+    SPDLOG_ERROR("inconsistent key summary table");
+    *this = GpgKeySummaryTable();
+    return false;
+  }
+
+  keys_.resize(size);
+  lower_strings_.reserve(strings_.size());
+  for (const auto& str : strings_) {
+    auto lower = str;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    lower_strings_.push_back(std::move(lower));
+  }
+  return true;
+}
@@ -0,0 +1,245 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_GPGKEYSUMMARYTABLE_H
+#define GPGFRONTEND_GPGKEYSUMMARYTABLE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "GpgKey.h"
+
+namespace GpgFrontend {
+
+/**
+ * @brief bits of the packed per key flags in GpgKeySummaryTable
+ *
+ */
+struct KeySummaryFlag {
+  using FlagType = uint32_t;
+
+  static constexpr FlagType SECRET = 1 << 0;        ///< IsPrivateKey()
+  static constexpr FlagType MASTER_KEY = 1 << 1;    ///< IsHasMasterKey()
+  static constexpr FlagType CARD_KEY = 1 << 2;      ///< IsHasCardKey()
+  static constexpr FlagType EXPIRED = 1 << 3;       ///< IsExpired()
+  static constexpr FlagType REVOKED = 1 << 4;       ///< IsRevoked()
+  static constexpr FlagType DISABLED = 1 << 5;      ///< IsDisabled()
+  static constexpr FlagType CAN_ENCRYPT = 1 << 6;   ///< actual capability
+  static constexpr FlagType CAN_SIGN = 1 << 7;      ///< actual capability
+  static constexpr FlagType CAN_CERTIFY = 1 << 8;   ///< actual capability
+  static constexpr FlagType CAN_AUTH = 1 << 9;      ///< actual capability
+  static constexpr FlagType HAS_CERTIFY = 1 << 10;  ///< key can certify
+
+  static constexpr FlagType UNUSABLE = EXPIRED | REVOKED | DISABLED;  ///<
+
+  static constexpr int OWNER_TRUST_SHIFT = 16;                       ///<
+  static constexpr FlagType OWNER_TRUST = 0x7 << OWNER_TRUST_SHIFT;  ///<
+};
+
+/**
+ * @brief a flat, column wise summary of the keys in a key cache snapshot,
+ * built once per refresh. Listing and filtering scan its columns instead of
+ * walking the gpgme linked lists of every key.
+ *
+ * Names, emails and comments are interned, so a keyword is matched once per
+ * distinct string rather than once per key.
+ *
+ * The table can be saved to and loaded from json, so the key list can be
+ * shown at startup before the keyring is enumerated. Rows loaded that way
+ * have no GpgKey.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT GpgKeySummaryTable {
+ public:
+  using KeyPtr = std::shared_ptr<const GpgKey>;  ///<
+  using RowList = std::vector<std::size_t>;      ///<
+
+  /**
+   * @brief rebuild the table from the keys
+   *
+   * @param keys key id to key
+   */
+  void Build(const std::map<std::string, KeyPtr>& keys);
+
+  /**
+   * @brief save the table, without the keys
+   *
+   * @return nlohmann::json
+   */
+  [[nodiscard]] nlohmann::json ToJson() const;
+
+  /**
+   * @brief load a table saved by ToJson(), the rows have no keys
+   *
+   * @param json
+   * @return true if the table is loaded
+   * @return false if json is not a valid table, the table is left empty
+   */
+  bool FromJson(const nlohmann::json& json);
+
+  /**
+   * @brief the rows matching all the conditions, in key id order
+   *
+   * @param keyword lower case keyword searched in the primary name, email
+   * and comment, empty to match every key
+   * @param required flags a row must all have
+   * @param excluded flags a row must have none of
+   * @return RowList
+   */
+  [[nodiscard]] RowList Filter(const std::string& keyword,
+                               KeySummaryFlag::FlagType required = 0,
+                               KeySummaryFlag::FlagType excluded = 0) const;
+
+  /**
+   * @brief
+   *
+   * @return std::size_t
+   */
+  [[nodiscard]] std::size_t Size() const { return keys_.size(); }
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @return const KeyPtr& nullptr if the row was loaded from json
+   */
+  [[nodiscard]] const KeyPtr& GetKey(std::size_t row) const {
+    return keys_[row];
+  }
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @return const std::string&
+   */
+  [[nodiscard]] const std::string& GetId(std::size_t row) const {
+    return ids_[row];
+  }
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @return const std::string&
+   */
+  [[nodiscard]] const std::string& GetFingerprint(std::size_t row) const {
+    return fingerprints_[row];
+  }
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @return const std::string&
+   */
+  [[nodiscard]] const std::string& GetName(std::size_t row) const {
+    return strings_[names_[row]];
+  }
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @return const std::string&
+   */
+  [[nodiscard]] const std::string& GetEmail(std::size_t row) const {
+    return strings_[emails_[row]];
+  }
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @return const std::string&
+   */
+  [[nodiscard]] const std::string& GetComment(std::size_t row) const {
+    return strings_[comments_[row]];
+  }
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @return KeySummaryFlag::FlagType
+   */
+  [[nodiscard]] KeySummaryFlag::FlagType GetFlags(std::size_t row) const {
+    return flags_[row];
+  }
+
+  /**
+   * @brief same as GpgKey::GetOwnerTrustLevel()
+   *
+   * @param row
+   * @return int
+   */
+  [[nodiscard]] int GetOwnerTrustLevel(std::size_t row) const {
+    return static_cast<int>((flags_[row] & KeySummaryFlag::OWNER_TRUST) >>
+                            KeySummaryFlag::OWNER_TRUST_SHIFT);
+  }
+
+  /**
+   * @brief same as GpgKey::GetOwnerTrust()
+   *
+   * @param row
+   * @return std::string
+   */
+  [[nodiscard]] std::string GetOwnerTrust(std::size_t row) const;
+
+  /**
+   * @brief
+   *
+   * @param row
+   * @return int64_t seconds since epoch, 0 if the key never expires
+   */
+  [[nodiscard]] int64_t GetExpireTime(std::size_t row) const {
+    return expire_times_[row];
+  }
+
+ private:
+  std::vector<KeyPtr> keys_;                     ///<
+  std::vector<std::string> ids_;                 ///<
+  std::vector<std::string> fingerprints_;        ///<
+  std::vector<uint32_t> names_;                  ///< index in strings_
+  std::vector<uint32_t> emails_;                 ///< index in strings_
+  std::vector<uint32_t> comments_;               ///< index in strings_
+  std::vector<KeySummaryFlag::FlagType> flags_;  ///<
+  std::vector<int64_t> expire_times_;            ///<
+
+  std::vector<std::string> strings_;        ///< interned strings
+  std::vector<std::string> lower_strings_;  ///< strings_ in lower case
+};
+
+}  // namespace GpgFrontend
+
+#endif  // GPGFRONTEND_GPGKEYSUMMARYTABLE_H
@@ -0,0 +1,164 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_GPGLISTVIEW_H
+#define GPGFRONTEND_GPGLISTVIEW_H
+
+#include <cstddef>
+#include <iterator>
+
+namespace GpgFrontend {
+
+/**
+ * @brief a non-owning range over a gpgme linked list (subkeys, user ids...).
+ * Iterating it allocates nothing, each element is wrapped on the fly.
+ *
+ * The view is only valid while the key owning the list is alive.
+ *
+ * @tparam T wrapper type, constructible from Node
+ * @tparam Node gpgme list node pointer, having a next member
+ */
+template <typename T, typename Node>
+class GpgListView {
+ public:
+  /**
+   * @brief forward iterator yielding the wrappers by value
+   *
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;  ///<
+    using value_type = T;                                 ///<
+    using difference_type = std::ptrdiff_t;               ///<
+    using pointer = void;                                 ///<
+    using reference = T;                                  ///<
+
+    /**
+     * @brief Construct a new Iterator object
+     *
+     * @param node
+     */
+    explicit Iterator(Node node = nullptr) : node_(node) {}
+
+    /**
+     * @brief
+     *
+     * @return T
+     */
+    T operator*() const { return T(node_); }
+
+    /**
+     * @brief
+     *
+     * @return Iterator&
+     */
+    Iterator& operator++() {
+      node_ = node_->next;
+      return *this;
+    }
+
+    /**
+     * @brief
+     *
+     * @return Iterator
+     */
+    Iterator operator++(int) {
+      auto it = *this;
+      node_ = node_->next;
+      return it;
+    }
+
+    /**
+     * @brief
+     *
+     * @param o
+     * @return true
+     * @return false
+     */
+    bool operator==(const Iterator& o) const { return node_ == o.node_; }
+
+    /**
+     * @brief
+     *
+     * @param o
+     * @return true
+     * @return false
+     */
+    bool operator!=(const Iterator& o) const { return node_ != o.node_; }
+
+   private:
+    Node node_;  ///<
+  };
+
+  /**
+   * @brief Construct a new Gpg List View object
+   *
+   * @param head first node of the list, may be nullptr
+   */
+  explicit GpgListView(Node head) : head_(head) {}
+
+  /**
+   * @brief
+   *
+   * @return Iterator
+   */
+  [[nodiscard]] Iterator begin() const { return Iterator(head_); }
+
+  /**
+   * @brief
+   *
+   * @return Iterator
+   */
+  [[nodiscard]] Iterator end() const { return Iterator(); }
+
+  /**
+   * @brief
+   *
+   * @return true
+   * @return false
+   */
+  [[nodiscard]] bool empty() const { return head_ == nullptr; }
+
+  /**
+   * @brief walks the list
+   *
+   * @return std::size_t
+   */
+  [[nodiscard]] std::size_t size() const {
+    std::size_t count = 0;
+    for (auto node = head_; node != nullptr; node = node->next) ++count;
+    return count;
+  }
+
+ private:
+  Node head_;  ///<
+};
+
+}  // namespace GpgFrontend
+
+#endif  // GPGFRONTEND_GPGLISTVIEW_H
@@ -46,8 +46,9 @@ void GpgFrontend::Thread::CtxCheckTask::Run() {
   if (!GpgContext::GetInstance().good()) {
     emit SignalGnupgNotInstall();
   }
-  // Try flushing key cache
-  else
+  // Try loading the key cache saved on disk, the main window refreshes it
+  // once shown. Otherwise flush it now.
+  else if (!GpgFrontend::GpgKeyGetter::GetInstance().LoadKeyCache())
     GpgFrontend::GpgKeyGetter::GetInstance().FlushKeyCache();
 
   SPDLOG_DEBUG("ctx check task runnable done");
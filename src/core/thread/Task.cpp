@@ -30,6 +30,8 @@
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <functional>
+#include <new>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -37,6 +39,20 @@
 
 const std::string GpgFrontend::Thread::Task::DEFAULT_TASK_NAME = "default-task";
 
+namespace {
+/// the task whose runnable is running on this thread
+thread_local GpgFrontend::Thread::Task *current_task = nullptr;
+
+/// minimal interval between two SignalTaskProgress
+constexpr auto kProgressInterval = std::chrono::milliseconds(200);
+
+/// the calling thread as a number, for the trace
+std::uint64_t current_thread_id() {
+  return static_cast<std::uint64_t>(
+      reinterpret_cast<std::uintptr_t>(QThread::currentThreadId()));
+}
+}  // namespace
+
 GpgFrontend::Thread::Task::Task(std::string name)
     : uuid_(generate_uuid()), name_(name) {
   SPDLOG_TRACE("task {}/ created", GetFullID());
@@ -90,6 +106,79 @@ std::string GpgFrontend::Thread::Task::GetUUID() const { return uuid_; }
 
 bool GpgFrontend::Thread::Task::GetSequency() const { return sequency_; }
 
+GpgFrontend::Thread::Task *GpgFrontend::Thread::Task::GetCurrentTask() {
+  return current_task;
+}
+
+void GpgFrontend::Thread::Task::Cancel() {
+  SPDLOG_DEBUG("task {} cancelled", GetFullID());
+  cancellation_token_->Cancel();
+}
+
+bool GpgFrontend::Thread::Task::IsCancelled() const {
+  return cancellation_token_->IsCancelled();
+}
+
+void GpgFrontend::Thread::Task::SetCancelHandler(
+    std::function<void()> handler) {
+  cancellation_token_->SetHandler(std::move(handler));
+}
+
+GpgFrontend::Thread::Task::CancellationTokenPtr
+GpgFrontend::Thread::Task::GetCancellationToken() const {
+  return cancellation_token_;
+}
+
+void GpgFrontend::Thread::Task::SetPriority(TaskPriority priority) {
+  priority_ = priority;
+}
+
+GpgFrontend::Thread::Task::TaskPriority
+GpgFrontend::Thread::Task::GetPriority() const {
+  return priority_;
+}
+
+void GpgFrontend::Thread::Task::CancellationToken::Cancel() {
+  cancelled_ = true;
+  std::lock_guard<std::mutex> lock(handler_lock_);
+  if (handler_) handler_();
+}
+
+bool GpgFrontend::Thread::Task::CancellationToken::IsCancelled() const {
+  return cancelled_;
+}
+
+void GpgFrontend::Thread::Task::CancellationToken::SetHandler(
+    std::function<void()> handler) {
+  std::lock_guard<std::mutex> lock(handler_lock_);
+  handler_ = std::move(handler);
+  if (cancelled_ && handler_) handler_();
+}
+
+void GpgFrontend::Thread::Task::UpdateProgress(uint64_t processed,
+                                               uint64_t total) {
+  using namespace std::chrono;
+  auto now = steady_clock::now();
+  double elapsed = 0;
+  {
+    std::lock_guard<std::mutex> lock(progress_lock_);
+    if (progress_begin_ == steady_clock::time_point{}) progress_begin_ = now;
+    // always let the last update through
+    if (now - progress_last_ < kProgressInterval && processed != total) return;
+    progress_last_ = now;
+    elapsed = duration<double>(now - progress_begin_).count();
+  }
+
+  double speed = elapsed > 0 ? static_cast<double>(processed) / elapsed : 0;
+  qint64 eta = -1;
+  if (total > processed && speed > 0) {
+    eta = static_cast<qint64>(static_cast<double>(total - processed) / speed);
+  } else if (total != 0 && total <= processed) {
+    eta = 0;
+  }
+  emit SignalTaskProgress(processed, total, speed, eta);
+}
+
 void GpgFrontend::Thread::Task::SetFinishAfterRun(
     bool run_callback_after_runnable_finished) {
   this->run_callback_after_runnable_finished_ =
@@ -102,6 +191,55 @@ void GpgFrontend::Thread::Task::init() {
   // after runnable finished, running callback
   connect(this, &Task::SignalTaskRunnableEnd, this,
           &Task::slot_task_run_callback);
+  // connected first, recorded before anyone deletes the task
+  connect(
+      this, &Task::SignalTaskEnd, this, [this]() { record_trace(); },
+      Qt::DirectConnection);
+}
+
+void GpgFrontend::Thread::Task::trace_posted(std::string runner) {
+  if (!TaskTracer::GetInstance().IsEnabled()) return;
+  trace_.posted = std::chrono::steady_clock::now();
+  trace_.runner = std::move(runner);
+}
+
+void GpgFrontend::Thread::Task::run_traced() {
+  if (!TaskTracer::GetInstance().IsEnabled()) {
+    Run();
+    return;
+  }
+
+  trace_.run_thread = current_thread_id();
+  trace_.run_thread_name = QThread::currentThread()->objectName().toStdString();
+  trace_.run_begin = std::chrono::steady_clock::now();
+  try {
+    Run();
+  } catch (...) {
+    trace_.run_end = std::chrono::steady_clock::now();
+    throw;
+  }
+  trace_.run_end = std::chrono::steady_clock::now();
+}
+
+void GpgFrontend::Thread::Task::trace_callback_begin() {
+  if (!TaskTracer::GetInstance().IsEnabled()) return;
+  trace_.callback_thread = current_thread_id();
+  trace_.callback_thread_name =
+      QThread::currentThread()->objectName().toStdString();
+  trace_.callback_begin = std::chrono::steady_clock::now();
+}
+
+void GpgFrontend::Thread::Task::record_trace() {
+  auto &tracer = TaskTracer::GetInstance();
+  if (!tracer.IsEnabled()) return;
+
+  trace_.ended = std::chrono::steady_clock::now();
+  trace_.name = name_;
+  trace_.uuid = uuid_;
+  trace_.priority = priority_;
+  trace_.cancelled =
+      IsCancelled() && trace_.run_begin == TaskTraceRecord::TimePoint{};
+  tracer.Record(trace_);
 }
 
 void GpgFrontend::Thread::Task::slot_task_run_callback(int rtn) {
@@ -116,7 +254,10 @@ void GpgFrontend::Thread::Task::slot_task_run_callback(int rtn) {
         if (!QMetaObject::invokeMethod(callback_thread_,
                                        [callback = callback_, rtn = rtn_,
                                         data_object = data_object_, this]() {
+                                         trace_callback_begin();
                                          callback(rtn, data_object);
+                                         trace_.callback_end =
+                                             std::chrono::steady_clock::now();
                                          // do cleaning work
                                          emit SignalTaskEnd();
                                        })) {
@@ -128,8 +269,12 @@ void GpgFrontend::Thread::Task::slot_task_run_callback(int rtn) {
         // waiting for callback to finish
         if (!QMetaObject::invokeMethod(
                 callback_thread_,
-                [callback = callback_, rtn = rtn_,
-                 data_object = data_object_]() { callback(rtn, data_object); },
+                [callback = callback_, rtn = rtn_, data_object = data_object_,
+                 this]() {
+                  trace_callback_begin();
+                  callback(rtn, data_object);
+                  trace_.callback_end = std::chrono::steady_clock::now();
+                },
                 Qt::BlockingQueuedConnection)) {
           SPDLOG_ERROR("failed to invoke callback");
         }
@@ -153,7 +298,7 @@ void GpgFrontend::Thread::Task::run() {
   auto runnable_package = [=, id = GetFullID()]() {
     SPDLOG_DEBUG("task {} runnable start runing", id);
     // Run() will set rtn by itself
-    Run();
+    run_traced();
     // raise signal to anounce after runnable returned
     if (run_callback_after_runnable_finished_) emit SignalTaskRunnableEnd(rtn_);
   };
@@ -184,42 +329,79 @@ void GpgFrontend::Thread::Task::SlotRun() { run(); }
 
 void GpgFrontend::Thread::Task::Run() {
   if (runnable_) {
-    SetRTN(runnable_(data_object_));
+    auto *last_task = current_task;
+    current_task = this;
+    try {
+      SetRTN(runnable_(data_object_));
+    } catch (...) {
+      current_task = last_task;
+      throw;
+    }
+    current_task = last_task;
   } else {
     SPDLOG_WARN("no runnable in task, do callback operation");
   }
 }
 
-GpgFrontend::Thread::Task::DataObject::Destructor *
-GpgFrontend::Thread::Task::DataObject::get_heap_ptr(size_t bytes_size) {
-  Destructor *dstr_ptr = new Destructor();
-  dstr_ptr->p_obj = malloc(bytes_size);
-  return dstr_ptr;
+GpgFrontend::Thread::Task::DataObject::~DataObject() {
+  if (!entries_.empty())
+    SPDLOG_WARN("data object is not empty, objects left: {}, address: {}",
+                entries_.size(), static_cast<void *>(this));
+  while (!entries_.empty()) release(true);
 }
 
-GpgFrontend::Thread::Task::DataObject::~DataObject() {
-  if (!data_objects_.empty())
-    SPDLOG_WARN("data_objects_ is not empty",
-                "address:", static_cast<void *>(this));
-  while (!data_objects_.empty()) {
-    free_heap_ptr(data_objects_.top());
-    data_objects_.pop();
+size_t GpgFrontend::Thread::Task::DataObject::GetObjectSize() {
+  return entries_.size();
+}
+
+void *GpgFrontend::Thread::Task::DataObject::allocate(std::size_t size,
+                                                      std::size_t align) {
+  Entry entry{nullptr, buffer_top_, 0, nullptr, nullptr};
+
+  // the buffer itself is aligned to max_align_t, so aligning the offset is
+  // enough for every type that is not over aligned
+  auto offset = (buffer_top_ + align - 1) & ~(align - 1);
+  if (align <= alignof(std::max_align_t) && offset <= kInlineBufferSize &&
+      size <= kInlineBufferSize - offset) {
+    entry.ptr = buffer_ + offset;
+    buffer_top_ = offset + size;
+  } else {
+    SPDLOG_TRACE("object of {} bytes doesn't fit in the buffer, address: {}",
+                 size, static_cast<void *>(this));
+    entry.ptr = ::operator new(size, std::align_val_t(align));
+    entry.heap_align = align;
   }
+
+  entries_.push_back(entry);
+  return entry.ptr;
 }
 
-size_t GpgFrontend::Thread::Task::DataObject::GetObjectSize() {
-  return data_objects_.size();
+void GpgFrontend::Thread::Task::DataObject::commit(const std::type_info &type,
+                                                   void (*destroy)(void *)) {
+  auto &entry = entries_.back();
+  entry.type = &type;
+  entry.destroy = destroy;
+}
+
+void *GpgFrontend::Thread::Task::DataObject::top(const std::type_info &type) {
+  if (entries_.empty()) throw std::runtime_error("No object to pop");
+  const auto &entry = entries_.back();
+  if (*entry.type != type) {
+    SPDLOG_ERROR("data object type mismatch, stored: {}, requested: {}",
+                 entry.type->name(), type.name());
+    throw std::runtime_error("Object type mismatch");
+  }
+  return entry.ptr;
 }
 
-void GpgFrontend::Thread::Task::DataObject::free_heap_ptr(Destructor *ptr) {
-  SPDLOG_TRACE("p_obj: {} data object: {}",
-               static_cast<const void *>(ptr->p_obj),
-               static_cast<void *>(this));
-  if (ptr->destroy != nullptr) {
-    ptr->destroy(ptr->p_obj);
+void GpgFrontend::Thread::Task::DataObject::release(bool destroy) {
+  auto entry = entries_.back();
+  entries_.pop_back();
+  if (destroy && entry.destroy != nullptr) entry.destroy(entry.ptr);
+  if (entry.heap_align != 0) {
+    ::operator delete(entry.ptr, std::align_val_t(entry.heap_align));
   }
-  free(const_cast<void *>(ptr->p_obj));
-  delete ptr;
+  buffer_top_ = entry.buffer_top;
 }
 
 std::string GpgFrontend::Thread::Task::generate_uuid() {
@@ -29,18 +29,26 @@
 #ifndef GPGFRONTEND_TASK_H
 #define GPGFRONTEND_TASK_H
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
-#include <stack>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 
+#include <boost/container/small_vector.hpp>
+
 #include "core/GpgFrontendCore.h"
+#include "core/thread/TaskTracer.h"
 
 namespace GpgFrontend::Thread {
 
 class TaskRunner;
+class TaskPool;
 
 class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
   Q_OBJECT
@@ -49,22 +57,117 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
   using DataObjectPtr = std::shared_ptr<DataObject>;             ///<
   using TaskRunnable = std::function<int(DataObjectPtr)>;        ///<
   using TaskCallback = std::function<void(int, DataObjectPtr)>;  ///<
+  class CancellationToken;
+  using CancellationTokenPtr = std::shared_ptr<CancellationToken>;  ///<
+
+  /**
+   * @brief priority classes, a runner starts the queued tasks of a higher
+   * class first and keeps the order within a class
+   *
+   */
+  enum TaskPriority {
+    kTaskPriority_Interactive,  ///< the user is waiting for it
+    kTaskPriority_Normal,       ///<
+    kTaskPriority_Background,   ///< maintenance, e.g. refreshing the keys
+  };
+  static constexpr int kTaskPriorityCount = 3;  ///<
 
   static const std::string DEFAULT_TASK_NAME;
 
   friend class TaskRunner;
+  friend class TaskPool;
+
+  /**
+   * @brief the cancel state of a task, it can be shared to cancel or poll
+   * the task without keeping the task alive
+   *
+   */
+  class GPGFRONTEND_CORE_EXPORT CancellationToken {
+   public:
+    /**
+     * @brief ask to stop, the handler is called. It is safe to call from
+     * any thread.
+     *
+     */
+    void Cancel();
+
+    /**
+     * @brief
+     *
+     * @return true if Cancel() has been called
+     */
+    [[nodiscard]] bool IsCancelled() const;
+
+    /**
+     * @brief Set the handler called by Cancel(), it is called at once if
+     * the token is already cancelled
+     *
+     * @param handler nullptr to remove the handler
+     */
+    void SetHandler(std::function<void()> handler);
+
+   private:
+    std::atomic_bool cancelled_ = false;  ///<
+    std::mutex handler_lock_;             ///<
+    std::function<void()> handler_;       ///<
+  };
 
   /**
    * @brief DataObject to be passed to the callback function.
    *
+   * Objects are kept as a stack. Small objects are placed in a buffer inside
+   * the data object itself, bigger ones fall back to the heap. Every object
+   * remembers its type, so popping it as another type throws instead of
+   * reading garbage.
    */
   class GPGFRONTEND_CORE_EXPORT DataObject {
    public:
-    struct Destructor {
-      const void *p_obj;
-      void (*destroy)(const void *);
+    static constexpr std::size_t kInlineBufferSize = 256;  ///<
+    static constexpr std::size_t kInlineEntries = 8;       ///<
+
+    /**
+     * @brief A fixed list of types passed through a data object as one
+     * object, the producer and the consumer sharing the same alias can't
+     * disagree on the order or the types of the values.
+     *
+     * @tparam Ts
+     */
+    template <typename... Ts>
+    class Layout {
+     public:
+      using Tuple = std::tuple<Ts...>;  ///<
+
+      /**
+       * @brief Append the values to the data object
+       *
+       * @param data_object
+       * @param values
+       */
+      static void Append(DataObject &data_object, Ts... values) {
+        data_object.AppendObject(Tuple(std::move(values)...));
+      }
+
+      /**
+       * @brief Pop the values appended by Append()
+       *
+       * @param data_object
+       * @return Tuple
+       */
+      static Tuple Pop(DataObject &data_object) {
+        return data_object.PopObject<Tuple>();
+      }
     };
 
+    /**
+     * @brief Construct a new Data Object object
+     *
+     */
+    DataObject() = default;
+
+    DataObject(const DataObject &) = delete;
+
+    DataObject &operator=(const DataObject &) = delete;
+
     /**
      * @brief Get the Objects Size
      *
@@ -80,20 +183,17 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
      */
     template <typename T>
     void AppendObject(T &&obj) {
+      using Type = std::decay_t<T>;
       SPDLOG_TRACE("append object: {}", static_cast<void *>(this));
-      auto *obj_dstr = this->get_heap_ptr(sizeof(T));
-      new ((void *)obj_dstr->p_obj) T(std::forward<T>(obj));
-
-      if (std::is_class_v<T>) {
-        auto destructor = [](const void *x) {
-          static_cast<const T *>(x)->~T();
-        };
-        obj_dstr->destroy = destructor;
-      } else {
-        obj_dstr->destroy = nullptr;
+      void *ptr = this->allocate(sizeof(Type), alignof(Type));
+      try {
+        new (ptr) Type(std::forward<T>(obj));
+      } catch (...) {
+        this->release(false);
+        throw;
       }
-
-      data_objects_.push(obj_dstr);
+      this->commit(typeid(Type),
+                   [](void *x) { static_cast<Type *>(x)->~Type(); });
     }
 
     /**
@@ -104,36 +204,21 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
      */
     template <typename T>
     void AppendObject(T *obj) {
-      SPDLOG_TRACE("called: {}", static_cast<void *>(this));
-      auto *obj_dstr = this->get_heap_ptr(sizeof(T));
-      auto *ptr_heap = new ((void *)obj_dstr->p_obj) T(std::move(*obj));
-      if (std::is_class_v<T>) {
-        SPDLOG_TRACE("is class");
-        auto destructor = [](const void *x) {
-          static_cast<const T *>(x)->~T();
-        };
-        obj_dstr->destroy = destructor;
-      } else {
-        obj_dstr->destroy = nullptr;
-      }
-      data_objects_.push(std::move(obj_dstr));
+      AppendObject(std::move(*obj));
     }
 
     /**
      * @brief
      *
      * @tparam T
-     * @return std::shared_ptr<T>
+     * @return T
      */
     template <typename T>
     T PopObject() {
       SPDLOG_TRACE("pop object: {}", static_cast<void *>(this));
-      if (data_objects_.empty()) throw std::runtime_error("No object to pop");
-      auto *obj_dstr = data_objects_.top();
-      auto *heap_ptr = (T *)obj_dstr->p_obj;
-      auto obj = std::move(*(T *)(heap_ptr));
-      this->free_heap_ptr(obj_dstr);
-      data_objects_.pop();
+      auto *ptr = static_cast<T *>(this->top(typeid(T)));
+      auto obj = std::move(*ptr);
+      this->release(true);
       return obj;
     }
 
@@ -144,22 +229,53 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
     ~DataObject();
 
    private:
-    std::stack<Destructor *> data_objects_;  ///<
+    /**
+     * @brief an object in the data object
+     *
+     */
+    struct Entry {
+      void *ptr;                   ///< where the object lives
+      std::size_t buffer_top;      ///< buffer top before the allocation
+      std::size_t heap_align;      ///< 0 if the object lives in the buffer
+      void (*destroy)(void *);     ///<
+      const std::type_info *type;  ///<
+    };
+
+    alignas(std::max_align_t) unsigned char buffer_[kInlineBufferSize];  ///<
+    std::size_t buffer_top_ = 0;                                         ///<
+    boost::container::small_vector<Entry, kInlineEntries> entries_;      ///<
 
     /**
-     * @brief Get the heap ptr object
+     * @brief reserve memory for a new object on top of the stack
      *
-     * @param bytes_size
+     * @param size
+     * @param align
      * @return void*
      */
-    Destructor *get_heap_ptr(size_t bytes_size);
+    void *allocate(std::size_t size, std::size_t align);
 
     /**
-     * @brief
+     * @brief record the type of the object constructed by the last allocate
+     *
+     * @param type
+     * @param destroy
+     */
+    void commit(const std::type_info &type, void (*destroy)(void *));
+
+    /**
+     * @brief get the object on top of the stack, checking its type
+     *
+     * @param type
+     * @return void*
+     */
+    void *top(const std::type_info &type);
+
+    /**
+     * @brief free the object on top of the stack
      *
-     * @param heap_ptr
+     * @param destroy whether the object was constructed
      */
-    void free_heap_ptr(Destructor *);
+    void release(bool destroy);
   };
 
   /**
@@ -219,6 +335,67 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
    */
   bool GetSequency() const;
 
+  /**
+   * @brief Get the task whose runnable is running on the calling thread
+   *
+   * @return Task* nullptr if there is none
+   */
+  static Task *GetCurrentTask();
+
+  /**
+   * @brief ask the task to stop, the cancel handler set by the runnable is
+   * called. It is safe to call from any thread.
+   *
+   */
+  void Cancel();
+
+  /**
+   * @brief
+   *
+   * @return true if Cancel() has been called
+   */
+  [[nodiscard]] bool IsCancelled() const;
+
+  /**
+   * @brief Set the handler called by Cancel(), e.g. to abort a gpg
+   * operation. It is called at once if the task is already cancelled.
+   *
+   * @param handler nullptr to remove the handler
+   */
+  void SetCancelHandler(std::function<void()> handler);
+
+  /**
+   * @brief Get the cancellation token, a runner drops the task without
+   * running it if the token is cancelled before the task starts
+   *
+   * @return CancellationTokenPtr
+   */
+  [[nodiscard]] CancellationTokenPtr GetCancellationToken() const;
+
+  /**
+   * @brief Set the priority class, before the task is posted
+   *
+   * @param priority
+   */
+  void SetPriority(TaskPriority priority);
+
+  /**
+   * @brief Get the priority class
+   *
+   * @return TaskPriority
+   */
+  [[nodiscard]] TaskPriority GetPriority() const;
+
+  /**
+   * @brief report the progress of the runnable, SignalTaskProgress is raised
+   * with the speed and the estimated remaining time, at most a few times per
+   * second.
+   *
+   * @param processed bytes processed
+   * @param total bytes in total, 0 if unknown
+   */
+  void UpdateProgress(uint64_t processed, uint64_t total);
+
  public slots:
 
   /**
@@ -240,6 +417,17 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
    */
   void SignalTaskEnd();
 
+  /**
+   * @brief progress of the runnable
+   *
+   * @param processed bytes processed
+   * @param total bytes in total, 0 if unknown
+   * @param speed bytes per second
+   * @param eta estimated remaining seconds, -1 if unknown
+   */
+  void SignalTaskProgress(quint64 processed, quint64 total, double speed,
+                          qint64 eta);
+
  protected:
   /**
    * @brief Set the Finish After Run object
@@ -266,12 +454,45 @@ class GPGFRONTEND_CORE_EXPORT Task : public QObject, public QRunnable {
   QThread *callback_thread_ = nullptr;                ///<
   DataObjectPtr data_object_ = nullptr;               ///<
 
+  TaskPriority priority_ = kTaskPriority_Normal;          ///<
+  const CancellationTokenPtr cancellation_token_ =
+      std::make_shared<CancellationToken>();  ///< cancel state, shareable
+  std::mutex progress_lock_;                              ///<
+  std::chrono::steady_clock::time_point progress_begin_;  ///<
+  std::chrono::steady_clock::time_point progress_last_;   ///<
+  TaskTraceRecord trace_;                                 ///<
+
   /**
    * @brief
    *
    */
   void init();
 
+  /**
+   * @brief stamp the time it is posted to a runner
+   *
+   * @param runner object name of the runner
+   */
+  void trace_posted(std::string runner);
+
+  /**
+   * @brief Run() with its begin and end stamped
+   *
+   */
+  void run_traced();
+
+  /**
+   * @brief stamp the start of the callback on the calling thread
+   *
+   */
+  void trace_callback_begin();
+
+  /**
+   * @brief hand the trace to the tracer, at SignalTaskEnd
+   *
+   */
+  void record_trace();
+
   /**
    * @brief
    *
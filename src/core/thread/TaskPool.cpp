@@ -0,0 +1,212 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/thread/TaskPool.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "core/thread/Task.h"
+#include "spdlog/spdlog.h"
+
+namespace {
+/// the pool of the worker running on this thread
+thread_local const GpgFrontend::Thread::TaskPool *current_pool = nullptr;
+
+/// the index of the worker running on this thread
+thread_local std::size_t current_worker = 0;
+}  // namespace
+
+GpgFrontend::Thread::TaskPool::TaskPool(int workers) {
+  if (workers <= 0)
+    workers = static_cast<int>(std::thread::hardware_concurrency());
+  // a blocked task should not stall the whole pool
+  workers = std::max(workers, 2);
+
+  for (int i = 0; i < workers; i++) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+
+  for (std::size_t i = 0; i < queues_.size(); i++) {
+    auto *worker = QThread::create([this, i]() { run_worker(i); });
+    worker->setObjectName(QString("TaskPoolWorker-%1").arg(i));
+    workers_.push_back(worker);
+    worker->start();
+  }
+  SPDLOG_DEBUG("task pool started, workers: {}", workers_.size());
+}
+
+GpgFrontend::Thread::TaskPool::~TaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    stopped_ = true;
+  }
+  idle_cv_.notify_all();
+
+  for (auto *worker : workers_) {
+    worker->wait();
+    delete worker;
+  }
+
+  for (auto &queue : queues_) {
+    for (auto &tasks : queue->tasks) {
+      for (auto *task : tasks) {
+        SPDLOG_WARN("task dropped by stopped pool: {}", task->GetFullID());
+        delete task;
+      }
+    }
+  }
+}
+
+void GpgFrontend::Thread::TaskPool::PostTask(Task *task) {
+  if (task == nullptr) {
+    SPDLOG_ERROR("task posted is null");
+    return;
+  }
+
+  SPDLOG_TRACE("post task to pool: {}", task->GetFullID());
+
+  // let the worker taking it pull it into its thread
+  task->setParent(nullptr);
+  task->moveToThread(nullptr);
+
+  // a worker keeps its own tasks, the others are spread over the workers
+  auto index = current_pool == this
+                   ? current_worker
+                   : next_queue_.fetch_add(1) % queues_.size();
+
+  // counted before queued, a worker never takes an uncounted task
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    pending_++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks[task->GetPriority()].push_back(task);
+  }
+  idle_cv_.notify_one();
+}
+
+std::size_t GpgFrontend::Thread::TaskPool::GetWorkerCount() const {
+  return workers_.size();
+}
+
+void GpgFrontend::Thread::TaskPool::run_worker(std::size_t index) {
+  current_pool = this;
+  current_worker = index;
+
+  SPDLOG_TRACE("task pool worker {} running, thread id: {}", index,
+               QThread::currentThreadId());
+  while (auto *task = take_task(index)) run_task(task);
+}
+
+GpgFrontend::Thread::Task *GpgFrontend::Thread::TaskPool::take_task(
+    std::size_t index) {
+  while (true) {
+    if (auto *task = pop_task(index)) return task;
+
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cv_.wait(lock, [this]() { return stopped_ || pending_ > 0; });
+    if (stopped_) return nullptr;
+  }
+}
+
+GpgFrontend::Thread::Task *GpgFrontend::Thread::TaskPool::pop_task(
+    std::size_t index) {
+  for (int priority = 0; priority < Task::kTaskPriorityCount; priority++) {
+    // the newest task of its own, its data is most likely still in cache
+    {
+      auto &tasks = queues_[index]->tasks[priority];
+      std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+      if (!tasks.empty()) {
+        auto *task = tasks.back();
+        tasks.pop_back();
+        pending_--;
+        return task;
+      }
+    }
+
+    // the oldest task of another worker
+    for (std::size_t i = 1; i < queues_.size(); i++) {
+      auto &queue = *queues_[(index + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      auto &tasks = queue.tasks[priority];
+      if (!tasks.empty()) {
+        auto *task = tasks.front();
+        tasks.pop_front();
+        pending_--;
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void GpgFrontend::Thread::TaskPool::run_task(Task *task) {
+  // posted without thread affinity, so it can be pulled in here
+  task->moveToThread(QThread::currentThread());
+
+  if (task->IsCancelled()) {
+    SPDLOG_DEBUG("drop task cancelled before it started: {}",
+                 task->GetFullID());
+    // no callback, but whoever waits for the task gets its end
+    emit task->SignalTaskEnd();
+    delete task;
+    return;
+  }
+
+  SPDLOG_TRACE("running task {} in pool", task->GetFullID());
+
+  QEventLoop looper;
+  bool ended = false;
+  QObject::connect(task, &Task::SignalTaskEnd, &looper, [&]() {
+    ended = true;
+    looper.quit();
+  });
+
+  try {
+    task->run_traced();
+    // raise signal to anounce after runnable returned
+    if (task->run_callback_after_runnable_finished_)
+      emit task->SignalTaskRunnableEnd(task->rtn_);
+  } catch (const std::exception &e) {
+    SPDLOG_ERROR("task pool: exception in task {}, exception: {}",
+                 task->GetFullID(), e.what());
+    ended = true;
+  } catch (...) {
+    SPDLOG_ERROR("task pool: unknown exception in task: {}",
+                 task->GetFullID());
+    ended = true;
+  }
+
+  // the callback runs on this thread or the runnable ends later, e.g. on a
+  // network reply, both need the events of this thread
+  if (!ended) looper.exec();
+
+  delete task;
+}
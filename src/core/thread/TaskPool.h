@@ -0,0 +1,143 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_TASKPOOL_H
+#define GPGFRONTEND_TASKPOOL_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/GpgFrontendCore.h"
+#include "core/thread/Task.h"
+
+namespace GpgFrontend::Thread {
+
+/**
+ * @brief a fixed set of warm worker threads running concurrent tasks. Every
+ * worker owns a deque per priority class, takes its newest task first and
+ * steals the oldest task of another worker once its own deque is empty. No
+ * task is taken while a task of a higher class is queued anywhere.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT TaskPool {
+ public:
+  /**
+   * @brief Construct a new Task Pool object, the workers are started at once
+   *
+   * @param workers number of workers, 0 means one per cpu core
+   */
+  explicit TaskPool(int workers = 0);
+
+  /**
+   * @brief Destroy the Task Pool object, waits for the running tasks and
+   * drops the queued ones
+   *
+   */
+  ~TaskPool();
+
+  /**
+   * @brief queue a task, it is run on one of the workers. A task posted from
+   * a worker goes to the deque of that worker.
+   *
+   * @param task
+   */
+  void PostTask(Task* task);
+
+  /**
+   * @brief Get the number of workers
+   *
+   * @return std::size_t
+   */
+  [[nodiscard]] std::size_t GetWorkerCount() const;
+
+ private:
+  /**
+   * @brief the tasks queued on one worker
+   *
+   */
+  struct WorkerQueue {
+    std::mutex mutex;  ///< guards tasks
+
+    /**
+     * @brief one deque per priority class, newest at the back
+     *
+     */
+    std::array<std::deque<Task*>, Task::kTaskPriorityCount> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;  ///< one per worker
+  std::vector<QThread*> workers_;                     ///< the worker threads
+  std::atomic<std::size_t> next_queue_{0};            ///< for the outside posts
+
+  std::mutex idle_mutex_;                ///< guards the wait of idle workers
+  std::condition_variable idle_cv_;      ///< wakes the idle workers
+  std::atomic<std::size_t> pending_{0};  ///< tasks queued, not taken yet
+  bool stopped_ = false;                 ///< guarded by idle_mutex_
+
+  /**
+   * @brief the loop of a worker
+   *
+   * @param index index of the worker
+   */
+  void run_worker(std::size_t index);
+
+  /**
+   * @brief wait for a task
+   *
+   * @param index index of the worker
+   * @return Task* nullptr if the pool is stopped
+   */
+  Task* take_task(std::size_t index);
+
+  /**
+   * @brief take a task of the worker, or steal one of another worker, of
+   * the highest priority class queued
+   *
+   * @param index index of the worker
+   * @return Task* nullptr if no task is queued
+   */
+  Task* pop_task(std::size_t index);
+
+  /**
+   * @brief run a task on the calling worker and delete it once it ends, a
+   * cancelled task only gets its end
+   *
+   * @param task
+   */
+  static void run_task(Task* task);
+};
+
+}  // namespace GpgFrontend::Thread
+
+#endif  // GPGFRONTEND_TASKPOOL_H
@@ -27,9 +27,12 @@
 #include "core/thread/TaskRunner.h"
 
 #include "core/thread/Task.h"
+#include "core/thread/TaskPool.h"
 #include "spdlog/spdlog.h"
 
-GpgFrontend::Thread::TaskRunner::TaskRunner() = default;
+GpgFrontend::Thread::TaskRunner::TaskRunner(TaskPool* pool,
+                                            TaskScheduler* scheduler)
+    : task_pool_(pool), task_scheduler_(scheduler) {}
 
 GpgFrontend::Thread::TaskRunner::~TaskRunner() = default;
 
@@ -40,82 +43,147 @@ void GpgFrontend::Thread::TaskRunner::PostTask(Task* task) {
   }
 
   SPDLOG_TRACE("post task: {}", task->GetFullID());
+  task->trace_posted(objectName().toStdString());
+
+  // concurrent tasks reuse the warm workers of the pool
+  if (task_pool_ != nullptr && !task->GetSequency()) {
+    task_pool_->PostTask(task);
+    return;
+  }
 
   task->setParent(nullptr);
   task->moveToThread(this);
 
   {
     std::lock_guard<std::mutex> lock(tasks_mutex_);
-    tasks.push(task);
+    tasks[task->GetPriority()].push(task);
   }
   quit();
 }
 
+void GpgFrontend::Thread::TaskRunner::PostTask(Task* task,
+                                               Task::TaskPriority priority) {
+  if (task != nullptr) task->SetPriority(priority);
+  PostTask(task);
+}
+
 void GpgFrontend::Thread::TaskRunner::PostScheduleTask(Task* task,
                                                        size_t seconds) {
-  if (task == nullptr) return;
-  // TODO
+  if (task == nullptr) {
+    SPDLOG_ERROR("task posted is null");
+    return;
+  }
+
+  if (task_scheduler_ == nullptr) {
+    SPDLOG_ERROR("no scheduler, post task at once: {}", task->GetFullID());
+    PostTask(task);
+    return;
+  }
+
+  // the driver thread pulls it into its thread once it is due
+  task->setParent(nullptr);
+  task->moveToThread(nullptr);
+
+  task_scheduler_->Schedule(
+      std::chrono::seconds(seconds), {},
+      [this, task]() {
+        task->moveToThread(QThread::currentThread());
+        PostTask(task);
+      },
+      [task]() { delete task; });
+}
+
+GpgFrontend::Thread::TaskScheduler::TimerId
+GpgFrontend::Thread::TaskRunner::PostScheduleTask(
+    Task::TaskRunnable runnable, std::string name,
+    std::chrono::milliseconds delay, std::chrono::milliseconds interval,
+    const std::string& coalesce_key, bool sequency) {
+  if (task_scheduler_ == nullptr) {
+    SPDLOG_ERROR("no scheduler, cannot schedule task: {}", name);
+    return 0;
+  }
+
+  SPDLOG_DEBUG("schedule task: {} delay: {}ms interval: {}ms", name,
+               delay.count(), interval.count());
+
+  return task_scheduler_->Schedule(
+      delay, interval,
+      [this, runnable = std::move(runnable), name = std::move(name),
+       sequency]() {
+        // without a callback, there is no callback thread to wait for
+        PostTask(new Task(runnable, name, nullptr, Task::TaskCallback{},
+                          sequency),
+                 Task::kTaskPriority_Background);
+      },
+      nullptr, coalesce_key);
+}
+
+bool GpgFrontend::Thread::TaskRunner::CancelScheduleTask(
+    TaskScheduler::TimerId timer_id) {
+  if (task_scheduler_ == nullptr) return false;
+  return task_scheduler_->Cancel(timer_id);
 }
 
 [[noreturn]] void GpgFrontend::Thread::TaskRunner::run() {
   SPDLOG_TRACE("task runner runing, thread id: {}", QThread::currentThreadId());
   while (true) {
-    if (tasks.empty()) {
+    Task* task = nullptr;
+    bool cancelled = false;
+    {
+      std::lock_guard<std::mutex> lock(tasks_mutex_);
+      task = pop_task();
+      // cancelled while queued, it never starts
+      cancelled = task != nullptr && task->IsCancelled();
+      if (task != nullptr && !cancelled)
+        pending_tasks_.insert({task->GetUUID(), task});
+    }
+
+    if (task == nullptr) {
       SPDLOG_TRACE("no tasks to run, trapping into event loop...");
       exec();
+    } else if (cancelled) {
+      drop_cancelled_task(task);
     } else {
-      SPDLOG_TRACE("start to run task(s), queue size: {}", tasks.size());
-
-      Task* task = nullptr;
-      {
-        std::lock_guard<std::mutex> lock(tasks_mutex_);
-        task = std::move(tasks.front());
-        tasks.pop();
-        pending_tasks_.insert({task->GetUUID(), task});
-      }
+      try {
+        // triger
+        SPDLOG_TRACE("running task {}, sequency: {}", task->GetFullID(),
+                     task->GetSequency());
 
-      if (task != nullptr) {
-        try {
-          // triger
-          SPDLOG_TRACE("running task {}, sequency: {}", task->GetFullID(),
-                       task->GetSequency());
-
-          // when a signal SignalTaskEnd raise, do unregister work
-          connect(task, &Task::SignalTaskEnd, this, [this, task]() {
-            unregister_finished_task(task->GetUUID());
-          });
-
-          if (!task->GetSequency()) {
-            // if it need to run concurrently, we should create a new thread to
-            // run it.
-            auto* concurrent_thread = new QThread(nullptr);
-            task->setParent(nullptr);
-            task->moveToThread(concurrent_thread);
-            // start thread
-            concurrent_thread->start();
-
-            connect(task, &Task::SignalTaskEnd, concurrent_thread,
-                    &QThread::quit);
-            // concurrent thread is responsible for deleting the task
-            connect(concurrent_thread, &QThread::finished, task,
-                    &Task::deleteLater);
-          }
-
-          // run the task
-          task->run();
-        } catch (const std::exception& e) {
-          SPDLOG_ERROR("task runner: exception in task {}, exception: {}",
-                       task->GetFullID(), e.what());
-          // if any exception caught, destroy the task, remove the task from the
-          // pending tasks
-          unregister_finished_task(task->GetUUID());
-        } catch (...) {
-          SPDLOG_ERROR("task runner: unknown exception in task: {}",
-                       task->GetFullID());
-          // if any exception caught, destroy the task, remove the task from the
-          // pending tasks
+        // when a signal SignalTaskEnd raise, do unregister work
+        connect(task, &Task::SignalTaskEnd, this, [this, task]() {
           unregister_finished_task(task->GetUUID());
+        });
+
+        if (!task->GetSequency()) {
+          // if it need to run concurrently, we should create a new thread to
+          // run it.
+          auto* concurrent_thread = new QThread(nullptr);
+          task->setParent(nullptr);
+          task->moveToThread(concurrent_thread);
+          // start thread
+          concurrent_thread->start();
+
+          connect(task, &Task::SignalTaskEnd, concurrent_thread,
+                  &QThread::quit);
+          // concurrent thread is responsible for deleting the task
+          connect(concurrent_thread, &QThread::finished, task,
+                  &Task::deleteLater);
         }
+
+        // run the task
+        task->run();
+      } catch (const std::exception& e) {
+        SPDLOG_ERROR("task runner: exception in task {}, exception: {}",
+                     task->GetFullID(), e.what());
+        // if any exception caught, destroy the task, remove the task from the
+        // pending tasks
+        unregister_finished_task(task->GetUUID());
+      } catch (...) {
+        SPDLOG_ERROR("task runner: unknown exception in task: {}",
+                     task->GetFullID());
+        // if any exception caught, destroy the task, remove the task from the
+        // pending tasks
+        unregister_finished_task(task->GetUUID());
       }
     }
   }
@@ -128,13 +196,14 @@ void GpgFrontend::Thread::TaskRunner::PostScheduleTask(Task* task,
 void GpgFrontend::Thread::TaskRunner::unregister_finished_task(
     std::string task_uuid) {
   SPDLOG_DEBUG("cleaning task {}", task_uuid);
+  // the map is filled by the runner thread, this is called on another one
+  std::lock_guard<std::mutex> lock(tasks_mutex_);
   // search in map
   auto pending_task = pending_tasks_.find(task_uuid);
   if (pending_task == pending_tasks_.end()) {
     SPDLOG_ERROR("cannot find task in pending list: {}", task_uuid);
     return;
   } else {
-    std::lock_guard<std::mutex> lock(tasks_mutex_);
     // if thread runs sequenctly, that means the thread is living in this
     // thread, so we can delete it. Or, its living thread need to delete it.
     if (pending_task->second->GetSequency())
@@ -144,3 +213,20 @@ void GpgFrontend::Thread::TaskRunner::unregister_finished_task(
 
   SPDLOG_DEBUG("clean task {} done", task_uuid);
 }
+
+GpgFrontend::Thread::Task* GpgFrontend::Thread::TaskRunner::pop_task() {
+  for (auto& queue : tasks) {
+    if (queue.empty()) continue;
+    auto* task = queue.front();
+    queue.pop();
+    return task;
+  }
+  return nullptr;
+}
+
+void GpgFrontend::Thread::TaskRunner::drop_cancelled_task(Task* task) {
+  SPDLOG_DEBUG("drop task cancelled before it started: {}", task->GetFullID());
+  // no callback, but whoever waits for the task gets its end
+  emit task->SignalTaskEnd();
+  task->deleteLater();
+}
@@ -27,15 +27,19 @@
 #ifndef GPGFRONTEND_TASKRUNNER_H
 #define GPGFRONTEND_TASKRUNNER_H
 
+#include <array>
+#include <chrono>
 #include <cstddef>
 #include <mutex>
 #include <queue>
 
 #include "core/GpgFrontendCore.h"
+#include "core/thread/Task.h"
+#include "core/thread/TaskScheduler.h"
 
 namespace GpgFrontend::Thread {
 
-class Task;
+class TaskPool;
 
 class GPGFRONTEND_CORE_EXPORT TaskRunner : public QThread {
   Q_OBJECT
@@ -43,8 +47,12 @@ class GPGFRONTEND_CORE_EXPORT TaskRunner : public QThread {
   /**
    * @brief Construct a new Task Runner object
    *
+   * @param pool runs the non-sequency tasks on its warm workers, nullptr to
+   * give each of them a new thread
+   * @param scheduler times the scheduled tasks, nullptr to post them at once
    */
-  TaskRunner();
+  explicit TaskRunner(TaskPool* pool = nullptr,
+                      TaskScheduler* scheduler = nullptr);
 
   /**
    * @brief Destroy the Task Runner object
@@ -61,31 +69,88 @@ class GPGFRONTEND_CORE_EXPORT TaskRunner : public QThread {
  public slots:
 
   /**
-   * @brief
+   * @brief queue a task behind the queued tasks of its priority class, a
+   * task cancelled while queued is dropped without running
    *
    * @param task
    */
   void PostTask(Task* task);
 
   /**
-   * @brief
+   * @brief queue a task in a priority class
+   *
+   * @param task
+   * @param priority
+   */
+  void PostTask(Task* task, Task::TaskPriority priority);
+
+  /**
+   * @brief post a task after a delay
    *
    * @param task
    * @param seconds
    */
   void PostScheduleTask(Task* task, size_t seconds);
 
+ public:
+  /**
+   * @brief post a new task running the runnable after a delay, and then
+   * every interval, in the background priority class
+   *
+   * @param runnable
+   * @param name name of the tasks
+   * @param delay
+   * @param interval 0 to post it once
+   * @param coalesce_key if not empty and a schedule with this key is
+   * pending, nothing is scheduled and the pending one is returned
+   * @param sequency whether the tasks run in order on this runner
+   * @return TaskScheduler::TimerId to cancel the schedule, 0 on failure
+   */
+  TaskScheduler::TimerId PostScheduleTask(
+      Task::TaskRunnable runnable, std::string name,
+      std::chrono::milliseconds delay, std::chrono::milliseconds interval = {},
+      const std::string& coalesce_key = {}, bool sequency = true);
+
+  /**
+   * @brief stop a schedule, the tasks already posted still run
+   *
+   * @param timer_id
+   * @return true if the schedule was pending
+   */
+  bool CancelScheduleTask(TaskScheduler::TimerId timer_id);
+
  private:
-  std::queue<Task*> tasks;                      ///< The task queue
+  /**
+   * @brief The task queues, one per priority class
+   *
+   */
+  std::array<std::queue<Task*>, Task::kTaskPriorityCount> tasks;
   std::map<std::string, Task*> pending_tasks_;  ///< The pending tasks
   std::mutex tasks_mutex_;                      ///< The task queue mutex
   QThreadPool thread_pool_{this};               ///< run non-sequency task
+  TaskPool* task_pool_ = nullptr;               ///< run non-sequency task
+  TaskScheduler* task_scheduler_ = nullptr;     ///< time scheduled task
 
   /**
    * @brief
    *
    */
   void unregister_finished_task(std::string);
+
+  /**
+   * @brief take the first task of the highest priority class, tasks_mutex_
+   * must be held
+   *
+   * @return Task* nullptr if no task is queued
+   */
+  Task* pop_task();
+
+  /**
+   * @brief end a task cancelled before it started, without running it
+   *
+   * @param task
+   */
+  static void drop_cancelled_task(Task* task);
 };
 }  // namespace GpgFrontend::Thread
 
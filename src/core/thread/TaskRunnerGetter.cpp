@@ -32,15 +32,56 @@ GpgFrontend::Thread::TaskRunnerGetter::TaskRunnerGetter(int channel)
 GpgFrontend::Thread::TaskRunner*
 GpgFrontend::Thread::TaskRunnerGetter::GetTaskRunner(
     TaskRunnerType runner_type) {
+  std::lock_guard<std::mutex> lock(task_runners_lock_);
   while (true) {
     auto it = task_runners_.find(runner_type);
     if (it != task_runners_.end()) {
       return it->second;
     } else {
-      auto runner = new TaskRunner();
+      if (is_pooled(runner_type) && task_pool_ == nullptr)
+        task_pool_ = new TaskPool();
+      if (task_scheduler_ == nullptr) task_scheduler_ = new TaskScheduler();
+      auto runner = new TaskRunner(
+          is_pooled(runner_type) ? task_pool_ : nullptr, task_scheduler_);
+      // names the thread and the runner in the task traces
+      runner->setObjectName(QString::fromStdString(
+          "TaskRunner-" + get_runner_name(runner_type)));
       task_runners_[runner_type] = runner;
       runner->start();
       continue;
     }
   }
 }
+
+bool GpgFrontend::Thread::TaskRunnerGetter::is_pooled(
+    TaskRunnerType runner_type) {
+  switch (runner_type) {
+    case kTaskRunnerType_Default:
+    case kTaskRunnerType_IO:
+    case kTaskRunnerType_Network:
+    case kTaskRunnerType_External_Process:
+      return true;
+    // gpgme contexts are not thread safe, keep the gpg tasks apart
+    case kTaskRunnerType_GPG:
+    default:
+      return false;
+  }
+}
+
+std::string GpgFrontend::Thread::TaskRunnerGetter::get_runner_name(
+    TaskRunnerType runner_type) {
+  switch (runner_type) {
+    case kTaskRunnerType_Default:
+      return "Default";
+    case kTaskRunnerType_GPG:
+      return "GPG";
+    case kTaskRunnerType_IO:
+      return "IO";
+    case kTaskRunnerType_Network:
+      return "Network";
+    case kTaskRunnerType_External_Process:
+      return "External_Process";
+    default:
+      return std::to_string(runner_type);
+  }
+}
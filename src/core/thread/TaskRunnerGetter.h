@@ -29,6 +29,7 @@
 
 #include "core/GpgFrontendCore.h"
 #include "core/GpgFunctionObject.h"
+#include "core/thread/TaskPool.h"
 #include "core/thread/TaskRunner.h"
 
 namespace GpgFrontend::Thread {
@@ -51,6 +52,26 @@ class GPGFRONTEND_CORE_EXPORT TaskRunnerGetter
 
  private:
   std::map<TaskRunnerType, TaskRunner *> task_runners_;
+  TaskPool *task_pool_ = nullptr;            ///< shared by the pooled runners
+  TaskScheduler *task_scheduler_ = nullptr;  ///< shared by all the runners
+  std::mutex task_runners_lock_;  ///< guards the runners, pool and scheduler
+
+  /**
+   * @brief whether the runner type runs its non-sequency tasks on the task
+   * pool instead of a new thread per task
+   *
+   * @param runner_type
+   * @return true if it is opted into the pool
+   */
+  static bool is_pooled(TaskRunnerType runner_type);
+
+  /**
+   * @brief readable name of the runner type
+   *
+   * @param runner_type
+   * @return std::string
+   */
+  static std::string get_runner_name(TaskRunnerType runner_type);
 };
 
 }  // namespace GpgFrontend::Thread
@@ -0,0 +1,278 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/thread/TaskScheduler.h"
+
+#include <algorithm>
+
+#include "spdlog/spdlog.h"
+
+namespace {
+/// slots of every level, as bits: 256 ticks in the lowest, then 64 each
+constexpr int kLevelBits[] = {8, 6, 6, 6};
+
+/// the ticks covered by a slot of every level, as bits
+constexpr int kLevelShift[] = {0, 8, 14, 20};
+
+/// timers further away are parked in the top level until they come closer
+constexpr uint64_t kMaxDistance = (uint64_t(1) << 26) - 1;
+
+/**
+ * @brief the slot of a tick in a level
+ *
+ * @param level
+ * @param tick
+ * @return std::size_t
+ */
+std::size_t slot_of(int level, uint64_t tick) {
+  return static_cast<std::size_t>((tick >> kLevelShift[level]) &
+                                  ((uint64_t(1) << kLevelBits[level]) - 1));
+}
+}  // namespace
+
+GpgFrontend::Thread::TaskScheduler::TaskScheduler(Duration tick)
+    : tick_(tick), start_(std::chrono::steady_clock::now()) {
+  for (int level = 0; level < kLevels; level++) {
+    wheel_[level].resize(std::size_t(1) << kLevelBits[level]);
+  }
+
+  driver_ = QThread::create([this]() { run_driver(); });
+  driver_->setObjectName("TaskSchedulerDriver");
+  driver_->start();
+}
+
+GpgFrontend::Thread::TaskScheduler::~TaskScheduler() {
+  std::vector<TimerCallback> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    for (auto& [timer_id, timer] : timers_) {
+      if (timer.on_cancel) cancelled.push_back(std::move(timer.on_cancel));
+    }
+    timers_.clear();
+  }
+  cv_.notify_all();
+
+  driver_->wait();
+  delete driver_;
+
+  for (auto& on_cancel : cancelled) on_cancel();
+}
+
+GpgFrontend::Thread::TaskScheduler::TimerId
+GpgFrontend::Thread::TaskScheduler::Schedule(Duration delay,
+                                             Duration interval,
+                                             TimerCallback callback,
+                                             TimerCallback on_cancel,
+                                             const std::string& coalesce_key) {
+  auto to_ticks = [this](Duration duration) -> uint64_t {
+    return static_cast<uint64_t>(
+        std::max<Duration::rep>((duration + tick_ - Duration(1)) / tick_, 1));
+  };
+
+  TimerId timer_id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!coalesce_key.empty()) {
+      auto it = coalesce_keys_.find(coalesce_key);
+      if (it != coalesce_keys_.end()) return it->second;
+    }
+
+    auto now_tick = tick_of(std::chrono::steady_clock::now());
+    // nothing to cascade, skip the ticks the driver slept through
+    if (timers_.empty() && now_tick > current_tick_) {
+      for (auto& level : wheel_) {
+        for (auto& slot : level) slot.clear();
+      }
+      current_tick_ = now_tick;
+    }
+
+    Timer timer;
+    // counted from now, the driver may lag behind a little while sleeping
+    timer.expire = now_tick + to_ticks(delay);
+    timer.interval = interval.count() > 0 ? to_ticks(interval) : 0;
+    timer.callback = std::move(callback);
+    timer.on_cancel = std::move(on_cancel);
+    timer.coalesce_key = coalesce_key;
+
+    timer_id = next_timer_id_++;
+    place(timer_id, timer);
+    timers_.emplace(timer_id, std::move(timer));
+    if (!coalesce_key.empty()) coalesce_keys_[coalesce_key] = timer_id;
+  }
+
+  // the driver may have to wake earlier than it planned
+  cv_.notify_one();
+  return timer_id;
+}
+
+bool GpgFrontend::Thread::TaskScheduler::Cancel(TimerId timer_id) {
+  TimerCallback on_cancel;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // its callback may capture what the caller is about to destroy
+    if (QThread::currentThread() != driver_) {
+      running_cv_.wait(lock, [&]() { return running_ != timer_id; });
+    }
+
+    auto it = timers_.find(timer_id);
+    if (it == timers_.end()) return false;
+
+    if (!it->second.coalesce_key.empty())
+      coalesce_keys_.erase(it->second.coalesce_key);
+    on_cancel = std::move(it->second.on_cancel);
+    // its id stays in the wheel until its slot comes due
+    timers_.erase(it);
+  }
+
+  if (on_cancel) on_cancel();
+  return true;
+}
+
+uint64_t GpgFrontend::Thread::TaskScheduler::tick_of(
+    std::chrono::steady_clock::time_point time_point) const {
+  return static_cast<uint64_t>((time_point - start_) / tick_);
+}
+
+void GpgFrontend::Thread::TaskScheduler::place(TimerId timer_id,
+                                               const Timer& timer) {
+  // due now, it is taken in the same pass, right after the cascade
+  auto expire = std::max(timer.expire, current_tick_);
+  auto distance = std::min(expire - current_tick_, kMaxDistance);
+
+  int level = 0;
+  while (level < kLevels - 1 &&
+         distance >> (kLevelShift[level] + kLevelBits[level]) != 0) {
+    level++;
+  }
+  wheel_[level][slot_of(level, current_tick_ + distance)].push_back(timer_id);
+}
+
+void GpgFrontend::Thread::TaskScheduler::advance(
+    uint64_t tick, std::vector<TimerId>& fired) {
+  while (current_tick_ < tick) {
+    current_tick_++;
+
+    // from the top, a timer cascaded from a level may land in the next one
+    for (int level = kLevels - 1; level > 0; level--) {
+      auto mask = (uint64_t(1) << kLevelShift[level]) - 1;
+      if ((current_tick_ & mask) != 0) continue;
+
+      auto timer_ids = std::move(wheel_[level][slot_of(level, current_tick_)]);
+      wheel_[level][slot_of(level, current_tick_)].clear();
+      for (auto timer_id : timer_ids) {
+        auto it = timers_.find(timer_id);
+        if (it != timers_.end()) place(timer_id, it->second);
+      }
+    }
+
+    auto timer_ids = std::move(wheel_[0][slot_of(0, current_tick_)]);
+    wheel_[0][slot_of(0, current_tick_)].clear();
+    for (auto timer_id : timer_ids) {
+      auto it = timers_.find(timer_id);
+      if (it == timers_.end()) continue;
+
+      auto& timer = it->second;
+      // parked in the top level for more than one round
+      if (timer.expire > current_tick_) {
+        place(timer_id, timer);
+        continue;
+      }
+
+      fired.push_back(timer_id);
+      if (timer.interval != 0) {
+        timer.expire = current_tick_ + timer.interval;
+        place(timer_id, timer);
+      }
+    }
+  }
+}
+
+uint64_t GpgFrontend::Thread::TaskScheduler::next_wake_tick() const {
+  // the lowest level only holds the timers up to the next cascade
+  auto cascade_tick =
+      (current_tick_ | ((uint64_t(1) << kLevelBits[0]) - 1)) + 1;
+  for (auto tick = current_tick_ + 1; tick < cascade_tick; tick++) {
+    if (!wheel_[0][slot_of(0, tick)].empty()) return tick;
+  }
+  return cascade_tick;
+}
+
+void GpgFrontend::Thread::TaskScheduler::run_driver() {
+  SPDLOG_TRACE("task scheduler driver running, thread id: {}",
+               QThread::currentThreadId());
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopped_) {
+    if (timers_.empty()) {
+      cv_.wait(lock, [this]() { return stopped_ || !timers_.empty(); });
+      continue;
+    }
+
+    // woken earlier by a new timer, the wake tick is worked out again
+    auto wake_time =
+        start_ + tick_ * static_cast<Duration::rep>(next_wake_tick());
+    cv_.wait_until(lock, wake_time);
+    if (stopped_) break;
+
+    std::vector<TimerId> fired;
+    advance(tick_of(std::chrono::steady_clock::now()), fired);
+
+    for (auto timer_id : fired) {
+      // cancelled meanwhile, e.g. by the callback before it
+      auto it = timers_.find(timer_id);
+      if (it == timers_.end()) continue;
+
+      TimerCallback callback;
+      auto& timer = it->second;
+      if (timer.interval != 0) {
+        callback = timer.callback;
+      } else {
+        // fired for the last time
+        callback = std::move(timer.callback);
+        if (!timer.coalesce_key.empty())
+          coalesce_keys_.erase(timer.coalesce_key);
+        timers_.erase(it);
+      }
+
+      // the callbacks may add or cancel timers
+      running_ = timer_id;
+      lock.unlock();
+      try {
+        callback();
+      } catch (const std::exception& e) {
+        SPDLOG_ERROR("exception in timer callback: {}", e.what());
+      } catch (...) {
+        SPDLOG_ERROR("unknown exception in timer callback");
+      }
+      lock.lock();
+      running_ = 0;
+      running_cv_.notify_all();
+    }
+  }
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_TASKSCHEDULER_H
+#define GPGFRONTEND_TASKSCHEDULER_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/GpgFrontendCore.h"
+
+namespace GpgFrontend::Thread {
+
+/**
+ * @brief delayed and periodic timers on a hierarchical timer wheel, driven
+ * by one thread for all of them. Deadlines are rounded up to ticks of
+ * 100ms, the timers due in the same tick fire together.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT TaskScheduler {
+ public:
+  using TimerId = uint64_t;                         ///< 0 is never used
+  using Duration = std::chrono::milliseconds;       ///<
+  using TimerCallback = std::function<void()>;      ///<
+  static constexpr Duration kTick = Duration(100);  ///< wheel resolution
+
+  /**
+   * @brief Construct a new Task Scheduler object, the driver thread is
+   * started at once
+   *
+   * @param tick resolution of the wheel, only smaller than kTick in tests
+   */
+  explicit TaskScheduler(Duration tick = kTick);
+
+  /**
+   * @brief Destroy the Task Scheduler object, the pending timers are
+   * cancelled
+   *
+   */
+  ~TaskScheduler();
+
+  /**
+   * @brief add a timer, its callback is called on the driver thread and
+   * must return quickly, e.g. by posting a task
+   *
+   * @param delay time before the first call
+   * @param interval time between the following calls, 0 to call it once
+   * @param callback
+   * @param on_cancel called instead if the timer is cancelled before it
+   * fired for the last time, e.g. to free what the callback owns
+   * @param coalesce_key if not empty and a timer with this key is pending,
+   * no timer is added and the pending one is returned
+   * @return TimerId
+   */
+  TimerId Schedule(Duration delay, Duration interval, TimerCallback callback,
+                   TimerCallback on_cancel = nullptr,
+                   const std::string& coalesce_key = {});
+
+  /**
+   * @brief cancel a timer, it is safe to call from a timer callback. Once it
+   * returns, the callback of the timer is neither running nor called again,
+   * unless it is called from that callback itself.
+   *
+   * @param timer_id
+   * @return true if the timer was pending
+   */
+  bool Cancel(TimerId timer_id);
+
+ private:
+  static constexpr int kLevels = 4;  ///< levels of the wheel
+
+  /**
+   * @brief a pending timer
+   *
+   */
+  struct Timer {
+    uint64_t expire = 0;       ///< tick to fire at
+    uint64_t interval = 0;     ///< ticks between the calls, 0 for once
+    TimerCallback callback;    ///<
+    TimerCallback on_cancel;   ///<
+    std::string coalesce_key;  ///<
+  };
+
+  std::mutex mutex_;                           ///< guards the state below
+  std::condition_variable cv_;                 ///< wakes the driver
+  std::condition_variable running_cv_;         ///< a callback returned
+  std::unordered_map<TimerId, Timer> timers_;  ///< the pending timers
+  std::unordered_map<std::string, TimerId> coalesce_keys_;  ///<
+
+  /**
+   * @brief the slots of every level holding the ids of the timers, the ids
+   * of cancelled timers are skipped and dropped when their slot comes due
+   *
+   */
+  std::array<std::vector<std::vector<TimerId>>, kLevels> wheel_;
+
+  uint64_t current_tick_ = 0;  ///< the last tick processed
+  TimerId next_timer_id_ = 1;  ///<
+  TimerId running_ = 0;        ///< the timer whose callback is running
+  bool stopped_ = false;       ///<
+
+  const Duration tick_;                                ///< wheel resolution
+  const std::chrono::steady_clock::time_point start_;  ///< tick 0
+  QThread* driver_ = nullptr;                          ///< the driver thread
+
+  /**
+   * @brief the tick of a time point
+   *
+   * @param time_point
+   * @return uint64_t
+   */
+  [[nodiscard]] uint64_t tick_of(
+      std::chrono::steady_clock::time_point time_point) const;
+
+  /**
+   * @brief put a timer into the slot matching its distance to the current
+   * tick, mutex_ must be held
+   *
+   * @param timer_id
+   * @param timer
+   */
+  void place(TimerId timer_id, const Timer& timer);
+
+  /**
+   * @brief process the ticks up to a tick, mutex_ must be held
+   *
+   * @param tick
+   * @param fired the timers due, the one-shot ones stay in timers_ until
+   * their callback is called, so that they can still be cancelled
+   */
+  void advance(uint64_t tick, std::vector<TimerId>& fired);
+
+  /**
+   * @brief the tick the driver has to wake at, the next tick with timers in
+   * the lowest level or the next cascade, mutex_ must be held
+   *
+   * @return uint64_t
+   */
+  [[nodiscard]] uint64_t next_wake_tick() const;
+
+  /**
+   * @brief the loop of the driver thread
+   *
+   */
+  void run_driver();
+};
+
+}  // namespace GpgFrontend::Thread
+
+#endif  // GPGFRONTEND_TASKSCHEDULER_H
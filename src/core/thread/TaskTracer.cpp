@@ -0,0 +1,224 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "core/thread/TaskTracer.h"
+
+#include <algorithm>
+#include <map>
+
+#include "core/function/FileOperator.h"
+#include "spdlog/spdlog.h"
+
+namespace {
+
+using TimePoint = GpgFrontend::Thread::TaskTraceRecord::TimePoint;
+
+/**
+ * @brief time between two points, zero if one of them is unset
+ *
+ */
+std::chrono::microseconds span(TimePoint begin, TimePoint end) {
+  if (begin == TimePoint{} || end == TimePoint{} || end < begin) return {};
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+}
+
+/**
+ * @brief the earliest point of the record
+ *
+ */
+TimePoint first_point(const GpgFrontend::Thread::TaskTraceRecord &record) {
+  return record.posted != TimePoint{} ? record.posted : record.run_begin;
+}
+
+}  // namespace
+
+std::chrono::microseconds
+GpgFrontend::Thread::TaskTraceRecord::GetQueueWait() const {
+  return span(posted, cancelled ? ended : run_begin);
+}
+
+std::chrono::microseconds GpgFrontend::Thread::TaskTraceRecord::GetRunTime()
+    const {
+  return span(run_begin, run_end);
+}
+
+std::chrono::microseconds
+GpgFrontend::Thread::TaskTraceRecord::GetCallbackLatency() const {
+  return span(run_end, callback_begin);
+}
+
+GpgFrontend::Thread::TaskTracer::TaskTracer(int channel)
+    : SingletonFunctionObject<TaskTracer>(channel) {}
+
+void GpgFrontend::Thread::TaskTracer::SetEnabled(bool enabled) {
+  enabled_ = enabled;
+}
+
+bool GpgFrontend::Thread::TaskTracer::IsEnabled() const { return enabled_; }
+
+void GpgFrontend::Thread::TaskTracer::SetCapacity(std::size_t capacity) {
+  std::lock_guard<std::mutex> lock(records_lock_);
+  capacity_ = std::max<std::size_t>(capacity, 1);
+  records_.clear();
+  records_.shrink_to_fit();
+  next_ = 0;
+}
+
+void GpgFrontend::Thread::TaskTracer::Record(TaskTraceRecord record) {
+  if (!enabled_) return;
+  std::lock_guard<std::mutex> lock(records_lock_);
+  if (records_.size() < capacity_) {
+    records_.push_back(std::move(record));
+    return;
+  }
+  records_[next_] = std::move(record);
+  next_ = (next_ + 1) % capacity_;
+}
+
+std::vector<GpgFrontend::Thread::TaskTraceRecord>
+GpgFrontend::Thread::TaskTracer::GetRecords() const {
+  std::lock_guard<std::mutex> lock(records_lock_);
+  // next_ stays 0 until the buffer is full, then it points at the oldest
+  std::vector<TaskTraceRecord> records(records_.begin() + next_,
+                                       records_.end());
+  records.insert(records.end(), records_.begin(), records_.begin() + next_);
+  return records;
+}
+
+void GpgFrontend::Thread::TaskTracer::Clear() {
+  std::lock_guard<std::mutex> lock(records_lock_);
+  records_.clear();
+  next_ = 0;
+}
+
+std::string GpgFrontend::Thread::TaskTracer::ExportChromeTrace() const {
+  auto records = GetRecords();
+
+  TimePoint origin{};
+  for (const auto &record : records) {
+    auto first = first_point(record);
+    if (first != TimePoint{} && (origin == TimePoint{} || first < origin))
+      origin = first;
+  }
+  auto timestamp = [origin](TimePoint point) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(point -
+                                                                 origin)
+        .count();
+  };
+
+  // thread ids are opaque handles, the viewer wants small numbers
+  std::map<std::uint64_t, int> tids;
+  auto events = nlohmann::json::array();
+  auto tid_of = [&](std::uint64_t thread, const std::string &thread_name) {
+    auto it = tids.find(thread);
+    if (it != tids.end()) return it->second;
+    int tid = static_cast<int>(tids.size()) + 1;
+    tids[thread] = tid;
+    events.push_back({{"name", "thread_name"},
+                      {"ph", "M"},
+                      {"pid", 1},
+                      {"tid", tid},
+                      {"args",
+                       {{"name", thread_name.empty()
+                                     ? "thread-" + std::to_string(tid)
+                                     : thread_name}}}});
+    return tid;
+  };
+
+  for (std::size_t i = 0; i < records.size(); i++) {
+    const auto &record = records[i];
+    nlohmann::json args = {
+        {"uuid", record.uuid},
+        {"runner", record.runner},
+        {"priority", record.priority},
+        {"cancelled", record.cancelled},
+        {"queue_wait_us", record.GetQueueWait().count()},
+        {"run_us", record.GetRunTime().count()},
+        {"callback_latency_us", record.GetCallbackLatency().count()},
+    };
+
+    // the wait overlaps the tasks running before it, keep it off the
+    // thread tracks as an async span
+    if (record.posted != TimePoint{}) {
+      auto wait_end = record.cancelled ? record.ended : record.run_begin;
+      if (wait_end != TimePoint{}) {
+        nlohmann::json wait = {{"name", record.name},
+                               {"cat", "queue"},
+                               {"id", i},
+                               {"pid", 1},
+                               {"tid", 0}};
+        wait["ph"] = "b";
+        wait["ts"] = timestamp(record.posted);
+        wait["args"] = args;
+        events.push_back(wait);
+        wait["ph"] = "e";
+        wait["ts"] = timestamp(wait_end);
+        wait.erase("args");
+        events.push_back(wait);
+      }
+    }
+
+    if (record.run_begin != TimePoint{} && record.run_end != TimePoint{}) {
+      events.push_back(
+          {{"name", record.name},
+           {"cat", "run"},
+           {"ph", "X"},
+           {"pid", 1},
+           {"tid", tid_of(record.run_thread, record.run_thread_name)},
+           {"ts", timestamp(record.run_begin)},
+           {"dur", record.GetRunTime().count()},
+           {"args", args}});
+    }
+
+    if (record.callback_begin != TimePoint{} &&
+        record.callback_end != TimePoint{}) {
+      events.push_back(
+          {{"name", record.name},
+           {"cat", "callback"},
+           {"ph", "X"},
+           {"pid", 1},
+           {"tid",
+            tid_of(record.callback_thread, record.callback_thread_name)},
+           {"ts", timestamp(record.callback_begin)},
+           {"dur", span(record.callback_begin, record.callback_end).count()},
+           {"args", args}});
+    }
+  }
+
+  nlohmann::json trace = {{"traceEvents", events},
+                          {"displayTimeUnit", "ms"}};
+  return trace.dump();
+}
+
+bool GpgFrontend::Thread::TaskTracer::ExportChromeTrace(
+    const std::filesystem::path &path) const {
+  auto trace = ExportChromeTrace();
+  SPDLOG_DEBUG("export task trace to: {}, size: {}", path.u8string(),
+               trace.size());
+  return FileOperator::WriteFileStd(path, trace);
+}
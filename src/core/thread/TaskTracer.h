@@ -0,0 +1,180 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GPGFRONTEND_TASKTRACER_H
+#define GPGFRONTEND_TASKTRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/GpgFrontendCore.h"
+#include "core/GpgFunctionObject.h"
+
+namespace GpgFrontend::Thread {
+
+/**
+ * @brief the life of a task, from being posted to its end
+ *
+ */
+struct GPGFRONTEND_CORE_EXPORT TaskTraceRecord {
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  std::string name;        ///<
+  std::string uuid;        ///<
+  std::string runner;      ///< object name of the runner it was posted to
+  int priority = 0;        ///<
+  bool cancelled = false;  ///< dropped before it started
+
+  TimePoint posted;          ///< unset if it never went through a runner
+  TimePoint run_begin;       ///<
+  TimePoint run_end;         ///<
+  TimePoint callback_begin;  ///< unset if there is no callback
+  TimePoint callback_end;    ///<
+  TimePoint ended;           ///< SignalTaskEnd raised
+
+  std::uint64_t run_thread = 0;       ///<
+  std::string run_thread_name;        ///<
+  std::uint64_t callback_thread = 0;  ///<
+  std::string callback_thread_name;   ///<
+
+  /**
+   * @brief time spent in the queue of the runner
+   *
+   * @return std::chrono::microseconds
+   */
+  [[nodiscard]] std::chrono::microseconds GetQueueWait() const;
+
+  /**
+   * @brief time spent in the runnable
+   *
+   * @return std::chrono::microseconds
+   */
+  [[nodiscard]] std::chrono::microseconds GetRunTime() const;
+
+  /**
+   * @brief time between the end of the runnable and the start of the
+   * callback on the callback thread
+   *
+   * @return std::chrono::microseconds
+   */
+  [[nodiscard]] std::chrono::microseconds GetCallbackLatency() const;
+};
+
+/**
+ * @brief keeps the trace records of the last finished tasks in a ring
+ * buffer, they can be exported as Chrome trace event JSON and opened in
+ * chrome://tracing or Perfetto.
+ *
+ */
+class GPGFRONTEND_CORE_EXPORT TaskTracer
+    : public SingletonFunctionObject<TaskTracer> {
+ public:
+  static constexpr std::size_t kDefaultCapacity = 4096;  ///<
+
+  /**
+   * @brief Construct a new Task Tracer object
+   *
+   * @param channel
+   */
+  explicit TaskTracer(
+      int channel = SingletonFunctionObject::GetDefaultChannel());
+
+  /**
+   * @brief turn recording on or off, it is off by default, as every record
+   * copies several strings and takes a global lock
+   *
+   * @param enabled
+   */
+  void SetEnabled(bool enabled);
+
+  /**
+   * @brief
+   *
+   * @return true if finished tasks are recorded
+   */
+  [[nodiscard]] bool IsEnabled() const;
+
+  /**
+   * @brief Set how many records are kept, the recorded ones are dropped
+   *
+   * @param capacity
+   */
+  void SetCapacity(std::size_t capacity);
+
+  /**
+   * @brief keep the record, the oldest one is overwritten once the buffer is
+   * full
+   *
+   * @param record
+   */
+  void Record(TaskTraceRecord record);
+
+  /**
+   * @brief Get the records, the oldest first
+   *
+   * @return std::vector<TaskTraceRecord>
+   */
+  [[nodiscard]] std::vector<TaskTraceRecord> GetRecords() const;
+
+  /**
+   * @brief drop all the records
+   *
+   */
+  void Clear();
+
+  /**
+   * @brief build the Chrome trace event JSON of the records
+   *
+   * @return std::string
+   */
+  [[nodiscard]] std::string ExportChromeTrace() const;
+
+  /**
+   * @brief write the Chrome trace event JSON of the records to a file
+   *
+   * @param path
+   * @return true if the file is written
+   */
+  bool ExportChromeTrace(const std::filesystem::path &path) const;
+
+ private:
+  mutable std::mutex records_lock_;          ///<
+  std::vector<TaskTraceRecord> records_;     ///< the ring buffer
+  std::size_t next_ = 0;                     ///< slot to overwrite when full
+  std::size_t capacity_ = kDefaultCapacity;  ///<
+  std::atomic_bool enabled_ = false;         ///<
+};
+
+}  // namespace GpgFrontend::Thread
+
+#endif  // GPGFRONTEND_TASKTRACER_H
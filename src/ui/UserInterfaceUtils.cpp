@@ -130,16 +130,21 @@ void process_operation(QWidget *parent, const std::string &waiting_title,
                         &QDialog::close);
   QApplication::connect(process_task, &Thread::Task::SignalTaskEnd, dialog,
                         &QDialog::deleteLater);
+  QApplication::connect(process_task, &Thread::Task::SignalTaskProgress,
+                        dialog, &WaitingDialog::SlotUpdateProgress);
+  // the task is busy in its own thread, cancel it from here
+  QApplication::connect(dialog, &WaitingDialog::SignalCancel, process_task,
+                        &Thread::Task::Cancel, Qt::DirectConnection);
 
   // a looper to wait for the operation
   QEventLoop looper;
   QApplication::connect(process_task, &Thread::Task::SignalTaskEnd, &looper,
                         &QEventLoop::quit);
 
-  // post process task to task runner
+  // post process task to task runner, ahead of the background work
   Thread::TaskRunnerGetter::GetInstance()
       .GetTaskRunner(Thread::TaskRunnerGetter::kTaskRunnerType_GPG)
-      ->PostTask(process_task);
+      ->PostTask(process_task, Thread::Task::kTaskPriority_Interactive);
 
   // block until task finished
   // this is to keep reference vaild until task finished
@@ -435,10 +440,9 @@ void CommonUtils::SlotImportKeyFromKeyServer(
 void CommonUtils::slot_update_key_status() {
   auto refresh_task = new Thread::Task(
       [](Thread::Task::DataObjectPtr) -> int {
-        // flush key cache for all GpgKeyGetter Intances.
-        for (const auto &channel_id : GpgKeyGetter::GetAllChannelId()) {
-          GpgKeyGetter::GetInstance(channel_id).FlushKeyCache();
-        }
+        // reload the keys changed since the last refresh for all
+        // GpgKeyGetter Intances.
+        GpgKeyGetter::RefreshKeyCaches();
         return 0;
       },
       "update_key_database_task");
@@ -448,7 +452,7 @@ void CommonUtils::slot_update_key_status() {
 
   // post the task to the default task runner
   Thread::TaskRunnerGetter::GetInstance().GetTaskRunner()->PostTask(
-      refresh_task);
+      refresh_task, Thread::Task::kTaskPriority_Background);
 }
 
 void CommonUtils::slot_popup_passphrase_input_dialog() {
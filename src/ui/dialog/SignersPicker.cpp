@@ -46,9 +46,7 @@ SignersPicker::SignersPicker(QWidget* parent)
   key_list_->AddListGroupTab(
       _("Signers"), "signers", KeyListRow::ONLY_SECRET_KEY,
       KeyListColumn::NAME | KeyListColumn::EmailAddress | KeyListColumn::Usage,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return key.IsHasActualSigningCapability();
-      });
+      KeySummaryFlag::CAN_SIGN);
   key_list_->SlotRefresh();
 
   auto* vbox2 = new QVBoxLayout();
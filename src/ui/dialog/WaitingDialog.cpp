@@ -34,15 +34,28 @@ namespace GpgFrontend::UI {
 
 WaitingDialog::WaitingDialog(const QString& title, QWidget* parent)
     : GeneralDialog("WaitingDialog", parent) {
-  auto* pb = new QProgressBar();
-  pb->setRange(0, 0);
-  pb->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
-  pb->setTextVisible(false);
+  progress_bar_ = new QProgressBar();
+  progress_bar_->setRange(0, 0);
+  progress_bar_->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+  progress_bar_->setTextVisible(false);
+
+  progress_label_ = new QLabel();
+  progress_label_->hide();
+
+  cancel_button_ = new QPushButton(_("Cancel"));
+  cancel_button_->hide();
+  connect(cancel_button_, &QPushButton::clicked, this, [=]() {
+    cancel_button_->setEnabled(false);
+    progress_label_->setText(_("Cancelling..."));
+    emit SignalCancel();
+  });
 
   auto* layout = new QVBoxLayout();
   layout->setContentsMargins(0, 0, 0, 0);
   layout->setSpacing(0);
-  layout->addWidget(pb);
+  layout->addWidget(progress_bar_);
+  layout->addWidget(progress_label_);
+  layout->addWidget(cancel_button_, 0, Qt::AlignRight);
   this->setLayout(layout);
 
   this->setModal(true);
@@ -56,4 +69,39 @@ WaitingDialog::WaitingDialog(const QString& title, QWidget* parent)
   this->show();
 }
 
+void WaitingDialog::SlotUpdateProgress(quint64 processed, quint64 total,
+                                       double speed, qint64 eta) {
+  // already cancelling, keep the message
+  if (!cancel_button_->isEnabled()) return;
+
+  if (progress_label_->isHidden()) {
+    progress_label_->show();
+    cancel_button_->show();
+    this->layout()->setContentsMargins(5, 5, 5, 5);
+    this->layout()->setSpacing(5);
+    this->setFixedSize(360, this->sizeHint().height());
+  }
+
+  auto locale = QLocale();
+  auto text = locale.formattedDataSize(static_cast<qint64>(processed));
+  if (total != 0) {
+    // permille, so that the bar moves smoothly on large files
+    progress_bar_->setRange(0, 1000);
+    progress_bar_->setValue(
+        static_cast<int>(std::min<quint64>(processed * 1000 / total, 1000)));
+    text += " / " + locale.formattedDataSize(static_cast<qint64>(total));
+  }
+  text += QString(", %1/s").arg(
+      locale.formattedDataSize(static_cast<qint64>(speed)));
+  if (eta >= 0) {
+    // QTime wraps after a day, the hours are not limited
+    text += QString(", %1 %2:%3:%4")
+                .arg(_("Remaining"))
+                .arg(eta / 3600, 2, 10, QChar('0'))
+                .arg(eta / 60 % 60, 2, 10, QChar('0'))
+                .arg(eta % 60, 2, 10, QChar('0'));
+  }
+  progress_label_->setText(text);
+}
+
 }  // namespace GpgFrontend::UI
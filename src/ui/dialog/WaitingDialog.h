@@ -48,6 +48,31 @@ class WaitingDialog : public GeneralDialog {
    * @param parent
    */
   WaitingDialog(const QString& title, QWidget* parent);
+
+ signals:
+  /**
+   * @brief the user asks to cancel the operation
+   *
+   */
+  void SignalCancel();
+
+ public slots:
+  /**
+   * @brief show the progress of the operation, the progress bar, the speed,
+   * the remaining time and the cancel button appear on the first call
+   *
+   * @param processed bytes processed
+   * @param total bytes in total, 0 if unknown
+   * @param speed bytes per second
+   * @param eta estimated remaining seconds, -1 if unknown
+   */
+  void SlotUpdateProgress(quint64 processed, quint64 total, double speed,
+                          qint64 eta);
+
+ private:
+  QProgressBar* progress_bar_;  ///<
+  QLabel* progress_label_;      ///<
+  QPushButton* cancel_button_;  ///<
 };
 
 }  // namespace GpgFrontend::UI
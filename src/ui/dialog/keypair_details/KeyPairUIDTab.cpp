@@ -35,7 +35,8 @@
 namespace GpgFrontend::UI {
 
 KeyPairUIDTab::KeyPairUIDTab(const std::string& key_id, QWidget* parent)
-    : QWidget(parent), m_key_(GpgKeyGetter::GetInstance().GetKey(key_id)) {
+    : QWidget(parent),
+      m_key_(GpgKeyGetter::GetInstance().GetDetailedKey(key_id)) {
   create_uid_list();
   create_sign_list();
   create_manage_uid_menu();
@@ -588,7 +589,8 @@ void KeyPairUIDTab::slot_del_sign() {
 }
 void KeyPairUIDTab::slot_refresh_key() {
   // refresh the key
-  GpgKey refreshed_key = GpgKeyGetter::GetInstance().GetKey(m_key_.GetId());
+  GpgKey refreshed_key =
+      GpgKeyGetter::GetInstance().GetDetailedKey(m_key_.GetId());
   std::swap(this->m_key_, refreshed_key);
 
   this->slot_refresh_uid_list();
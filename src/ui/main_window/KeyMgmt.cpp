@@ -54,44 +54,31 @@ KeyMgmt::KeyMgmt(QWidget* parent)
       _("Only Public Key"), "only_public_key", KeyListRow::SECRET_OR_PUBLIC_KEY,
       KeyListColumn::TYPE | KeyListColumn::NAME | KeyListColumn::EmailAddress |
           KeyListColumn::Usage | KeyListColumn::Validity,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return !key.IsPrivateKey() &&
-               !(key.IsRevoked() || key.IsDisabled() || key.IsExpired());
-      });
+      0, KeySummaryFlag::SECRET | KeySummaryFlag::UNUSABLE);
 
   key_list_->AddListGroupTab(
       _("Has Private Key"), "has_private_key", KeyListRow::SECRET_OR_PUBLIC_KEY,
       KeyListColumn::TYPE | KeyListColumn::NAME | KeyListColumn::EmailAddress |
           KeyListColumn::Usage | KeyListColumn::Validity,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return key.IsPrivateKey() &&
-               !(key.IsRevoked() || key.IsDisabled() || key.IsExpired());
-      });
+      KeySummaryFlag::SECRET, KeySummaryFlag::UNUSABLE);
 
   key_list_->AddListGroupTab(
       _("No Primary Key"), "no_primary_key", KeyListRow::SECRET_OR_PUBLIC_KEY,
       KeyListColumn::TYPE | KeyListColumn::NAME | KeyListColumn::EmailAddress |
           KeyListColumn::Usage | KeyListColumn::Validity,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return !key.IsHasMasterKey() &&
-               !(key.IsRevoked() || key.IsDisabled() || key.IsExpired());
-      });
+      0, KeySummaryFlag::MASTER_KEY | KeySummaryFlag::UNUSABLE);
 
   key_list_->AddListGroupTab(
       _("Revoked"), "revoked", KeyListRow::SECRET_OR_PUBLIC_KEY,
       KeyListColumn::TYPE | KeyListColumn::NAME | KeyListColumn::EmailAddress |
           KeyListColumn::Usage | KeyListColumn::Validity,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return key.IsRevoked();
-      });
+      KeySummaryFlag::REVOKED);
 
   key_list_->AddListGroupTab(
       _("Expired"), "expired", KeyListRow::SECRET_OR_PUBLIC_KEY,
       KeyListColumn::TYPE | KeyListColumn::NAME | KeyListColumn::EmailAddress |
           KeyListColumn::Usage | KeyListColumn::Validity,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return key.IsExpired();
-      });
+      KeySummaryFlag::EXPIRED);
 
   setCentralWidget(key_list_);
   key_list_->SetDoubleClickedAction([this](const GpgKey& key, QWidget* parent) {
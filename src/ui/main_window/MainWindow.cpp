@@ -32,6 +32,8 @@
 #include "core/function/CacheManager.h"
 #include "core/function/GlobalSettingStation.h"
 #include "core/function/gpg/GpgAdvancedOperator.h"
+#include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyringWatcher.h"
 #include "main_window/GeneralMainWindow.h"
 #include "nlohmann/json_fwd.hpp"
 #include "spdlog/spdlog.h"
@@ -145,6 +147,20 @@ void MainWindow::Init() noexcept {
 
     emit SignalLoaded();
 
+    // the key list is shown from the disk cache, reload the keyring behind it
+    if (GpgKeyGetter::GetInstance().GetKeyCacheSnapshot()->from_disk) {
+      GpgKeyGetter::MarkKeyringChanged();
+      emit SignalKeyDatabaseRefresh();
+    }
+
+    // pick up the keys changed by other gpg processes
+    if (GlobalSettingStation::GetInstance().LookupSettings(
+            "general.watch_keyring", true)) {
+      auto *keyring_watcher = new GpgKeyringWatcher(this);
+      connect(keyring_watcher, &GpgKeyringWatcher::SignalKeyringChanged, this,
+              &MainWindow::SignalKeyDatabaseRefresh);
+    }
+
     // if not prohibit update checking
     if (!prohibit_update_checking_) {
       auto *version_task = new VersionCheckTask();
@@ -154,7 +170,7 @@ void MainWindow::Init() noexcept {
 
       Thread::TaskRunnerGetter::GetInstance()
           .GetTaskRunner(Thread::TaskRunnerGetter::kTaskRunnerType_Network)
-          ->PostTask(version_task);
+          ->PostTask(version_task, Thread::Task::kTaskPriority_Background);
     }
 
     // before application exit
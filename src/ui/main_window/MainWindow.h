@@ -229,6 +229,11 @@ class MainWindow : public GeneralMainWindow {
    */
   void slot_start_wizard();
 
+  /**
+   * @details save the traces of the last tasks as Chrome trace event JSON
+   */
+  void slot_export_task_trace();
+
   /**
    * @details Import keys from currently active tab to keylist if possible.
    */
@@ -473,6 +478,7 @@ class MainWindow : public GeneralMainWindow {
   QAction* open_settings_act_{};         ///< Action to open settings dialog
   QAction* show_key_details_act_{};      ///< Action to open key-details dialog
   QAction* start_wizard_act_{};          ///< Action to open the wizard
+  QAction* export_task_trace_act_{};     ///< Action to export task traces
   QAction* cut_pgp_header_act_{};        ///< Action for cutting the PGP header
   QAction* add_pgp_header_act_{};        ///< Action for adding the PGP header
   QAction* import_key_from_file_act_{};  ///<
@@ -27,7 +27,6 @@
  */
 
 #include "MainWindow.h"
-#include "core/function/ArchiveFileOperator.h"
 #include "core/function/GlobalSettingStation.h"
 #include "core/function/gpg/GpgFileOpera.h"
 #include "core/function/gpg/GpgKeyGetter.h"
@@ -58,100 +57,6 @@ bool path_pre_check(QWidget* parent, const QString& path) {
   return true;
 }
 
-/**
- * @brief convert directory into tarball
- *
- * @param parent parent widget
- * @param path the directory to be converted
- * @return
- */
-bool process_tarball_into_directory(QWidget* parent,
-                                    std::filesystem::path& path) {
-  SPDLOG_DEBUG("converting directory into tarball: {}", path.u8string());
-  auto selected_dir_path = std::filesystem::path(path);
-
-  if (selected_dir_path.extension() != ".tar") {
-    QMessageBox::critical(parent, _("Error"), _("The file is not a tarball."));
-    return false;
-  }
-
-  try {
-    auto base_path = selected_dir_path.parent_path();
-
-    auto target_path = selected_dir_path;
-    target_path.replace_extension(".tar");
-
-    SPDLOG_DEBUG("base path: {} target archive path: {]", base_path.u8string(),
-                 target_path.u8string());
-
-    bool if_error = false;
-    process_operation(parent, _("Extracting Tarball"),
-                      [&](Thread::Task::DataObjectPtr) -> int {
-                        try {
-                          GpgFrontend::ArchiveFileOperator::ExtractArchive(
-                              target_path, base_path);
-                        } catch (const std::runtime_error& e) {
-                          if_error = true;
-                        }
-                        return 0;
-                      });
-
-    if (if_error || !exists(target_path)) {
-      throw std::runtime_error("Decompress Failed");
-    }
-    path = target_path.u8string().c_str();
-  } catch (...) {
-    SPDLOG_ERROR("decompress error");
-    return false;
-  }
-  return true;
-}
-
-/**
- * @brief convert tarball into directory
- *
- * @param parent parent widget
- * @param path the tarball to be converted
- */
-bool process_directory_into_tarball(QWidget* parent, QString& path) {
-#ifdef WINDOWS
-  std::filesystem::path selected_dir_path = path.toStdU16String();
-#else
-  std::filesystem::path selected_dir_path = path.toStdString();
-#endif
-
-  try {
-    auto base_path = selected_dir_path.parent_path();
-    auto target_path = selected_dir_path;
-    selected_dir_path.replace_extension("");
-
-    SPDLOG_DEBUG("base path: {} target archive path: {} selected_dir_path: {}",
-                 base_path.u8string(), target_path.u8string(),
-                 selected_dir_path.u8string());
-
-    bool if_error = false;
-    process_operation(parent, _("Making Tarball"),
-                      [&](Thread::Task::DataObjectPtr) -> int {
-                        try {
-                          GpgFrontend::ArchiveFileOperator::CreateArchive(
-                              base_path, target_path, 0, {selected_dir_path});
-                        } catch (const std::runtime_error& e) {
-                          if_error = true;
-                        }
-                        return 0;
-                      });
-
-    if (if_error || !exists(target_path)) {
-      throw std::runtime_error("Compress Failed");
-    }
-    path = target_path.u8string().c_str();
-  } catch (...) {
-    SPDLOG_ERROR("compress error");
-    return false;
-  }
-  return true;
-}
-
 void MainWindow::SlotFileEncrypt() {
   auto fileTreeView = edit_->SlotCurPageFileTreeView();
   auto path = fileTreeView->GetSelected();
@@ -174,10 +79,6 @@ void MainWindow::SlotFileEncrypt() {
   // get file info
   QFileInfo file_info(path);
 
-  if (file_info.isDir()) {
-    path = path + (file_info.isDir() ? ".tar" : "");
-  }
-
   auto _channel = GPGFRONTEND_DEFAULT_CHANNEL;
   auto _extension = ".asc";
   if (non_ascii_when_export || file_info.isDir()) {
@@ -185,7 +86,8 @@ void MainWindow::SlotFileEncrypt() {
     _extension = ".gpg";
   }
 
-  auto out_path = path + _extension;
+  // a directory is encrypted as a tarball
+  auto out_path = path + (file_info.isDir() ? ".tar" : "") + _extension;
 
   if (QFile::exists(out_path)) {
 #ifdef WINDOWS
@@ -203,15 +105,6 @@ void MainWindow::SlotFileEncrypt() {
     if (ret == QMessageBox::Cancel) return;
   }
 
-  if (file_info.isDir()) {
-    // stop if the process making tarball failed
-    if (!process_directory_into_tarball(this, path)) {
-      QMessageBox::critical(this, _("Error"),
-                            _("Unable to convert the folder into tarball."));
-      return;
-    }
-  }
-
   if (key_ids->empty()) {
     // Symmetric Encrypt
     auto ret = QMessageBox::information(
@@ -226,8 +119,15 @@ void MainWindow::SlotFileEncrypt() {
         this, _("Symmetrically Encrypting"),
         [&](Thread::Task::DataObjectPtr) -> int {
           try {
-            error = GpgFrontend::GpgFileOpera::EncryptFileSymmetric(
-                path.toStdString(), out_path.toStdString(), result, _channel);
+            if (file_info.isDir()) {
+              error = GpgFrontend::GpgFileOpera::EncryptDirectorySymmetric(
+                  path.toStdString(), out_path.toStdString(), result,
+                  _channel);
+            } else {
+              error = GpgFrontend::GpgFileOpera::EncryptFileSymmetric(
+                  path.toStdString(), out_path.toStdString(), result,
+                  _channel);
+            }
           } catch (const std::runtime_error& e) {
             if_error = true;
           }
@@ -250,26 +150,23 @@ void MainWindow::SlotFileEncrypt() {
       }
     }
 
-    process_operation(this, _("Encrypting"),
-                      [&](Thread::Task::DataObjectPtr) -> int {
-                        try {
-                          error = GpgFileOpera::EncryptFile(
-                              std::move(p_keys), path.toStdString(),
-                              out_path.toStdString(), result, _channel);
-                        } catch (const std::runtime_error& e) {
-                          if_error = true;
-                        }
-                        return 0;
-                      });
-  }
-
-  // remove xxx.tar and only left xxx.tar.gpg
-  if (file_info.isDir()) {
-    auto selected_dir_path = std::filesystem::path(path.toStdString());
-    auto target_path = selected_dir_path.replace_extension(".tar");
-    if (exists(target_path)) {
-      std::filesystem::remove(target_path);
-    }
+    process_operation(
+        this, _("Encrypting"), [&](Thread::Task::DataObjectPtr) -> int {
+          try {
+            if (file_info.isDir()) {
+              error = GpgFileOpera::EncryptDirectory(
+                  std::move(p_keys), path.toStdString(),
+                  out_path.toStdString(), result, _channel);
+            } else {
+              error = GpgFileOpera::EncryptFile(
+                  std::move(p_keys), path.toStdString(),
+                  out_path.toStdString(), result, _channel);
+            }
+          } catch (const std::runtime_error& e) {
+            if_error = true;
+          }
+          return 0;
+        });
   }
 
   if (!if_error) {
@@ -302,7 +199,15 @@ void MainWindow::SlotFileDecrypt() {
     out_path += ".out";
   }
 
-  if (exists(out_path)) {
+  // a tarball can be extracted while it is being decrypted
+  bool extract_tarball =
+      out_path.extension() == ".tar" &&
+      QMessageBox::question(
+          this, _("Decrypting"),
+          _("Do you want to extract the tarball while decrypting it?"),
+          QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes;
+
+  if (!extract_tarball && exists(out_path)) {
     auto ret = QMessageBox::warning(
         this, _("Warning"),
         _("The target file already exists, do you need to overwrite it?"),
@@ -314,16 +219,21 @@ void MainWindow::SlotFileDecrypt() {
   GpgDecrResult result = nullptr;
   gpgme_error_t error;
   bool if_error = false;
-  process_operation(this, _("Decrypting"),
-                    [&](Thread::Task::DataObjectPtr) -> int {
-                      try {
-                        error = GpgFileOpera::DecryptFile(
-                            path.toStdString(), out_path.u8string(), result);
-                      } catch (const std::runtime_error& e) {
-                        if_error = true;
-                      }
-                      return 0;
-                    });
+  process_operation(
+      this, _("Decrypting"), [&](Thread::Task::DataObjectPtr) -> int {
+        try {
+          if (extract_tarball) {
+            error = GpgFileOpera::DecryptArchive(
+                path.toStdString(), out_path.parent_path().u8string(), result);
+          } else {
+            error = GpgFileOpera::DecryptFile(path.toStdString(),
+                                              out_path.u8string(), result);
+          }
+        } catch (const std::runtime_error& e) {
+          if_error = true;
+        }
+        return 0;
+      });
 
   if (!if_error) {
     auto resultAnalyse = GpgDecryptResultAnalyse(error, std::move(result));
@@ -336,25 +246,6 @@ void MainWindow::SlotFileDecrypt() {
                           _("An error occurred during operation."));
     return;
   }
-
-  // extract the tarball
-  if (out_path.extension() == ".tar" && exists(out_path)) {
-    bool ret = QMessageBox::information(
-        this, _("Decrypting"),
-        _("Do you want to extract and delete the decrypted tarball?"),
-        QMessageBox::Ok | QMessageBox::Cancel);
-    if (ret) {
-      if (process_tarball_into_directory(this, out_path)) {
-        QMessageBox::information(this, _("Decrypting"),
-                                 _("Extracting tarball succeeded."));
-        // remove tarball
-        std::filesystem::remove(out_path);
-      } else {
-        QMessageBox::critical(this, _("Decrypting"),
-                              _("Extracting tarball failed."));
-      }
-    }
-  }
 }
 
 void MainWindow::SlotFileSign() {
@@ -573,10 +464,6 @@ void MainWindow::SlotFileEncryptSign() {
   // get file info
   QFileInfo file_info(path);
 
-  if (file_info.isDir()) {
-    path = path + (file_info.isDir() ? ".tar" : "");
-  }
-
   auto _channel = GPGFRONTEND_DEFAULT_CHANNEL;
   auto _extension = ".asc";
   if (non_ascii_when_export || file_info.isDir()) {
@@ -584,7 +471,8 @@ void MainWindow::SlotFileEncryptSign() {
     _extension = ".gpg";
   }
 
-  auto out_path = path + _extension;
+  // a directory is encrypted as a tarball
+  auto out_path = path + (file_info.isDir() ? ".tar" : "") + _extension;
 
   if (QFile::exists(out_path)) {
     auto ret = QMessageBox::warning(
@@ -606,34 +494,32 @@ void MainWindow::SlotFileEncryptSign() {
   auto signer_key_ids = signersPicker->GetCheckedSigners();
   auto p_signer_keys = GpgKeyGetter::GetInstance().GetKeys(signer_key_ids);
 
-  // convert directory into tarball
-  if (file_info.isDir()) {
-    // stop if the process making tarball failed
-    if (!process_directory_into_tarball(this, path)) {
-      QMessageBox::critical(this, _("Error"),
-                            _("Unable to convert the folder into tarball."));
-      return;
-    }
-  }
-
   GpgEncrResult encr_result = nullptr;
   GpgSignResult sign_result = nullptr;
 
   gpgme_error_t error;
   bool if_error = false;
 
-  process_operation(this, _("Encrypting and Signing"),
-                    [&](Thread::Task::DataObjectPtr) -> int {
-                      try {
-                        error = GpgFileOpera::EncryptSignFile(
-                            std::move(p_keys), std::move(p_signer_keys),
-                            path.toStdString(), out_path.toStdString(),
-                            encr_result, sign_result, _channel);
-                      } catch (const std::runtime_error& e) {
-                        if_error = true;
-                      }
-                      return 0;
-                    });
+  process_operation(
+      this, _("Encrypting and Signing"),
+      [&](Thread::Task::DataObjectPtr) -> int {
+        try {
+          if (file_info.isDir()) {
+            error = GpgFileOpera::EncryptSignDirectory(
+                std::move(p_keys), std::move(p_signer_keys),
+                path.toStdString(), out_path.toStdString(), encr_result,
+                sign_result, _channel);
+          } else {
+            error = GpgFileOpera::EncryptSignFile(
+                std::move(p_keys), std::move(p_signer_keys),
+                path.toStdString(), out_path.toStdString(), encr_result,
+                sign_result, _channel);
+          }
+        } catch (const std::runtime_error& e) {
+          if_error = true;
+        }
+        return 0;
+      });
 
   if (!if_error) {
     auto encrypt_result =
@@ -650,15 +536,6 @@ void MainWindow::SlotFileEncryptSign() {
                           _("An error occurred during operation."));
     return;
   }
-
-  // remove xxx.tar and only left xxx.tar.gpg
-  if (file_info.isDir()) {
-    auto selected_dir_path = std::filesystem::path(path.toStdString());
-    auto target_path = selected_dir_path.replace_extension(".tar");
-    if (exists(target_path)) {
-      std::filesystem::remove(target_path);
-    }
-  }
 }
 
 void MainWindow::SlotFileDecryptVerify() {
@@ -681,7 +558,15 @@ void MainWindow::SlotFileDecryptVerify() {
   }
   SPDLOG_DEBUG("out path: {}", out_path.u8string());
 
-  if (QFile::exists(out_path.u8string().c_str())) {
+  // a tarball can be extracted while it is being decrypted
+  bool extract_tarball =
+      out_path.extension() == ".tar" &&
+      QMessageBox::question(
+          this, _("Decrypting"),
+          _("Do you want to extract the tarball while decrypting it?"),
+          QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes;
+
+  if (!extract_tarball && QFile::exists(out_path.u8string().c_str())) {
     auto ret =
         QMessageBox::warning(this, _("Warning"),
                              QString(_("The output file %1 already exists, do "
@@ -696,17 +581,23 @@ void MainWindow::SlotFileDecryptVerify() {
   GpgVerifyResult v_result = nullptr;
   gpgme_error_t error;
   bool if_error = false;
-  process_operation(this, _("Decrypting and Verifying"),
-                    [&](Thread::Task::DataObjectPtr) -> int {
-                      try {
-                        error = GpgFileOpera::DecryptVerifyFile(
-                            path.toStdString(), out_path.u8string(), d_result,
-                            v_result);
-                      } catch (const std::runtime_error& e) {
-                        if_error = true;
-                      }
-                      return 0;
-                    });
+  process_operation(
+      this, _("Decrypting and Verifying"),
+      [&](Thread::Task::DataObjectPtr) -> int {
+        try {
+          if (extract_tarball) {
+            error = GpgFileOpera::DecryptVerifyArchive(
+                path.toStdString(), out_path.parent_path().u8string(),
+                d_result, v_result);
+          } else {
+            error = GpgFileOpera::DecryptVerifyFile(
+                path.toStdString(), out_path.u8string(), d_result, v_result);
+          }
+        } catch (const std::runtime_error& e) {
+          if_error = true;
+        }
+        return 0;
+      });
 
   if (!if_error) {
     auto decrypt_res = GpgDecryptResultAnalyse(error, std::move(d_result));
@@ -727,25 +618,6 @@ void MainWindow::SlotFileDecryptVerify() {
                           _("An error occurred during operation."));
     return;
   }
-
-  // extract the tarball
-  if (out_path.extension() == ".tar" && exists(out_path)) {
-    bool ret = QMessageBox::information(
-        this, _("Decrypting"),
-        _("Do you want to extract and delete the decrypted tarball?"),
-        QMessageBox::Ok | QMessageBox::Cancel);
-    if (ret) {
-      if (process_tarball_into_directory(this, out_path)) {
-        QMessageBox::information(this, _("Decrypting"),
-                                 _("Extracting tarball succeeded."));
-        // remove tarball
-        std::filesystem::remove(out_path);
-      } else {
-        QMessageBox::critical(this, _("Decrypting"),
-                              _("Extracting tarball failed."));
-      }
-    }
-  }
 }
 
 }  // namespace GpgFrontend::UI
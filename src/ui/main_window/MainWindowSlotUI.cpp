@@ -29,6 +29,7 @@
 #include "MainWindow.h"
 #include "core/GpgConstants.h"
 #include "core/function/GlobalSettingStation.h"
+#include "core/thread/TaskTracer.h"
 #include "ui/UserInterfaceUtils.h"
 #include "ui/struct/SettingsObject.h"
 
@@ -44,6 +45,33 @@ void MainWindow::slot_start_wizard() {
   wizard->setModal(true);
 }
 
+void MainWindow::slot_export_task_trace() {
+  auto& tracer = Thread::TaskTracer::GetInstance();
+  // nothing is recorded until asked for
+  if (!tracer.IsEnabled()) {
+    auto ret = QMessageBox::question(
+        this, _("Export Task Trace"),
+        _("Tasks are not traced. Start tracing them now and export the trace "
+          "later?"),
+        QMessageBox::Yes | QMessageBox::No);
+    if (ret == QMessageBox::Yes) tracer.SetEnabled(true);
+    return;
+  }
+
+  auto file_name = QFileDialog::getSaveFileName(
+      this, _("Export Task Trace"), "task_trace.json",
+      QString(_("Trace Files")) + " (*.json);;All Files (*)");
+  if (file_name.isEmpty()) return;
+
+  // not through the local 8-bit encoding, which breaks non-ASCII paths
+  if (!tracer.ExportChromeTrace(
+          std::filesystem::path(file_name.toStdU16String()))) {
+    QMessageBox::critical(
+        this, _("Export Error"),
+        QString(_("Couldn't open %1 for writing")).arg(file_name));
+  }
+}
+
 void MainWindow::slot_import_key_from_edit() {
   if (edit_->TabCount() == 0 || edit_->SlotCurPageTextEdit() == nullptr) return;
   CommonUtils::GetInstance()->SlotImportKeys(
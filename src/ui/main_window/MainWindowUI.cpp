@@ -366,6 +366,12 @@ void MainWindow::create_actions() {
   connect(start_wizard_act_, &QAction::triggered, this,
           &MainWindow::slot_start_wizard);
 
+  export_task_trace_act_ = new QAction(_("Export Task Trace"), this);
+  export_task_trace_act_->setToolTip(
+      _("Save the timeline of the last tasks for a trace viewer"));
+  connect(export_task_trace_act_, &QAction::triggered, this,
+          &MainWindow::slot_export_task_trace);
+
   append_selected_keys_act_ =
       new QAction(_("Append Public Key to Editor"), this);
   append_selected_keys_act_->setToolTip(
@@ -533,6 +539,7 @@ void MainWindow::create_menus() {
   help_menu_->addAction(check_update_act_);
   help_menu_->addAction(gnupg_act_);
   help_menu_->addAction(translate_act_);
+  help_menu_->addAction(export_task_trace_act_);
   help_menu_->addAction(about_act_);
 }
 
@@ -615,9 +622,7 @@ void MainWindow::create_dock_windows() {
       _("Default"), "default", KeyListRow::SECRET_OR_PUBLIC_KEY,
       KeyListColumn::TYPE | KeyListColumn::NAME | KeyListColumn::EmailAddress |
           KeyListColumn::Usage | KeyListColumn::Validity,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return !(key.IsRevoked() || key.IsDisabled() || key.IsExpired());
-      });
+      0, KeySummaryFlag::UNUSABLE);
 
   m_key_list_->AddListGroupTab(
       _("Favourite"), "favourite", KeyListRow::SECRET_OR_PUBLIC_KEY,
@@ -631,19 +636,13 @@ void MainWindow::create_dock_windows() {
       _("Only Public Key"), "only_public_key", KeyListRow::SECRET_OR_PUBLIC_KEY,
       KeyListColumn::TYPE | KeyListColumn::NAME | KeyListColumn::EmailAddress |
           KeyListColumn::Usage | KeyListColumn::Validity,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return !key.IsPrivateKey() &&
-               !(key.IsRevoked() || key.IsDisabled() || key.IsExpired());
-      });
+      0, KeySummaryFlag::SECRET | KeySummaryFlag::UNUSABLE);
 
   m_key_list_->AddListGroupTab(
       _("Has Private Key"), "has_private_key", KeyListRow::SECRET_OR_PUBLIC_KEY,
       KeyListColumn::TYPE | KeyListColumn::NAME | KeyListColumn::EmailAddress |
           KeyListColumn::Usage | KeyListColumn::Validity,
-      [](const GpgKey& key, const KeyTable&) -> bool {
-        return key.IsPrivateKey() &&
-               !(key.IsRevoked() || key.IsDisabled() || key.IsExpired());
-      });
+      KeySummaryFlag::SECRET, KeySummaryFlag::UNUSABLE);
 
   m_key_list_->SlotRefresh();
 
@@ -174,6 +174,15 @@ void KeyList::AddListGroupTab(const QString& name, const QString& id,
           &KeyList::slot_double_clicked);
 }
 
+void KeyList::AddListGroupTab(const QString& name, const QString& id,
+                              KeyListRow::KeyType selectType,
+                              KeyListColumn::InfoType infoType,
+                              KeySummaryFlag::FlagType required_flags,
+                              KeySummaryFlag::FlagType excluded_flags) {
+  AddListGroupTab(name, id, selectType, infoType, nullptr);
+  m_key_tables_.back().SetFlagFilter(required_flags, excluded_flags);
+}
+
 void KeyList::SlotRefresh() {
   SPDLOG_DEBUG("refresh, address: {}", static_cast<void*>(this));
 
@@ -181,7 +190,7 @@ void KeyList::SlotRefresh() {
   ui_->syncButton->setDisabled(true);
 
   emit SignalRefreshStatusBar(_("Refreshing Key List..."), 3000);
-  this->buffered_keys_list_ = GpgKeyGetter::GetInstance().FetchKey();
+  this->buffered_keys_list_ = GpgKeyGetter::GetInstance().GetKeyCacheSnapshot();
   this->slot_refresh_ui();
 }
 
@@ -194,7 +203,7 @@ KeyIdArgsListPtr KeyList::GetChecked(const KeyTable& key_table) {
   auto ret = std::make_unique<KeyIdArgsList>();
   for (int i = 0; i < key_table.key_list_->rowCount(); i++) {
     if (key_table.key_list_->item(i, 0)->checkState() == Qt::Checked) {
-      ret->push_back(key_table.buffered_keys_[i].GetId());
+      ret->push_back(key_table.GetKeyId(i));
     }
   }
   return ret;
@@ -203,12 +212,11 @@ KeyIdArgsListPtr KeyList::GetChecked(const KeyTable& key_table) {
 KeyIdArgsListPtr KeyList::GetChecked() {
   auto key_list =
       qobject_cast<QTableWidget*>(ui_->keyGroupTab->currentWidget());
-  const auto& buffered_keys =
-      m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
+  const auto& key_table = m_key_tables_[ui_->keyGroupTab->currentIndex()];
   auto ret = std::make_unique<KeyIdArgsList>();
   for (int i = 0; i < key_list->rowCount(); i++) {
     if (key_list->item(i, 0)->checkState() == Qt::Checked) {
-      ret->push_back(buffered_keys[i].GetId());
+      ret->push_back(key_table.GetKeyId(i));
     }
   }
   return ret;
@@ -217,12 +225,12 @@ KeyIdArgsListPtr KeyList::GetChecked() {
 KeyIdArgsListPtr KeyList::GetAllPrivateKeys() {
   auto key_list =
       qobject_cast<QTableWidget*>(ui_->keyGroupTab->currentWidget());
-  const auto& buffered_keys =
-      m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
+  const auto& key_table = m_key_tables_[ui_->keyGroupTab->currentIndex()];
   auto ret = std::make_unique<KeyIdArgsList>();
   for (int i = 0; i < key_list->rowCount(); i++) {
-    if (key_list->item(i, 1) && buffered_keys[i].IsPrivateKey()) {
-      ret->push_back(buffered_keys[i].GetId());
+    if (key_list->item(i, 1) &&
+        (key_table.GetKeyFlags(i) & KeySummaryFlag::SECRET)) {
+      ret->push_back(key_table.GetKeyId(i));
     }
   }
   return ret;
@@ -234,13 +242,12 @@ KeyIdArgsListPtr KeyList::GetPrivateChecked() {
 
   auto key_list =
       qobject_cast<QTableWidget*>(ui_->keyGroupTab->currentWidget());
-  const auto& buffered_keys =
-      m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
+  const auto& key_table = m_key_tables_[ui_->keyGroupTab->currentIndex()];
 
   for (int i = 0; i < key_list->rowCount(); i++) {
     if ((key_list->item(i, 0)->checkState() == Qt::Checked) &&
         (key_list->item(i, 1))) {
-      ret->push_back(buffered_keys[i].GetId());
+      ret->push_back(key_table.GetKeyId(i));
     }
   }
   return ret;
@@ -251,7 +258,7 @@ void KeyList::SetChecked(const KeyIdArgsListPtr& keyIds,
   if (!keyIds->empty()) {
     for (int i = 0; i < key_table.key_list_->rowCount(); i++) {
       if (std::find(keyIds->begin(), keyIds->end(),
-                    key_table.buffered_keys_[i].GetId()) != keyIds->end()) {
+                    key_table.GetKeyId(i)) != keyIds->end()) {
         key_table.key_list_->item(i, 0)->setCheckState(Qt::Checked);
       }
     }
@@ -278,12 +285,11 @@ KeyIdArgsListPtr KeyList::GetSelected() {
 
   auto key_list =
       qobject_cast<QTableWidget*>(ui_->keyGroupTab->currentWidget());
-  const auto& buffered_keys =
-      m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
+  const auto& key_table = m_key_tables_[ui_->keyGroupTab->currentIndex()];
 
   for (int i = 0; i < key_list->rowCount(); i++) {
     if (key_list->item(i, 0)->isSelected() == 1) {
-      ret->push_back(buffered_keys[i].GetId());
+      ret->push_back(key_table.GetKeyId(i));
     }
   }
   return ret;
@@ -434,11 +440,10 @@ void KeyList::import_keys(const QByteArray& inBuffer) {
 
 void KeyList::slot_double_clicked(const QModelIndex& index) {
   if (ui_->keyGroupTab->size().isEmpty()) return;
-  const auto& buffered_keys =
-      m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
+  const auto& key_table = m_key_tables_[ui_->keyGroupTab->currentIndex()];
   if (m_action_ != nullptr) {
     const auto key =
-        GpgKeyGetter::GetInstance().GetKey(buffered_keys[index.row()].GetId());
+        GpgKeyGetter::GetInstance().GetKey(key_table.GetKeyId(index.row()));
     m_action_(key, this);
   }
 }
@@ -450,12 +455,11 @@ void KeyList::SetDoubleClickedAction(
 
 std::string KeyList::GetSelectedKey() {
   if (ui_->keyGroupTab->size().isEmpty()) return {};
-  const auto& buffered_keys =
-      m_key_tables_[ui_->keyGroupTab->currentIndex()].buffered_keys_;
+  const auto& key_table = m_key_tables_[ui_->keyGroupTab->currentIndex()];
 
   for (int i = 0; i < m_key_list_->rowCount(); i++) {
     if (m_key_list_->item(i, 0)->isSelected() == 1) {
-      return buffered_keys[i].GetId();
+      return key_table.GetKeyId(i);
     }
   }
   return {};
@@ -467,8 +471,7 @@ void KeyList::slot_refresh_ui() {
     std::lock_guard<std::mutex> guard(buffered_key_list_mutex_);
 
     for (auto& key_table : m_key_tables_) {
-      key_table.Refresh(
-          GpgKeyGetter::GetInstance().GetKeysCopy(buffered_keys_list_));
+      key_table.Refresh(buffered_keys_list_);
     }
   }
   emit SignalRefreshStatusBar(_("Key List Refreshed."), 1000);
@@ -480,9 +483,12 @@ void KeyList::slot_sync_with_key_server() {
   KeyIdArgsList key_ids;
   {
     std::lock_guard<std::mutex> guard(buffered_key_list_mutex_);
-    for (const auto& key : *buffered_keys_list_) {
-      if (!(key.IsPrivateKey() && key.IsHasMasterKey()))
-        key_ids.push_back(key.GetId());
+    const auto& summary = buffered_keys_list_->summary;
+    const auto private_flags =
+        KeySummaryFlag::SECRET | KeySummaryFlag::MASTER_KEY;
+    for (std::size_t row = 0; row < summary.Size(); row++) {
+      if ((summary.GetFlags(row) & private_flags) != private_flags)
+        key_ids.push_back(summary.GetId(row));
     }
   }
 
@@ -559,8 +565,8 @@ KeyIdArgsListPtr& KeyTable::GetChecked() {
   if (checked_key_ids_ == nullptr)
     checked_key_ids_ = std::make_unique<KeyIdArgsList>();
   auto& ret = checked_key_ids_;
-  for (int i = 0; i < buffered_keys_.size(); i++) {
-    auto key_id = buffered_keys_[i].GetId();
+  for (int i = 0; i < buffered_rows_.size(); i++) {
+    const auto& key_id = GetKeyId(i);
     if (key_list_->item(i, 0)->checkState() == Qt::Checked &&
         std::find(ret->begin(), ret->end(), key_id) == ret->end()) {
       ret->push_back(key_id);
@@ -573,69 +579,42 @@ void KeyTable::SetChecked(KeyIdArgsListPtr key_ids) {
   checked_key_ids_ = std::move(key_ids);
 }
 
-void KeyTable::Refresh(KeyLinkListPtr m_keys) {
+void KeyTable::Refresh(KeyCacheSnapshotPtr snapshot) {
   auto& checked_key_list = GetChecked();
   // while filling the table, sort enabled causes errors
 
   key_list_->setSortingEnabled(false);
   key_list_->clearContents();
 
-  // Optimization for copy
-  KeyLinkListPtr keys = nullptr;
-  if (m_keys == nullptr)
-    keys = GpgKeyGetter::GetInstance().FetchKey();
-  else
-    keys = std::move(m_keys);
-
-  auto it = keys->begin();
-  int row_count = 0;
-
-  while (it != keys->end()) {
-    // filter by search bar's keyword
-    if (ability_ & KeyMenuAbility::SEARCH_BAR && !keyword_.empty()) {
-      auto name = it->GetName();
-      std::transform(name.begin(), name.end(), name.begin(),
-                     [](unsigned char c) { return std::tolower(c); });
-
-      auto email = it->GetEmail();
-      std::transform(email.begin(), email.end(), email.begin(),
-                     [](unsigned char c) { return std::tolower(c); });
-
-      auto comment = it->GetComment();
-      std::transform(comment.begin(), comment.end(), comment.begin(),
-                     [](unsigned char c) { return std::tolower(c); });
-
-      if (name.find(keyword_) == std::string::npos &&
-          email.find(keyword_) == std::string::npos &&
-          comment.find(keyword_) == std::string::npos) {
-        it = keys->erase(it);
-        continue;
-      }
-    }
-
+  // the keys are shared with the snapshot, nothing is copied
+  if (snapshot == nullptr)
+    snapshot = GpgKeyGetter::GetInstance().GetKeyCacheSnapshot();
+  snapshot_ = snapshot;
+  const auto& summary = snapshot->summary;
+
+  // filter by search bar's keyword and the flags on the summary table
+  auto required_flags = required_flags_;
+  if (select_type_ == KeyListRow::ONLY_SECRET_KEY)
+    required_flags |= KeySummaryFlag::SECRET;
+  auto rows = summary.Filter(
+      ability_ & KeyMenuAbility::SEARCH_BAR ? keyword_ : std::string(),
+      required_flags, excluded_flags_);
+
+  buffered_rows_.clear();
+  for (auto row : rows) {
     if (filter_ != nullptr) {
-      if (!filter_(*it, *this)) {
-        it = keys->erase(it);
-        continue;
-      }
-    }
-
-    if (select_type_ == KeyListRow::ONLY_SECRET_KEY && !it->IsPrivateKey()) {
-      it = keys->erase(it);
-      continue;
+      // rows loaded from the disk cache have no key to filter yet
+      const auto& key = summary.GetKey(row);
+      if (key == nullptr || !filter_(*key, *this)) continue;
     }
-    row_count++;
-    it++;
+    buffered_rows_.push_back(row);
   }
 
-  key_list_->setRowCount(row_count);
+  key_list_->setRowCount(static_cast<int>(buffered_rows_.size()));
 
   int row_index = 0;
-  it = keys->begin();
-
-  buffered_keys_.clear();
-
-  while (it != keys->end()) {
+  for (auto row : buffered_rows_) {
+    const auto flags = summary.GetFlags(row);
     auto* tmp0 = new QTableWidgetItem(QString::number(row_index));
     tmp0->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled |
                    Qt::ItemIsSelectable);
@@ -645,52 +624,55 @@ void KeyTable::Refresh(KeyLinkListPtr m_keys) {
 
     QString type_str;
     QTextStream type_steam(&type_str);
-    if (it->IsPrivateKey()) {
+    if (flags & KeySummaryFlag::SECRET) {
       type_steam << "pub/sec";
     } else {
       type_steam << "pub";
     }
 
-    if (it->IsPrivateKey() && !it->IsHasMasterKey()) {
+    if ((flags & KeySummaryFlag::SECRET) &&
+        !(flags & KeySummaryFlag::MASTER_KEY)) {
       type_steam << "#";
     }
 
-    if (it->IsHasCardKey()) {
+    if (flags & KeySummaryFlag::CARD_KEY) {
       type_steam << "^";
     }
 
     auto* tmp1 = new QTableWidgetItem(type_str);
     key_list_->setItem(row_index, 1, tmp1);
 
-    auto* tmp2 = new QTableWidgetItem(QString::fromStdString(it->GetName()));
+    auto* tmp2 =
+        new QTableWidgetItem(QString::fromStdString(summary.GetName(row)));
     key_list_->setItem(row_index, 2, tmp2);
-    auto* tmp3 = new QTableWidgetItem(QString::fromStdString(it->GetEmail()));
+    auto* tmp3 =
+        new QTableWidgetItem(QString::fromStdString(summary.GetEmail(row)));
     key_list_->setItem(row_index, 3, tmp3);
 
     QString usage;
     QTextStream usage_steam(&usage);
 
-    if (it->IsHasActualCertificationCapability()) usage_steam << "C";
-    if (it->IsHasActualEncryptionCapability()) usage_steam << "E";
-    if (it->IsHasActualSigningCapability()) usage_steam << "S";
-    if (it->IsHasActualAuthenticationCapability()) usage_steam << "A";
+    if (flags & KeySummaryFlag::CAN_CERTIFY) usage_steam << "C";
+    if (flags & KeySummaryFlag::CAN_ENCRYPT) usage_steam << "E";
+    if (flags & KeySummaryFlag::CAN_SIGN) usage_steam << "S";
+    if (flags & KeySummaryFlag::CAN_AUTH) usage_steam << "A";
 
     auto* temp_usage = new QTableWidgetItem(usage);
     temp_usage->setTextAlignment(Qt::AlignCenter);
     key_list_->setItem(row_index, 4, temp_usage);
 
-    auto* temp_validity =
-        new QTableWidgetItem(QString::fromStdString(it->GetOwnerTrust()));
+    auto* temp_validity = new QTableWidgetItem(
+        QString::fromStdString(summary.GetOwnerTrust(row)));
     temp_validity->setTextAlignment(Qt::AlignCenter);
     key_list_->setItem(row_index, 5, temp_validity);
 
-    auto* temp_fpr =
-        new QTableWidgetItem(QString::fromStdString(it->GetFingerprint()));
+    auto* temp_fpr = new QTableWidgetItem(
+        QString::fromStdString(summary.GetFingerprint(row)));
     temp_fpr->setTextAlignment(Qt::AlignCenter);
     key_list_->setItem(row_index, 6, temp_fpr);
 
     // strike out expired keys
-    if (it->IsExpired() || it->IsRevoked()) {
+    if (flags & (KeySummaryFlag::EXPIRED | KeySummaryFlag::REVOKED)) {
       QFont strike = tmp2->font();
       strike.setStrikeOut(true);
       tmp0->setFont(strike);
@@ -702,23 +684,27 @@ void KeyTable::Refresh(KeyLinkListPtr m_keys) {
       tmp3->setFont(strike);
     }
 
-    // move to buffered keys
-    buffered_keys_.emplace_back(std::move(*it));
-
-    it++;
     ++row_index;
   }
 
   if (!checked_key_list->empty()) {
     for (int i = 0; i < key_list_->rowCount(); i++) {
       if (std::find(checked_key_list->begin(), checked_key_list->end(),
-                    buffered_keys_[i].GetId()) != checked_key_list->end()) {
+                    GetKeyId(i)) != checked_key_list->end()) {
         key_list_->item(i, 0)->setCheckState(Qt::Checked);
       }
     }
   }
 }
 
+const std::string& KeyTable::GetKeyId(int row) const {
+  return snapshot_->summary.GetId(buffered_rows_[row]);
+}
+
+KeySummaryFlag::FlagType KeyTable::GetKeyFlags(int row) const {
+  return snapshot_->summary.GetFlags(buffered_rows_[row]);
+}
+
 void KeyTable::UncheckALL() const {
   for (int i = 0; i < key_list_->rowCount(); i++) {
     key_list_->item(i, 0)->setCheckState(Qt::Unchecked);
@@ -738,4 +724,10 @@ void KeyTable::SetMenuAbility(KeyMenuAbility::AbilityType ability) {
 void KeyTable::SetFilterKeyword(std::string keyword) {
   this->keyword_ = keyword;
 }
+
+void KeyTable::SetFlagFilter(KeySummaryFlag::FlagType required,
+                             KeySummaryFlag::FlagType excluded) {
+  this->required_flags_ = required;
+  this->excluded_flags_ = excluded;
+}
 }  // namespace GpgFrontend::UI
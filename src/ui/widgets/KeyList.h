@@ -33,6 +33,7 @@
 #include <utility>
 
 #include "core/GpgContext.h"
+#include "core/function/gpg/GpgKeyGetter.h"
 #include "ui/dialog/import_export/KeyImportDetailDialog.h"
 
 class Ui_KeyList;
@@ -89,14 +90,17 @@ struct KeyMenuAbility {
 struct KeyTable {
   using KeyTableFilter = std::function<bool(const GpgKey&, const KeyTable&)>;
 
-  QTableWidget* key_list_;               ///<
-  KeyListRow::KeyType select_type_;      ///<
-  KeyListColumn::InfoType info_type_;    ///<
-  std::vector<GpgKey> buffered_keys_;    ///<
-  KeyTableFilter filter_;                ///<
-  KeyIdArgsListPtr checked_key_ids_;     ///<
-  KeyMenuAbility::AbilityType ability_;  ///<
-  std::string keyword_;                  ///<
+  QTableWidget* key_list_;                       ///<
+  KeyListRow::KeyType select_type_;              ///<
+  KeyListColumn::InfoType info_type_;            ///<
+  KeyCacheSnapshotPtr snapshot_;                 ///<
+  std::vector<std::size_t> buffered_rows_;       ///< rows of the summary table
+  KeyTableFilter filter_;                        ///<
+  KeyIdArgsListPtr checked_key_ids_;             ///<
+  KeyMenuAbility::AbilityType ability_;          ///<
+  std::string keyword_;                          ///<
+  KeySummaryFlag::FlagType required_flags_ = 0;  ///<
+  KeySummaryFlag::FlagType excluded_flags_ = 0;  ///<
 
   /**
    * @brief Construct a new Key Table object
@@ -120,9 +124,25 @@ struct KeyTable {
   /**
    * @brief
    *
-   * @param m_keys
+   * @param snapshot keys to show, the current key cache if nullptr
    */
-  void Refresh(KeyLinkListPtr m_keys = nullptr);
+  void Refresh(KeyCacheSnapshotPtr snapshot = nullptr);
+
+  /**
+   * @brief Get the key id shown in a row of the table
+   *
+   * @param row
+   * @return const std::string&
+   */
+  [[nodiscard]] const std::string& GetKeyId(int row) const;
+
+  /**
+   * @brief Get the flags of the key shown in a row of the table
+   *
+   * @param row
+   * @return KeySummaryFlag::FlagType
+   */
+  [[nodiscard]] KeySummaryFlag::FlagType GetKeyFlags(int row) const;
 
   /**
    * @brief Get the Checked object
@@ -161,6 +181,16 @@ struct KeyTable {
    *
    */
   void SetFilterKeyword(std::string keyword);
+
+  /**
+   * @brief show only the keys having all the required flags and none of the
+   * excluded ones, checked on the key summary table before filter_
+   *
+   * @param required
+   * @param excluded
+   */
+  void SetFlagFilter(KeySummaryFlag::FlagType required,
+                     KeySummaryFlag::FlagType excluded);
 };
 
 /**
@@ -195,6 +225,23 @@ class KeyList : public QWidget {
       const KeyTable::KeyTableFilter filter =
           [](const GpgKey&, const KeyTable&) -> bool { return true; });
 
+  /**
+   * @brief add a tab filtered only by key flags, which is much cheaper than
+   * a filter function on large keyrings
+   *
+   * @param name
+   * @param id
+   * @param selectType
+   * @param infoType
+   * @param required_flags flags a key must all have
+   * @param excluded_flags flags a key must have none of
+   */
+  void AddListGroupTab(const QString& name, const QString& id,
+                       KeyListRow::KeyType selectType,
+                       KeyListColumn::InfoType infoType,
+                       KeySummaryFlag::FlagType required_flags,
+                       KeySummaryFlag::FlagType excluded_flags = 0);
+
   /**
    * @brief Set the Double Clicked Action object
    *
@@ -365,7 +412,7 @@ class KeyList : public QWidget {
   QTableWidget* m_key_list_{};                                       ///<
   std::vector<KeyTable> m_key_tables_;                               ///<
   QMenu* popup_menu_{};                                              ///<
-  GpgFrontend::KeyLinkListPtr buffered_keys_list_;                   ///<
+  GpgFrontend::KeyCacheSnapshotPtr buffered_keys_list_;              ///<
   std::function<void(const GpgKey&, QWidget*)> m_action_ = nullptr;  ///<
   KeyMenuAbility::AbilityType menu_ability_ = KeyMenuAbility::ALL;   ///<
 
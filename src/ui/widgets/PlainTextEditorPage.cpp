@@ -197,7 +197,7 @@ void PlainTextEditorPage::ReadFile() {
     this->ui_->loadingLabel->setHidden(true);
   });
 
-  task_runner->PostTask(read_task);
+  task_runner->PostTask(read_task, Thread::Task::kTaskPriority_Interactive);
 }
 
 std::string binary_to_string(const std::string &source) {
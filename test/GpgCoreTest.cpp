@@ -27,6 +27,3 @@
  */
 
 #include "GpgFrontendTest.h"
-
-// Should be used once and once-only
-INITIALIZE_EASYLOGGINGPP
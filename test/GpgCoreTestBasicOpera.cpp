@@ -28,14 +28,19 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <functional>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "GpgFrontendTest.h"
-#include "gpg/GpgConstants.h"
-#include "gpg/function/GpgBasicOperator.h"
-#include "gpg/function/GpgKeyGetter.h"
-#include "gpg/result_analyse/GpgDecryptResultAnalyse.h"
+#include "core/GpgConstants.h"
+#include "core/GpgContext.h"
+#include "core/function/gpg/GpgBasicOperator.h"
+#include "core/function/gpg/GpgFileOpera.h"
+#include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/result_analyse/GpgDecryptResultAnalyse.h"
 
 using namespace GpgFrontend;
 
@@ -48,14 +53,14 @@ TEST_F(GpgCoreTest, CoreEncryptDecrTest) {
   KeyListPtr keys = std::make_unique<KeyArgsList>();
   keys->push_back(std::move(encrypt_key));
   auto err =
-      BasicOperator::GetInstance(default_channel)
+      GpgBasicOperator::GetInstance(default_channel)
           .Encrypt(std::move(keys), encrypt_text, encr_out_data, e_result);
   ASSERT_EQ(e_result->invalid_recipients, nullptr);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
 
   GpgDecrResult d_result;
   ByteArrayPtr decr_out_data;
-  err = BasicOperator::GetInstance(default_channel)
+  err = GpgBasicOperator::GetInstance(default_channel)
             .Decrypt(*encr_out_data, decr_out_data, d_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
   ASSERT_NE(d_result->recipients, nullptr);
@@ -79,7 +84,7 @@ TEST_F(GpgCoreTest, CoreEncryptDecrTest_KeyNotFound_1) {
 
   GpgDecrResult d_result;
   ByteArrayPtr decr_out_data;
-  auto err = BasicOperator::GetInstance(default_channel)
+  auto err = GpgBasicOperator::GetInstance(default_channel)
                  .Decrypt(*encr_out_data, decr_out_data, d_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_SECKEY);
   ASSERT_NE(d_result->recipients, nullptr);
@@ -102,16 +107,16 @@ TEST_F(GpgCoreTest, CoreEncryptDecrTest_KeyNotFound_ResultAnalyse) {
 
   GpgDecrResult d_result;
   ByteArrayPtr decr_out_data;
-  auto err = BasicOperator::GetInstance(default_channel)
+  auto err = GpgBasicOperator::GetInstance(default_channel)
                  .Decrypt(*encr_out_data, decr_out_data, d_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_SECKEY);
   ASSERT_NE(d_result->recipients, nullptr);
   ASSERT_EQ(std::string(d_result->recipients->keyid), "A50CFD2F6C677D8C");
 
-  DecryptResultAnalyse analyse{err, d_result};
-  analyse.analyse();
-  ASSERT_EQ(analyse.getStatus(), -1);
-  ASSERT_FALSE(analyse.getResultReport().empty());
+  GpgDecryptResultAnalyse analyse{err, d_result};
+  analyse.Analyse();
+  ASSERT_EQ(analyse.GetStatus(), -1);
+  ASSERT_FALSE(analyse.GetResultReport().empty());
 }
 
 TEST_F(GpgCoreTest, CoreSignVerifyNormalTest) {
@@ -122,7 +127,7 @@ TEST_F(GpgCoreTest, CoreSignVerifyNormalTest) {
   GpgSignResult s_result;
   KeyListPtr keys = std::make_unique<KeyArgsList>();
   keys->push_back(std::move(encrypt_key));
-  auto err = BasicOperator::GetInstance(default_channel)
+  auto err = GpgBasicOperator::GetInstance(default_channel)
                  .Sign(std::move(keys), sign_text, sign_out_data,
                        GPGME_SIG_MODE_NORMAL, s_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
@@ -130,7 +135,7 @@ TEST_F(GpgCoreTest, CoreSignVerifyNormalTest) {
 
   GpgVerifyResult v_result;
   ByteArrayPtr sign_buff = nullptr;
-  err = BasicOperator::GetInstance(default_channel)
+  err = GpgBasicOperator::GetInstance(default_channel)
             .Verify(*sign_out_data, sign_buff, v_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
   ASSERT_NE(v_result->signatures, nullptr);
@@ -147,14 +152,14 @@ TEST_F(GpgCoreTest, CoreSignVerifyDetachTest) {
   GpgSignResult s_result;
   KeyListPtr keys = std::make_unique<KeyArgsList>();
   keys->push_back(std::move(encrypt_key));
-  auto err = BasicOperator::GetInstance(default_channel)
+  auto err = GpgBasicOperator::GetInstance(default_channel)
                  .Sign(std::move(keys), sign_text, sign_out_data,
                        GPGME_SIG_MODE_DETACH, s_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
   ASSERT_EQ(s_result->invalid_signers, nullptr);
 
   GpgVerifyResult v_result;
-  err = BasicOperator::GetInstance(default_channel)
+  err = GpgBasicOperator::GetInstance(default_channel)
             .Verify(sign_text, sign_out_data, v_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
   ASSERT_NE(v_result->signatures, nullptr);
@@ -171,7 +176,7 @@ TEST_F(GpgCoreTest, CoreSignVerifyClearTest) {
   GpgSignResult s_result;
   KeyListPtr keys = std::make_unique<KeyArgsList>();
   keys->push_back(std::move(sign_key));
-  auto err = BasicOperator::GetInstance(default_channel)
+  auto err = GpgBasicOperator::GetInstance(default_channel)
                  .Sign(std::move(keys), sign_text, sign_out_data,
                        GPGME_SIG_MODE_CLEAR, s_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
@@ -179,7 +184,7 @@ TEST_F(GpgCoreTest, CoreSignVerifyClearTest) {
 
   GpgVerifyResult v_result;
   ByteArrayPtr sign_buff = nullptr;
-  err = BasicOperator::GetInstance(default_channel)
+  err = GpgBasicOperator::GetInstance(default_channel)
             .Verify(*sign_out_data, sign_buff, v_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
   ASSERT_NE(v_result->signatures, nullptr);
@@ -194,9 +199,9 @@ TEST_F(GpgCoreTest, CoreEncryptSignDecrVerifyTest) {
   auto sign_key = GpgKeyGetter::GetInstance(default_channel)
                       .GetKey("8933EB283A18995F45D61DAC021D89771B680FFB");
   //   Question?
-  //   ASSERT_FALSE(encrypt_key.is_private_key());
-  ASSERT_TRUE(sign_key.is_private_key());
-  ASSERT_TRUE(sign_key.CanSignActual());
+  //   ASSERT_FALSE(encrypt_key.IsPrivateKey());
+  ASSERT_TRUE(sign_key.IsPrivateKey());
+  ASSERT_TRUE(sign_key.IsHasActualSigningCapability());
   ByteArray encrypt_text = "Hello GpgFrontend!";
   ByteArrayPtr encr_out_data;
   GpgEncrResult e_result;
@@ -207,7 +212,7 @@ TEST_F(GpgCoreTest, CoreEncryptSignDecrVerifyTest) {
   keys->push_back(std::move(encrypt_key));
   sign_keys->push_back(std::move(sign_key));
 
-  auto err = BasicOperator::GetInstance(default_channel)
+  auto err = GpgBasicOperator::GetInstance(default_channel)
                  .EncryptSign(std::move(keys), std::move(sign_keys),
                               encrypt_text, encr_out_data, e_result, s_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
@@ -217,7 +222,7 @@ TEST_F(GpgCoreTest, CoreEncryptSignDecrVerifyTest) {
   GpgDecrResult d_result;
   GpgVerifyResult v_result;
   ByteArrayPtr decr_out_data = nullptr;
-  err = BasicOperator::GetInstance(default_channel)
+  err = GpgBasicOperator::GetInstance(default_channel)
             .DecryptVerify(*encr_out_data, decr_out_data, d_result, v_result);
   ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
   ASSERT_NE(d_result->recipients, nullptr);
@@ -228,3 +233,301 @@ TEST_F(GpgCoreTest, CoreEncryptSignDecrVerifyTest) {
             "8933EB283A18995F45D61DAC021D89771B680FFB");
   ASSERT_EQ(v_result->signatures->next, nullptr);
 }
+
+TEST_F(GpgCoreFileTest, CoreFileEncryptDecrStreamTest) {
+  auto dir = make_test_dir("stream");
+  auto plain_path = dir / "plain.txt", encr_path = dir / "plain.txt.gpg",
+       decr_path = dir / "decr.txt";
+
+  // many times the buffer gpgme reads through the callbacks
+  std::string plain_text;
+  for (int i = 0; i < 64 * 1024; i++) plain_text += "Hello GpgFrontend! ";
+  write_test_file(plain_path, plain_text);
+
+  GpgEncrResult e_result;
+  auto err = GpgFileOpera::EncryptFile(
+      make_test_recipients(), plain_path.u8string(), encr_path.u8string(),
+      e_result, default_channel);
+  ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+  ASSERT_EQ(e_result->invalid_recipients, nullptr);
+
+  GpgDecrResult d_result;
+  err = GpgFileOpera::DecryptFile(encr_path.u8string(), decr_path.u8string(),
+                                  d_result);
+  ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+  ASSERT_EQ(read_test_file(decr_path), plain_text);
+}
+
+TEST_F(GpgCoreFileTest, CoreFileEncryptSamePathTest) {
+  auto dir = make_test_dir("same_path");
+  auto plain_path = dir / "plain.txt";
+  write_test_file(plain_path, "Hello GpgFrontend!");
+
+  GpgEncrResult e_result;
+  // the input must not be truncated before it is read
+  ASSERT_THROW(GpgFileOpera::EncryptFile(make_test_recipients(),
+                                         plain_path.u8string(),
+                                         plain_path.u8string(), e_result,
+                                         default_channel),
+               std::runtime_error);
+  ASSERT_EQ(read_test_file(plain_path), "Hello GpgFrontend!");
+}
+
+TEST_F(GpgCoreFileTest, CoreFileEncryptBatchTest) {
+  auto dir = make_test_dir("encrypt_batch");
+  auto paths = make_test_batch(dir, "plain", 8);
+
+  std::vector<GpgFileOperaItem<GpgEncrResult>> items;
+  auto stats = GpgFileOpera::EncryptFiles(make_test_recipients(),
+                                          paths, items, 4, default_channel);
+  ASSERT_EQ(stats.total, paths.size());
+  ASSERT_EQ(stats.failed, 0U);
+  ASSERT_GE(stats.workers, 1);
+  ASSERT_LE(stats.workers, 4);
+  ASSERT_EQ(items.size(), paths.size());
+
+  for (size_t i = 0; i < items.size(); i++) {
+    ASSERT_EQ(check_gpg_error_2_err_code(items[i].error), GPG_ERR_NO_ERROR);
+    ASSERT_EQ(items[i].in_path, paths[i].first);
+
+    GpgDecrResult d_result;
+    auto decr_path = paths[i].first + ".decr";
+    auto err =
+        GpgFileOpera::DecryptFile(items[i].out_path, decr_path, d_result);
+    ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+    ASSERT_EQ(read_test_file(decr_path), read_test_file(paths[i].first));
+  }
+}
+
+TEST_F(GpgCoreFileTest, CoreFileEncryptConcurrentBatchesTest) {
+  auto dir = make_test_dir("encrypt_batches");
+  auto paths_a = make_test_batch(dir, "a", 8);
+  auto paths_b = make_test_batch(dir, "b", 8);
+
+  // two batches at once must not share a worker context
+  std::vector<GpgFileOperaItem<GpgEncrResult>> items_a, items_b;
+  GpgFileOperaStats stats_a, stats_b;
+  std::thread batch_a([&]() {
+    stats_a = GpgFileOpera::EncryptFiles(
+        make_test_recipients(), paths_a, items_a, 4,
+        default_channel);
+  });
+  std::thread batch_b([&]() {
+    stats_b = GpgFileOpera::EncryptFiles(
+        make_test_recipients(), paths_b, items_b, 4,
+        default_channel);
+  });
+  batch_a.join();
+  batch_b.join();
+
+  ASSERT_EQ(stats_a.total, paths_a.size());
+  ASSERT_EQ(stats_a.failed, 0U);
+  ASSERT_EQ(stats_b.total, paths_b.size());
+  ASSERT_EQ(stats_b.failed, 0U);
+}
+
+TEST_F(GpgCoreTest, CoreBatchPassphrasesTest) {
+  int asked = 0;
+  auto ask = [&]() { return "passphrase " + std::to_string(++asked); };
+
+  GpgBatchPassphrases passphrases;
+  // every key is asked once, whatever its user id
+  ASSERT_EQ(passphrases.Get("F89C95A05088CC93 A <a@a.a>", false, ask),
+            "passphrase 1");
+  ASSERT_EQ(passphrases.Get("F89C95A05088CC93 B <b@b.b>", false, ask),
+            "passphrase 1");
+  ASSERT_EQ(passphrases.Get("021D89771B680FFB C <c@c.c>", false, ask),
+            "passphrase 2");
+  // a rejected passphrase is asked again
+  ASSERT_EQ(passphrases.Get("F89C95A05088CC93 A <a@a.a>", true, ask),
+            "passphrase 3");
+  ASSERT_EQ(passphrases.Get("F89C95A05088CC93 A <a@a.a>", false, ask),
+            "passphrase 3");
+  ASSERT_EQ(asked, 3);
+
+  // another batch doesn't see them
+  GpgBatchPassphrases other;
+  ASSERT_EQ(other.Get("F89C95A05088CC93 A <a@a.a>", false, ask),
+            "passphrase 4");
+
+  // a cancelled prompt is not kept
+  GpgBatchPassphrases cancelled;
+  ASSERT_EQ(cancelled.Get("F89C95A05088CC93", false, [] { return ""; }), "");
+  ASSERT_EQ(cancelled.Get("F89C95A05088CC93", false, ask), "passphrase 5");
+}
+
+TEST_F(GpgCoreFileTest, CoreFileVerifyBatchTest) {
+  auto dir = make_test_dir("verify_batch");
+  auto paths = make_test_batch(dir, "data", 4);
+
+  for (const auto& path : paths) {
+    GpgSignResult s_result;
+    auto err = GpgFileOpera::SignFile(make_test_signers(kTestSigner),
+                                      path.first, path.first + ".sig",
+                                      s_result, default_channel);
+    ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+  }
+  // a signature without its data file is not a pair
+  write_test_file(dir / "orphan.txt.sig", "not a signature");
+  // the signature of a changed file must not verify
+  write_test_file(paths[3].first, "Hello GpgFrontend! changed");
+
+  auto pairs = GpgFileOpera::CollectSignaturePairs(dir.u8string());
+  ASSERT_EQ(pairs.size(), paths.size());
+  for (size_t i = 0; i < pairs.size(); i++) {
+    ASSERT_EQ(pairs[i].first, paths[i].first);
+    ASSERT_EQ(pairs[i].second, paths[i].first + ".sig");
+  }
+
+  std::vector<GpgFileOperaItem<GpgVerifyResult>> items;
+  auto stats = GpgFileOpera::VerifyFiles(pairs, items, 2, default_channel);
+  ASSERT_EQ(stats.total, pairs.size());
+  ASSERT_EQ(stats.failed, 0U);
+
+  for (size_t i = 0; i < items.size(); i++) {
+    ASSERT_EQ(check_gpg_error_2_err_code(items[i].error), GPG_ERR_NO_ERROR);
+    auto* signature = items[i].result->signatures;
+    ASSERT_NE(signature, nullptr);
+    if (i == 3) {
+      ASSERT_EQ(check_gpg_error_2_err_code(signature->status),
+                GPG_ERR_BAD_SIGNATURE);
+      continue;
+    }
+    ASSERT_EQ(check_gpg_error_2_err_code(signature->status), GPG_ERR_NO_ERROR);
+    ASSERT_EQ(std::string(signature->fpr), kTestSigner);
+  }
+}
+
+TEST_F(GpgCoreFileTest, CoreFileSignBatchTest) {
+  auto dir = make_test_dir("sign_batches");
+  auto paths_a = make_test_batch(dir, "a", 6);
+  auto paths_b = make_test_batch(dir, "b", 6);
+  // the default signature path is used
+  for (auto& path : paths_a) path.second.clear();
+  for (auto& path : paths_b) path.second.clear();
+
+  const auto* sig_extension =
+      GpgContext::GetInstance(default_channel).GetInitArgs().ascii ? ".asc"
+                                                                   : ".sig";
+  const std::string signer_a = kTestRecipient, signer_b = kTestSigner;
+
+  // two batches at once must each sign with their own keys
+  std::vector<GpgFileOperaItem<GpgSignResult>> items_a, items_b;
+  GpgFileOperaStats stats_a, stats_b;
+  auto sign_batch = [&](const std::string& signer,
+                        const std::vector<FilePathPair>& paths,
+                        std::vector<GpgFileOperaItem<GpgSignResult>>& items,
+                        GpgFileOperaStats& stats) {
+    stats = GpgFileOpera::SignFiles(make_test_signers(signer), paths, items, 3,
+                                    default_channel);
+  };
+  std::thread batch_a(sign_batch, signer_a, std::cref(paths_a),
+                      std::ref(items_a), std::ref(stats_a));
+  std::thread batch_b(sign_batch, signer_b, std::cref(paths_b),
+                      std::ref(items_b), std::ref(stats_b));
+  batch_a.join();
+  batch_b.join();
+
+  ASSERT_EQ(stats_a.failed, 0U);
+  ASSERT_EQ(stats_b.failed, 0U);
+
+  auto check_batch = [&](const std::vector<FilePathPair>& paths,
+                         const std::vector<GpgFileOperaItem<GpgSignResult>>&
+                             items,
+                         const std::string& signer) {
+    ASSERT_EQ(items.size(), paths.size());
+    std::vector<FilePathPair> pairs;
+    for (const auto& item : items) {
+      ASSERT_EQ(item.out_path, item.in_path + sig_extension);
+      pairs.emplace_back(item.in_path, item.out_path);
+    }
+
+    std::vector<GpgFileOperaItem<GpgVerifyResult>> verify_items;
+    auto stats = GpgFileOpera::VerifyFiles(pairs, verify_items, 2,
+                                           default_channel);
+    ASSERT_EQ(stats.failed, 0U);
+    for (const auto& item : verify_items) {
+      auto* signature = item.result->signatures;
+      ASSERT_NE(signature, nullptr);
+      ASSERT_EQ(check_gpg_error_2_err_code(signature->status),
+                GPG_ERR_NO_ERROR);
+      ASSERT_EQ(std::string(signature->fpr), signer);
+      ASSERT_EQ(signature->next, nullptr);
+    }
+  };
+  check_batch(paths_a, items_a, signer_a);
+  check_batch(paths_b, items_b, signer_b);
+}
+
+TEST_F(GpgCoreFileTest, CoreFileDecryptArchiveTest) {
+  auto dir = make_test_dir("decrypt_archive");
+  std::filesystem::create_directories(dir / "plain" / "sub");
+  write_test_file(dir / "plain" / "a.txt", "Hello GpgFrontend!");
+  write_test_file(dir / "plain" / "sub" / "b.txt", "Hello GpgFrontend! sub");
+
+  auto archive_path = dir / "plain.tar.gpg";
+  GpgEncrResult e_result;
+  auto err = GpgFileOpera::EncryptDirectory(
+      make_test_recipients(), (dir / "plain").u8string(),
+      archive_path.u8string(), e_result, default_channel);
+  ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+
+  GpgDecrResult d_result;
+  err = GpgFileOpera::DecryptArchive(archive_path.u8string(),
+                                     (dir / "out").u8string(), d_result);
+  ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+  ASSERT_EQ(read_test_file(dir / "out" / "plain" / "a.txt"),
+            "Hello GpgFrontend!");
+  ASSERT_EQ(read_test_file(dir / "out" / "plain" / "sub" / "b.txt"),
+            "Hello GpgFrontend! sub");
+
+  // tampered near the end, after the entries have been decrypted
+  auto tampered_path = dir / "tampered.tar.gpg";
+  auto archive = read_test_file(archive_path);
+  archive[archive.size() - 30] ^= 0x1;
+  write_test_file(tampered_path, archive);
+
+  err = GpgFileOpera::DecryptArchive(tampered_path.u8string(),
+                                     (dir / "tampered").u8string(), d_result);
+  ASSERT_NE(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+  // no unauthenticated entry and no staging directory is left behind
+  ASSERT_TRUE(std::filesystem::is_empty(dir / "tampered"));
+}
+
+TEST_F(GpgCoreFileTest, CoreFileDecryptVerifyArchiveTest) {
+  auto dir = make_test_dir("decrypt_verify_archive");
+  std::filesystem::create_directories(dir / "plain");
+  write_test_file(dir / "plain" / "a.txt", "Hello GpgFrontend!");
+
+  auto archive_path = dir / "plain.tar.gpg";
+  GpgEncrResult e_result;
+  GpgSignResult s_result;
+  auto err = GpgFileOpera::EncryptSignDirectory(
+      make_test_recipients(), make_test_signers(kTestRecipient),
+      (dir / "plain").u8string(), archive_path.u8string(), e_result, s_result,
+      default_channel);
+  ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+
+  GpgDecrResult d_result;
+  GpgVerifyResult v_result;
+  err = GpgFileOpera::DecryptVerifyArchive(
+      archive_path.u8string(), (dir / "out").u8string(), d_result, v_result);
+  ASSERT_EQ(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+  ASSERT_NE(v_result->signatures, nullptr);
+  ASSERT_EQ(check_gpg_error_2_err_code(v_result->signatures->status),
+            GPG_ERR_NO_ERROR);
+  ASSERT_EQ(read_test_file(dir / "out" / "plain" / "a.txt"),
+            "Hello GpgFrontend!");
+
+  // tampered in the trailing signature, after the entry has been decrypted
+  auto tampered_path = dir / "tampered.tar.gpg";
+  auto archive = read_test_file(archive_path);
+  archive[archive.size() - 30] ^= 0x1;
+  write_test_file(tampered_path, archive);
+
+  err = GpgFileOpera::DecryptVerifyArchive(tampered_path.u8string(),
+                                           (dir / "tampered").u8string(),
+                                           d_result, v_result);
+  ASSERT_NE(check_gpg_error_2_err_code(err), GPG_ERR_NO_ERROR);
+  ASSERT_TRUE(std::filesystem::is_empty(dir / "tampered"));
+}
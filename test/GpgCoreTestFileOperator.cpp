@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GpgFrontendTest.h"
+#include "core/function/FileOperator.h"
+
+using namespace GpgFrontend;
+
+namespace {
+
+using DigestList = std::vector<std::pair<std::string, std::string>>;
+
+DigestList calculate_digests(const std::filesystem::path& path,
+                             unsigned int algorithms, bool parallel,
+                             uint64_t& file_size) {
+  DigestList digests;
+  EXPECT_TRUE(FileOperator::CalculateDigests(path, algorithms, parallel,
+                                             digests, file_size));
+  return digests;
+}
+
+}  // namespace
+
+TEST_F(GpgCoreFileTest, CoreFileDigestsTest) {
+  auto path = make_test_dir("digests") / "digests.txt";
+  write_test_file(path, "abc");
+
+  uint64_t file_size = 0;
+  auto digests =
+      calculate_digests(path, FileOperator::kHashMd5 | FileOperator::kHashSha1 |
+                                  FileOperator::kHashSha256,
+                        true, file_size);
+  ASSERT_EQ(file_size, 3U);
+  ASSERT_EQ(digests,
+            (DigestList{
+                {"md5", "900150983cd24fb0d6963f7d28e17f72"},
+                {"sha1", "a9993e364706816aba3e25717850c26c9cd0d89d"},
+                {"sha256", "ba7816bf8f01cfea414140de5dae2223"
+                           "b00361a396177a9cb410ff61f20015ad"},
+            }));
+}
+
+TEST_F(GpgCoreFileTest, CoreFileDigestsEmptyTest) {
+  auto path = make_test_dir("digests_empty") / "digests_empty.txt";
+  write_test_file(path, "");
+
+  uint64_t file_size = 1;
+  auto digests = calculate_digests(path, FileOperator::kHashMd5, true,
+                                   file_size);
+  ASSERT_EQ(file_size, 0U);
+  ASSERT_EQ(digests,
+            (DigestList{{"md5", "d41d8cd98f00b204e9800998ecf8427e"}}));
+}
+
+TEST_F(GpgCoreFileTest, CoreFileDigestsParallelTest) {
+  // several chunks, the last one partly filled
+  std::string data;
+  while (data.size() < 9 * 1024 * 1024 + 123) data += "Hello GpgFrontend! ";
+  auto path = make_test_dir("digests_large") / "digests_large.txt";
+  write_test_file(path, data);
+
+  auto algorithms = FileOperator::kHashMd5 | FileOperator::kHashSha1 |
+                    FileOperator::kHashSha256 | FileOperator::kHashSha512 |
+                    FileOperator::kHashBlake2b512;
+  uint64_t parallel_size = 0, serial_size = 0;
+  auto parallel = calculate_digests(path, algorithms, true, parallel_size);
+  auto serial = calculate_digests(path, algorithms, false, serial_size);
+  ASSERT_EQ(parallel_size, data.size());
+  ASSERT_EQ(serial_size, data.size());
+  ASSERT_EQ(parallel, serial);
+  ASSERT_EQ(parallel.size(), 5U);
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  ASSERT_FALSE(parallel.back().second.empty());
+#else
+  // reported, not dropped
+  ASSERT_EQ(parallel.back(), std::make_pair(std::string("blake2b512"),
+                                            std::string()));
+#endif
+}
+
+TEST_F(GpgCoreFileTest, CoreFileDigestsMissingFileTest) {
+  DigestList digests;
+  uint64_t file_size = 0;
+  ASSERT_FALSE(FileOperator::CalculateDigests(
+      std::filesystem::temp_directory_path() / "gpgfrontend_no_such_file",
+      FileOperator::kDefaultHashAlgorithms, true, digests, file_size));
+}
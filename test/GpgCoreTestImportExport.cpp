@@ -30,9 +30,9 @@
 #include <vector>
 
 #include "GpgFrontendTest.h"
-#include "gpg/GpgConstants.h"
-#include "gpg/function/GpgKeyGetter.h"
-#include "gpg/function/GpgKeyImportExporter.h"
-#include "gpg/model/GpgKey.h"
+#include "core/GpgConstants.h"
+#include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyImportExporter.h"
+#include "core/model/GpgKey.h"
 
 TEST_F(GpgCoreTest, CoreExportSecretTest) {}
\ No newline at end of file
@@ -27,7 +27,7 @@
  */
 
 #include "GpgFrontendTest.h"
-#include "gpg/function/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyGetter.h"
 
 TEST_F(GpgCoreTest, CoreInitTest) {
   auto& ctx = GpgFrontend::GpgContext::GetInstance(default_channel);
@@ -49,121 +49,124 @@ TEST_F(GpgCoreTest, GpgDataTest) {
 TEST_F(GpgCoreTest, GpgKeyTest) {
   auto key = GpgFrontend::GpgKeyGetter::GetInstance(default_channel)
                  .GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
-  ASSERT_TRUE(key.good());
-  ASSERT_TRUE(key.is_private_key());
-  ASSERT_TRUE(key.has_master_key());
-
-  ASSERT_FALSE(key.disabled());
-  ASSERT_FALSE(key.revoked());
-
-  ASSERT_EQ(key.protocol(), "OpenPGP");
-
-  ASSERT_EQ(key.subKeys()->size(), 2);
-  ASSERT_EQ(key.uids()->size(), 1);
-
-  ASSERT_TRUE(key.can_certify());
-  ASSERT_TRUE(key.can_encrypt());
-  ASSERT_TRUE(key.can_sign());
-  ASSERT_FALSE(key.can_authenticate());
-  ASSERT_TRUE(key.CanEncrActual());
-  ASSERT_TRUE(key.CanEncrActual());
-  ASSERT_TRUE(key.CanSignActual());
-  ASSERT_FALSE(key.CanAuthActual());
-
-  ASSERT_EQ(key.name(), "GpgFrontendTest");
-  ASSERT_TRUE(key.comment().empty());
-  ASSERT_EQ(key.email(), "gpgfrontend@gpgfrontend.bktus.com");
-  ASSERT_EQ(key.id(), "81704859182661FB");
-  ASSERT_EQ(key.fpr(), "9490795B78F8AFE9F93BD09281704859182661FB");
-  ASSERT_EQ(key.expires(),
+  ASSERT_TRUE(key.IsGood());
+  ASSERT_TRUE(key.IsPrivateKey());
+  ASSERT_TRUE(key.IsHasMasterKey());
+
+  ASSERT_FALSE(key.IsDisabled());
+  ASSERT_FALSE(key.IsRevoked());
+
+  ASSERT_EQ(key.GetProtocol(), "OpenPGP");
+
+  ASSERT_EQ(key.GetSubKeys()->size(), 2);
+  ASSERT_EQ(key.GetUIDs()->size(), 1);
+
+  ASSERT_TRUE(key.IsHasCertificationCapability());
+  ASSERT_TRUE(key.IsHasEncryptionCapability());
+  ASSERT_TRUE(key.IsHasSigningCapability());
+  ASSERT_FALSE(key.IsHasAuthenticationCapability());
+  ASSERT_TRUE(key.IsHasActualEncryptionCapability());
+  ASSERT_TRUE(key.IsHasActualEncryptionCapability());
+  ASSERT_TRUE(key.IsHasActualSigningCapability());
+  ASSERT_FALSE(key.IsHasActualAuthenticationCapability());
+
+  ASSERT_EQ(key.GetName(), "GpgFrontendTest");
+  ASSERT_TRUE(key.GetComment().empty());
+  ASSERT_EQ(key.GetEmail(), "gpgfrontend@gpgfrontend.bktus.com");
+  ASSERT_EQ(key.GetId(), "81704859182661FB");
+  ASSERT_EQ(key.GetFingerprint(), "9490795B78F8AFE9F93BD09281704859182661FB");
+  ASSERT_EQ(key.GetExpireTime(),
             boost::posix_time::from_iso_string("20230905T040000"));
-  ASSERT_EQ(key.pubkey_algo(), "RSA");
-  ASSERT_EQ(key.length(), 3072);
-  ASSERT_EQ(key.last_update(),
+  ASSERT_EQ(key.GetPublicKeyAlgo(), "RSA");
+  ASSERT_EQ(key.GetPrimaryKeyLength(), 3072);
+  ASSERT_EQ(key.GetLastUpdateTime(),
             boost::posix_time::from_iso_string("19700101T000000"));
-  ASSERT_EQ(key.create_time(),
+  ASSERT_EQ(key.GetCreateTime(),
             boost::posix_time::from_iso_string("20210905T060153"));
 
-  ASSERT_EQ(key.owner_trust(), "Unknown");
+  ASSERT_EQ(key.GetOwnerTrust(), "Unknown");
 
   using namespace boost::posix_time;
-  ASSERT_EQ(key.expired(), key.expires() < second_clock::local_time());
+  ASSERT_EQ(key.IsExpired(), key.GetExpireTime() < second_clock::local_time());
 }
 
 TEST_F(GpgCoreTest, GpgSubKeyTest) {
   auto key = GpgFrontend::GpgKeyGetter::GetInstance(default_channel)
                  .GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
-  auto sub_keys = key.subKeys();
+  auto sub_keys = key.GetSubKeys();
   ASSERT_EQ(sub_keys->size(), 2);
 
   auto& sub_key = sub_keys->back();
 
-  ASSERT_FALSE(sub_key.revoked());
-  ASSERT_FALSE(sub_key.disabled());
-  ASSERT_EQ(sub_key.timestamp(),
+  ASSERT_FALSE(sub_key.IsRevoked());
+  ASSERT_FALSE(sub_key.IsDisabled());
+  ASSERT_EQ(sub_key.GetCreateTime(),
             boost::posix_time::from_iso_string("20210905T060153"));
 
-  ASSERT_FALSE(sub_key.is_cardkey());
-  ASSERT_TRUE(sub_key.is_private_key());
-  ASSERT_EQ(sub_key.id(), "2B36803235B5E25B");
-  ASSERT_EQ(sub_key.fpr(), "50D37E8F8EE7340A6794E0592B36803235B5E25B");
-  ASSERT_EQ(sub_key.length(), 3072);
-  ASSERT_EQ(sub_key.pubkey_algo(), "RSA");
-  ASSERT_FALSE(sub_key.can_certify());
-  ASSERT_FALSE(sub_key.can_authenticate());
-  ASSERT_FALSE(sub_key.can_sign());
-  ASSERT_TRUE(sub_key.can_encrypt());
-  ASSERT_EQ(key.expires(),
+  ASSERT_FALSE(sub_key.IsCardKey());
+  ASSERT_TRUE(sub_key.IsPrivateKey());
+  ASSERT_EQ(sub_key.GetID(), "2B36803235B5E25B");
+  ASSERT_EQ(sub_key.GetFingerprint(),
+            "50D37E8F8EE7340A6794E0592B36803235B5E25B");
+  ASSERT_EQ(sub_key.GetKeyLength(), 3072);
+  ASSERT_EQ(sub_key.GetPubkeyAlgo(), "RSA");
+  ASSERT_FALSE(sub_key.IsHasCertificationCapability());
+  ASSERT_FALSE(sub_key.IsHasAuthenticationCapability());
+  ASSERT_FALSE(sub_key.IsHasSigningCapability());
+  ASSERT_TRUE(sub_key.IsHasEncryptionCapability());
+  ASSERT_EQ(key.GetExpireTime(),
             boost::posix_time::from_iso_string("20230905T040000"));
 
   using namespace boost::posix_time;
-  ASSERT_EQ(sub_key.expired(), sub_key.expires() < second_clock::local_time());
+  ASSERT_EQ(sub_key.IsExpired(),
+            sub_key.GetExpireTime() < second_clock::local_time());
 }
 
 TEST_F(GpgCoreTest, GpgUIDTest) {
   auto key = GpgFrontend::GpgKeyGetter::GetInstance(default_channel)
                  .GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
-  auto uids = key.uids();
+  auto uids = key.GetUIDs();
   ASSERT_EQ(uids->size(), 1);
   auto& uid = uids->front();
 
-  ASSERT_EQ(uid.name(), "GpgFrontendTest");
-  ASSERT_TRUE(uid.comment().empty());
-  ASSERT_EQ(uid.email(), "gpgfrontend@gpgfrontend.bktus.com");
-  ASSERT_EQ(uid.uid(), "GpgFrontendTest <gpgfrontend@gpgfrontend.bktus.com>");
-  ASSERT_FALSE(uid.invalid());
-  ASSERT_FALSE(uid.revoked());
+  ASSERT_EQ(uid.GetName(), "GpgFrontendTest");
+  ASSERT_TRUE(uid.GetComment().empty());
+  ASSERT_EQ(uid.GetEmail(), "gpgfrontend@gpgfrontend.bktus.com");
+  ASSERT_EQ(uid.GetUID(),
+            "GpgFrontendTest <gpgfrontend@gpgfrontend.bktus.com>");
+  ASSERT_FALSE(uid.GetInvalid());
+  ASSERT_FALSE(uid.GetRevoked());
 }
 
 TEST_F(GpgCoreTest, GpgKeySignatureTest) {
   auto key = GpgFrontend::GpgKeyGetter::GetInstance(default_channel)
                  .GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
-  auto uids = key.uids();
+  auto uids = key.GetUIDs();
   ASSERT_EQ(uids->size(), 1);
   auto& uid = uids->front();
 
-  auto signatures = uid.signatures();
+  auto signatures = uid.GetSignatures();
   ASSERT_EQ(signatures->size(), 1);
   auto& signature = signatures->front();
 
-  ASSERT_EQ(signature.name(), "GpgFrontendTest");
-  ASSERT_TRUE(signature.comment().empty());
-  ASSERT_EQ(signature.email(), "gpgfrontend@gpgfrontend.bktus.com");
-  ASSERT_EQ(signature.keyid(), "81704859182661FB");
-  ASSERT_EQ(signature.pubkey_algo(), "RSA");
+  ASSERT_EQ(signature.GetName(), "GpgFrontendTest");
+  ASSERT_TRUE(signature.GetComment().empty());
+  ASSERT_EQ(signature.GetEmail(), "gpgfrontend@gpgfrontend.bktus.com");
+  ASSERT_EQ(signature.GetKeyID(), "81704859182661FB");
+  ASSERT_EQ(signature.GetPubkeyAlgo(), "RSA");
 
-  ASSERT_FALSE(signature.revoked());
-  ASSERT_FALSE(signature.invalid());
-  ASSERT_EQ(GpgFrontend::check_gpg_error_2_err_code(signature.status()),
+  ASSERT_FALSE(signature.IsRevoked());
+  ASSERT_FALSE(signature.IsInvalid());
+  ASSERT_EQ(GpgFrontend::check_gpg_error_2_err_code(signature.GetStatus()),
             GPG_ERR_NO_ERROR);
-  ASSERT_EQ(signature.uid(),
+  ASSERT_EQ(signature.GetUID(),
             "GpgFrontendTest <gpgfrontend@gpgfrontend.bktus.com>");
 }
 
 TEST_F(GpgCoreTest, GpgKeyGetterTest) {
   auto key = GpgFrontend::GpgKeyGetter::GetInstance(default_channel)
                  .GetKey("9490795B78F8AFE9F93BD09281704859182661FB");
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   auto keys =
       GpgFrontend::GpgKeyGetter::GetInstance(default_channel).FetchKey();
   ASSERT_GE(keys->size(), secret_keys_.size());
@@ -27,20 +27,20 @@
  */
 
 #include "GpgFrontendTest.h"
-#include "gpg/GpgGenKeyInfo.h"
-#include "gpg/function/GpgKeyGetter.h"
-#include "gpg/function/GpgKeyOpera.h"
+#include "core/GpgGenKeyInfo.h"
+#include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyOpera.h"
 
 TEST_F(GpgCoreTest, GenerateKeyTest) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(default_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>();
-  keygen_info->setName("foo");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("");
-  keygen_info->setKeySize(1024);
-  keygen_info->setAlgo("rsa");
-  keygen_info->setNonExpired(true);
-  keygen_info->setNonPassPhrase(true);
+  keygen_info->SetName("foo");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("");
+  keygen_info->SetKeyLength(1024);
+  keygen_info->SetAlgo({"RSA", "RSA"});
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(true);
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -52,22 +52,22 @@ TEST_F(GpgCoreTest, GenerateKeyTest) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(default_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
 
 TEST_F(GpgCoreTest, GenerateKeyTest_1) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(default_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>();
-  keygen_info->setName("foo");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("hello gpgfrontend");
-  keygen_info->setAlgo("rsa");
-  keygen_info->setKeySize(4096);
-  keygen_info->setNonExpired(false);
-  keygen_info->setExpired(boost::posix_time::second_clock::local_time() +
+  keygen_info->SetName("foo");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("hello gpgfrontend");
+  keygen_info->SetAlgo({"RSA", "RSA"});
+  keygen_info->SetKeyLength(4096);
+  keygen_info->SetNonExpired(false);
+  keygen_info->SetExpireTime(boost::posix_time::second_clock::local_time() +
                           boost::posix_time::hours(24));
-  keygen_info->setNonPassPhrase(false);
+  keygen_info->SetNonPassPhrase(false);
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -79,19 +79,19 @@ TEST_F(GpgCoreTest, GenerateKeyTest_1) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(default_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
 
 TEST_F(GpgCoreTest, GenerateKeyTest_4) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(default_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>();
-  keygen_info->setName("foo");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("");
-  keygen_info->setAlgo("dsa");
-  keygen_info->setNonExpired(true);
-  keygen_info->setNonPassPhrase(false);
+  keygen_info->SetName("foo");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("");
+  keygen_info->SetAlgo({"DSA", "DSA"});
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(false);
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -103,19 +103,19 @@ TEST_F(GpgCoreTest, GenerateKeyTest_4) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(default_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
 
 TEST_F(GpgCoreTest, GenerateKeyTest_5) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(default_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>();
-  keygen_info->setName("foo");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("");
-  keygen_info->setAlgo("ed25519");
-  keygen_info->setNonExpired(true);
-  keygen_info->setNonPassPhrase(false);
+  keygen_info->SetName("foo");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("");
+  keygen_info->SetAlgo({"ECDSA", "ED25519"});
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(false);
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -127,6 +127,6 @@ TEST_F(GpgCoreTest, GenerateKeyTest_5) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(default_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
@@ -27,19 +27,19 @@
  */
 
 #include "GpgFrontendTest.h"
-#include "gpg/GpgGenKeyInfo.h"
-#include "gpg/function/GpgKeyGetter.h"
-#include "gpg/function/GpgKeyOpera.h"
+#include "core/GpgGenKeyInfo.h"
+#include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyOpera.h"
 
 TEST_F(GpgCoreTest, GenerateKeyTestAlone) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(gpg_alone_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>(false, true);
-  keygen_info->setName("foobar");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("hello");
-  keygen_info->setAlgo("rsa");
-  keygen_info->setNonExpired(true);
-  keygen_info->setNonPassPhrase(true);
+  keygen_info->SetName("foobar");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("hello");
+  keygen_info->SetAlgo({"RSA", "RSA"});
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(true);
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -51,22 +51,22 @@ TEST_F(GpgCoreTest, GenerateKeyTestAlone) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(gpg_alone_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
 
 TEST_F(GpgCoreTest, GenerateKeyTestAlone_1) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(gpg_alone_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>(false, true);
-  keygen_info->setName("foobar");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("hello gpgfrontend");
-  keygen_info->setAlgo("rsa");
-  keygen_info->setNonExpired(false);
-  keygen_info->setPassPhrase("abcdefg");
-  keygen_info->setExpired(boost::posix_time::second_clock::local_time() +
+  keygen_info->SetName("foobar");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("hello gpgfrontend");
+  keygen_info->SetAlgo({"RSA", "RSA"});
+  keygen_info->SetNonExpired(false);
+  keygen_info->SetPassPhrase("abcdefg");
+  keygen_info->SetExpireTime(boost::posix_time::second_clock::local_time() +
                           boost::posix_time::hours(24));
-  keygen_info->setNonPassPhrase(false);
+  keygen_info->SetNonPassPhrase(false);
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -78,21 +78,21 @@ TEST_F(GpgCoreTest, GenerateKeyTestAlone_1) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(gpg_alone_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
 
 TEST_F(GpgCoreTest, GenerateKeyTestAlone_2) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(gpg_alone_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>(false, true);
-  keygen_info->setName("foobar");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("hi");
-  keygen_info->setAlgo("rsa");
-  keygen_info->setKeySize(3072);
-  keygen_info->setNonExpired(true);
-  keygen_info->setNonPassPhrase(false);
-  keygen_info->setPassPhrase("abcdefg");
+  keygen_info->SetName("foobar");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("hi");
+  keygen_info->SetAlgo({"RSA", "RSA"});
+  keygen_info->SetKeyLength(3072);
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(false);
+  keygen_info->SetPassPhrase("abcdefg");
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -104,21 +104,21 @@ TEST_F(GpgCoreTest, GenerateKeyTestAlone_2) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(gpg_alone_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
 
 TEST_F(GpgCoreTest, GenerateKeyTestAlone_3) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(gpg_alone_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>(false, true);
-  keygen_info->setName("foo");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("hello");
-  keygen_info->setAlgo("rsa");
-  keygen_info->setKeySize(4096);
-  keygen_info->setNonExpired(true);
-  keygen_info->setNonPassPhrase(false);
-  keygen_info->setPassPhrase("abcdefg");
+  keygen_info->SetName("foo");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("hello");
+  keygen_info->SetAlgo({"RSA", "RSA"});
+  keygen_info->SetKeyLength(4096);
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(false);
+  keygen_info->SetPassPhrase("abcdefg");
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -130,20 +130,20 @@ TEST_F(GpgCoreTest, GenerateKeyTestAlone_3) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(gpg_alone_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
 
 TEST_F(GpgCoreTest, GenerateKeyTestAlone_4) {
   auto& key_opera = GpgFrontend::GpgKeyOpera::GetInstance(gpg_alone_channel);
   auto keygen_info = std::make_unique<GpgFrontend::GenKeyInfo>(false, true);
-  keygen_info->setName("foobar");
-  keygen_info->setEmail("bar@gpgfrontend.bktus.com");
-  keygen_info->setComment("hello");
-  keygen_info->setAlgo("dsa");
-  keygen_info->setNonExpired(true);
-  keygen_info->setNonPassPhrase(false);
-  keygen_info->setPassPhrase("abcdefg");
+  keygen_info->SetName("foobar");
+  keygen_info->SetEmail("bar@gpgfrontend.bktus.com");
+  keygen_info->SetComment("hello");
+  keygen_info->SetAlgo({"DSA", "DSA"});
+  keygen_info->SetNonExpired(true);
+  keygen_info->SetNonPassPhrase(false);
+  keygen_info->SetPassPhrase("abcdefg");
 
   GpgFrontend::GpgGenKeyResult result = nullptr;
   auto err = GpgFrontend::check_gpg_error_2_err_code(
@@ -155,6 +155,6 @@ TEST_F(GpgCoreTest, GenerateKeyTestAlone_4) {
 
   auto key =
       GpgFrontend::GpgKeyGetter::GetInstance(gpg_alone_channel).GetKey(fpr);
-  ASSERT_TRUE(key.good());
+  ASSERT_TRUE(key.IsGood());
   key_opera.DeleteKey(fpr);
 }
\ No newline at end of file
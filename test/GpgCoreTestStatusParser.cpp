@@ -0,0 +1,148 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "GpgFrontendTest.h"
+#include "core/function/gpg/GpgStatusParser.h"
+
+using namespace GpgFrontend;
+
+TEST_F(GpgCoreTest, StatusParserEncrTest) {
+  GpgStatusParser parser(
+      "gpg: a message not meant for the parser\n"
+      "[GNUPG:] BEGIN_ENCRYPTION 2 9\n"
+      "[GNUPG:] END_ENCRYPTION\n");
+  ASSERT_EQ(check_gpg_error_2_err_code(parser.GetEncrError(0)),
+            GPG_ERR_NO_ERROR);
+  ASSERT_EQ(parser.GetEncrResult()->invalid_recipients, nullptr);
+
+  // the process failed even though it reported the end of the encryption
+  ASSERT_EQ(check_gpg_error_2_err_code(parser.GetEncrError(2)),
+            GPG_ERR_GENERAL);
+}
+
+TEST_F(GpgCoreTest, StatusParserInvalidRecipientTest) {
+  GpgStatusParser parser(
+      "[GNUPG:] INV_RECP 1 ABC%3ADEF\r\n"
+      "[GNUPG:] INV_RECP 10 0123456789\r\n"
+      "[GNUPG:] FAILURE encrypt 53\r\n");
+  ASSERT_EQ(check_gpg_error_2_err_code(parser.GetEncrError(2)),
+            GPG_ERR_UNUSABLE_PUBKEY);
+
+  auto result = parser.GetEncrResult();
+  auto* key = result->invalid_recipients;
+  ASSERT_NE(key, nullptr);
+  ASSERT_STREQ(key->fpr, "ABC:DEF");
+  ASSERT_EQ(check_gpg_error_2_err_code(key->reason), GPG_ERR_NO_PUBKEY);
+  key = key->next;
+  ASSERT_NE(key, nullptr);
+  ASSERT_STREQ(key->fpr, "0123456789");
+  ASSERT_EQ(check_gpg_error_2_err_code(key->reason), GPG_ERR_NOT_TRUSTED);
+  ASSERT_EQ(key->next, nullptr);
+}
+
+TEST_F(GpgCoreTest, StatusParserNotStartedTest) {
+  GpgStatusParser parser("");
+  ASSERT_EQ(check_gpg_error_2_err_code(parser.GetEncrError(0)),
+            GPG_ERR_GENERAL);
+  ASSERT_EQ(check_gpg_error_2_err_code(parser.GetDecrError(-1)),
+            GPG_ERR_GENERAL);
+}
+
+TEST_F(GpgCoreTest, StatusParserDecrTest) {
+  GpgStatusParser parser(
+      "[GNUPG:] ENC_TO 8465C55B25C9B7D1 1 0\n"
+      "[GNUPG:] ENC_TO 0123456789ABCDEF 18 0\n"
+      "[GNUPG:] NO_SECKEY 0123456789ABCDEF\n"
+      "[GNUPG:] DECRYPTION_OKAY\n"
+      "[GNUPG:] PLAINTEXT 62 0 hello%20world.txt\n");
+  ASSERT_EQ(check_gpg_error_2_err_code(parser.GetDecrError(0)),
+            GPG_ERR_NO_ERROR);
+
+  auto result = parser.GetDecrResult();
+  ASSERT_STREQ(result->file_name, "hello world.txt");
+  auto* recipient = result->recipients;
+  ASSERT_NE(recipient, nullptr);
+  ASSERT_STREQ(recipient->keyid, "8465C55B25C9B7D1");
+  ASSERT_EQ(recipient->pubkey_algo, GPGME_PK_RSA);
+  ASSERT_EQ(check_gpg_error_2_err_code(recipient->status), GPG_ERR_NO_ERROR);
+  recipient = recipient->next;
+  ASSERT_NE(recipient, nullptr);
+  ASSERT_EQ(recipient->pubkey_algo, GPGME_PK_ECDH);
+  ASSERT_EQ(check_gpg_error_2_err_code(recipient->status), GPG_ERR_NO_SECKEY);
+  ASSERT_EQ(recipient->next, nullptr);
+}
+
+TEST_F(GpgCoreTest, StatusParserDecrErrorTest) {
+  ASSERT_EQ(check_gpg_error_2_err_code(
+                GpgStatusParser("[GNUPG:] NODATA 1\n").GetDecrError(2)),
+            GPG_ERR_NO_DATA);
+  ASSERT_EQ(check_gpg_error_2_err_code(
+                GpgStatusParser("[GNUPG:] ENC_TO 0123456789ABCDEF 1 0\n"
+                                "[GNUPG:] NO_SECKEY 0123456789ABCDEF\n"
+                                "[GNUPG:] DECRYPTION_FAILED\n")
+                    .GetDecrError(2)),
+            GPG_ERR_NO_SECKEY);
+  ASSERT_EQ(check_gpg_error_2_err_code(
+                GpgStatusParser("[GNUPG:] DECRYPTION_FAILED\n")
+                    .GetDecrError(2)),
+            GPG_ERR_DECRYPT_FAILED);
+  // the error of a FAILURE line is used when nothing else explains it
+  ASSERT_EQ(check_gpg_error_2_err_code(
+                GpgStatusParser("[GNUPG:] FAILURE decrypt 58\n")
+                    .GetDecrError(2)),
+            GPG_ERR_NO_DATA);
+}
+
+TEST_F(GpgCoreTest, StatusParserProgressTest) {
+  uint64_t current = 0, total = 0;
+  ASSERT_TRUE(GpgStatusParser::ParseProgress(
+      "[GNUPG:] PROGRESS file.txt ? 4096 10240\n", current, total));
+  ASSERT_EQ(current, 4096U);
+  ASSERT_EQ(total, 10240U);
+
+  // large files are reported in larger units
+  ASSERT_TRUE(GpgStatusParser::ParseProgress(
+      "[GNUPG:] PROGRESS file.txt ? 3 1024 MiB\r\n", current, total));
+  ASSERT_EQ(current, 3U * 1024 * 1024);
+  ASSERT_EQ(total, 1024U * 1024 * 1024);
+
+  ASSERT_TRUE(GpgStatusParser::ParseProgress("[GNUPG:] PROGRESS ? ? 100 0\n",
+                                             current, total));
+  ASSERT_EQ(total, 0U);
+
+  ASSERT_FALSE(GpgStatusParser::ParseProgress("[GNUPG:] END_ENCRYPTION\n",
+                                              current, total));
+  ASSERT_FALSE(GpgStatusParser::ParseProgress("[GNUPG:] PROGRESS file.txt\n",
+                                              current, total));
+  ASSERT_FALSE(GpgStatusParser::ParseProgress("gpg: PROGRESS a ? 1 2\n",
+                                              current, total));
+}
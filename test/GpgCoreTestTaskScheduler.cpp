@@ -0,0 +1,235 @@
+/**
+ * Copyright (C) 2021 Saturneric
+ *
+ * This file is part of GpgFrontend.
+ *
+ * GpgFrontend is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GpgFrontend is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GpgFrontend. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * The initial version of the source code is inherited from
+ * the gpg4usb project, which is under GPL-3.0-or-later.
+ *
+ * All the source code of GpgFrontend was modified and released by
+ * Saturneric<eric@bktus.com> starting on May 12, 2021.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "core/thread/TaskScheduler.h"
+
+using namespace GpgFrontend::Thread;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Duration = TaskScheduler::Duration;
+
+/// small ticks, so that the timers cross the levels of the wheel quickly
+constexpr Duration kTestTick = Duration(1);
+
+/// slack for a loaded test machine
+constexpr Duration kTestSlack = Duration(500);
+
+/**
+ * @brief wait until a condition holds
+ *
+ * @param condition
+ * @param timeout
+ * @return true if it held before the timeout
+ */
+template <typename Condition>
+bool wait_for(Condition&& condition, Duration timeout) {
+  auto deadline = Clock::now() + timeout;
+  while (!condition()) {
+    if (Clock::now() > deadline) return false;
+    std::this_thread::sleep_for(Duration(1));
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(TaskSchedulerTest, OneShotTest) {
+  TaskScheduler scheduler(kTestTick);
+
+  std::atomic_int calls = 0;
+  Clock::time_point fired_at;
+  auto begin = Clock::now();
+  auto timer_id = scheduler.Schedule(Duration(50), Duration(0), [&]() {
+    fired_at = Clock::now();
+    calls++;
+  });
+  ASSERT_NE(timer_id, 0U);
+
+  ASSERT_TRUE(
+      wait_for([&]() { return calls == 1; }, Duration(50) + kTestSlack));
+  // the deadline is counted from the start of the current tick
+  ASSERT_GE(fired_at - begin, Duration(50) - kTestTick);
+
+  // once only, then it is gone
+  std::this_thread::sleep_for(Duration(100));
+  ASSERT_EQ(calls, 1);
+  ASSERT_FALSE(scheduler.Cancel(timer_id));
+}
+
+TEST(TaskSchedulerTest, PeriodicTest) {
+  TaskScheduler scheduler(kTestTick);
+
+  std::atomic_int calls = 0;
+  auto timer_id =
+      scheduler.Schedule(Duration(10), Duration(20), [&]() { calls++; });
+
+  ASSERT_TRUE(wait_for([&]() { return calls >= 5; }, 5 * kTestSlack));
+  ASSERT_TRUE(scheduler.Cancel(timer_id));
+
+  // no call after the cancellation returned
+  auto calls_after_cancel = calls.load();
+  std::this_thread::sleep_for(Duration(100));
+  ASSERT_EQ(calls, calls_after_cancel);
+}
+
+TEST(TaskSchedulerTest, LevelBoundaryTest) {
+  TaskScheduler scheduler(kTestTick);
+
+  // the lowest level holds 256 ticks, these timers are cascaded down once
+  // or placed right at the boundary
+  const Duration delays[] = {Duration(255), Duration(256), Duration(257),
+                             Duration(600)};
+  std::atomic_int calls[4] = {0, 0, 0, 0};
+  Clock::time_point fired_at[4];
+  auto begin = Clock::now();
+  for (int i = 0; i < 4; i++) {
+    scheduler.Schedule(delays[i], Duration(0), [&, i]() {
+      fired_at[i] = Clock::now();
+      calls[i]++;
+    });
+  }
+
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(
+        wait_for([&]() { return calls[i] == 1; }, delays[i] + kTestSlack));
+    ASSERT_GE(fired_at[i] - begin, delays[i] - kTestTick);
+  }
+}
+
+TEST(TaskSchedulerTest, PeriodicAcrossLevelsTest) {
+  TaskScheduler scheduler(kTestTick);
+
+  // the interval is longer than the lowest level, every call is cascaded
+  std::atomic_int calls = 0;
+  auto timer_id =
+      scheduler.Schedule(Duration(10), Duration(300), [&]() { calls++; });
+
+  ASSERT_TRUE(
+      wait_for([&]() { return calls >= 3; }, Duration(610) + 3 * kTestSlack));
+  ASSERT_TRUE(scheduler.Cancel(timer_id));
+}
+
+TEST(TaskSchedulerTest, CancelTest) {
+  TaskScheduler scheduler(kTestTick);
+
+  std::atomic_int calls = 0, cancels = 0;
+  auto timer_id = scheduler.Schedule(
+      Duration(100), Duration(0), [&]() { calls++; }, [&]() { cancels++; });
+
+  ASSERT_TRUE(scheduler.Cancel(timer_id));
+  ASSERT_EQ(cancels, 1);
+  // the second cancellation finds nothing
+  ASSERT_FALSE(scheduler.Cancel(timer_id));
+  ASSERT_EQ(cancels, 1);
+
+  std::this_thread::sleep_for(Duration(200));
+  ASSERT_EQ(calls, 0);
+}
+
+TEST(TaskSchedulerTest, CancelFromCallbackTest) {
+  TaskScheduler scheduler(kTestTick);
+
+  // both are due in the same tick, the first one cancels the second one
+  std::atomic_int first_calls = 0, second_calls = 0, second_cancels = 0;
+  std::atomic<TaskScheduler::TimerId> second_id = 0;
+  std::atomic_bool cancelled = false;
+  scheduler.Schedule(Duration(50), Duration(0), [&]() {
+    first_calls++;
+    cancelled = scheduler.Cancel(second_id);
+  });
+  second_id = scheduler.Schedule(
+      Duration(50), Duration(0), [&]() { second_calls++; },
+      [&]() { second_cancels++; });
+
+  ASSERT_TRUE(wait_for([&]() { return first_calls == 1; }, kTestSlack));
+  std::this_thread::sleep_for(Duration(100));
+  // the callbacks of the same tick are not called in a fixed order
+  if (cancelled) {
+    ASSERT_EQ(second_calls, 0);
+    ASSERT_EQ(second_cancels, 1);
+  } else {
+    ASSERT_EQ(second_calls, 1);
+    ASSERT_EQ(second_cancels, 0);
+  }
+}
+
+TEST(TaskSchedulerTest, CancelWaitsForCallbackTest) {
+  TaskScheduler scheduler(kTestTick);
+
+  std::atomic_bool running = false, finished = false;
+  auto timer_id = scheduler.Schedule(Duration(10), Duration(10), [&]() {
+    if (finished) return;
+    running = true;
+    std::this_thread::sleep_for(Duration(100));
+    finished = true;
+  });
+
+  ASSERT_TRUE(wait_for([&]() { return running.load(); }, kTestSlack));
+  ASSERT_TRUE(scheduler.Cancel(timer_id));
+  // the callback returned before the cancellation did
+  ASSERT_TRUE(finished);
+}
+
+TEST(TaskSchedulerTest, CoalesceTest) {
+  TaskScheduler scheduler(kTestTick);
+
+  std::atomic_int first_calls = 0, second_calls = 0;
+  auto first_id = scheduler.Schedule(
+      Duration(50), Duration(0), [&]() { first_calls++; }, nullptr, "flush");
+  auto second_id = scheduler.Schedule(
+      Duration(50), Duration(0), [&]() { second_calls++; }, nullptr, "flush");
+  ASSERT_EQ(first_id, second_id);
+
+  ASSERT_TRUE(wait_for([&]() { return first_calls == 1; }, kTestSlack));
+  ASSERT_EQ(second_calls, 0);
+
+  // the key is free again once the timer fired
+  auto third_id = scheduler.Schedule(
+      Duration(10), Duration(0), [&]() { second_calls++; }, nullptr, "flush");
+  ASSERT_NE(third_id, first_id);
+  ASSERT_TRUE(wait_for([&]() { return second_calls == 1; }, kTestSlack));
+}
+
+TEST(TaskSchedulerTest, DestroyCancelsTest) {
+  std::atomic_int calls = 0, cancels = 0;
+  {
+    TaskScheduler scheduler(kTestTick);
+    scheduler.Schedule(
+        Duration(1000), Duration(0), [&]() { calls++; }, [&]() { cancels++; });
+  }
+  ASSERT_EQ(calls, 0);
+  ASSERT_EQ(cancels, 1);
+}
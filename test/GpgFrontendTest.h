@@ -29,7 +29,6 @@
 #ifndef _GPGFRONTENDTEST_H
 #define _GPGFRONTENDTEST_H
 
-#include <easyloggingpp/easylogging++.h>
 #include <gpg-error.h>
 #include <gtest/gtest.h>
 
@@ -37,14 +36,21 @@
 #include <boost/dll.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <libconfig.h++>
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "gpg/GpgConstants.h"
-#include "gpg/function/GpgKeyImportExporter.h"
-#include "gpg/function/GpgKeyOpera.h"
+#include "core/GpgConstants.h"
+#include "core/GpgContext.h"
+#include "core/GpgModel.h"
+#include "core/function/gpg/GpgFileOpera.h"
+#include "core/function/gpg/GpgKeyGetter.h"
+#include "core/function/gpg/GpgKeyImportExporter.h"
+#include "core/function/gpg/GpgKeyOpera.h"
 
 class GpgCoreTest : public ::testing::Test {
  protected:
@@ -70,15 +76,6 @@ class GpgCoreTest : public ::testing::Test {
   ~GpgCoreTest() override = default;
 
   void SetUp() override {
-    el::Loggers::addFlag(el::LoggingFlag::AutoSpacing);
-    el::Configurations defaultConf;
-    defaultConf.setToDefault();
-    el::Loggers::reconfigureLogger("default", defaultConf);
-
-    defaultConf.setGlobally(el::ConfigurationType::Format,
-                            "%datetime %level %func %msg");
-    el::Loggers::reconfigureLogger("default", defaultConf);
-
     using namespace libconfig;
     Config cfg;
     ASSERT_NO_THROW(cfg.readFile(config_path.c_str()));
@@ -203,4 +200,97 @@ class GpgCoreTest : public ::testing::Test {
   }
 };
 
+/**
+ * @brief fixture of the file operation tests, the files are written to
+ * directories removed after each test
+ *
+ */
+class GpgCoreFileTest : public GpgCoreTest {
+ protected:
+  void TearDown() override {
+    for (const auto& dir : test_dirs_) std::filesystem::remove_all(dir);
+    GpgCoreTest::TearDown();
+  }
+
+  /**
+   * @brief create an empty directory for this test
+   *
+   * @param name name of the directory
+   * @return std::filesystem::path
+   */
+  std::filesystem::path make_test_dir(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() / ("gpgfrontend_" + name);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    test_dirs_.push_back(dir);
+    return dir;
+  }
+
+  static void write_test_file(const std::filesystem::path& path,
+                              const std::string& data) {
+    std::ofstream file(path, std::ios::binary);
+    file << data;
+  }
+
+  static std::string read_test_file(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+  }
+
+  /**
+   * @brief write count small files into dir, paired with the path of their
+   * encrypted output
+   *
+   * @param dir
+   * @param prefix file name prefix
+   * @param count
+   * @return std::vector<GpgFrontend::FilePathPair>
+   */
+  static std::vector<GpgFrontend::FilePathPair> make_test_batch(
+      const std::filesystem::path& dir, const std::string& prefix,
+      int count) {
+    std::vector<GpgFrontend::FilePathPair> paths;
+    for (int i = 0; i < count; i++) {
+      auto in_path = dir / (prefix + std::to_string(i) + ".txt");
+      write_test_file(in_path, "Hello GpgFrontend! " + std::to_string(i));
+      paths.emplace_back(in_path.u8string(), in_path.u8string() + ".gpg");
+    }
+    return paths;
+  }
+
+  /**
+   * @brief the test key every file is encrypted to
+   *
+   * @return GpgFrontend::KeyListPtr
+   */
+  GpgFrontend::KeyListPtr make_test_recipients() {
+    auto keys = std::make_unique<GpgFrontend::KeyArgsList>();
+    keys->push_back(GpgFrontend::GpgKeyGetter::GetInstance(default_channel)
+                        .GetPubkey(kTestRecipient));
+    return keys;
+  }
+
+  /**
+   * @brief a secret test key to sign with
+   *
+   * @param fpr fingerprint of the key
+   * @return GpgFrontend::KeyListPtr
+   */
+  GpgFrontend::KeyListPtr make_test_signers(const std::string& fpr) {
+    auto keys = std::make_unique<GpgFrontend::KeyArgsList>();
+    keys->push_back(
+        GpgFrontend::GpgKeyGetter::GetInstance(default_channel).GetKey(fpr));
+    return keys;
+  }
+
+  static constexpr const char* kTestRecipient =
+      "467F14220CE8DCF780CF4BAD8465C55B25C9B7D1";  ///< can sign too
+  static constexpr const char* kTestSigner =
+      "8933EB283A18995F45D61DAC021D89771B680FFB";  ///<
+
+ private:
+  std::vector<std::filesystem::path> test_dirs_;  ///<
+};
+
 #endif  // _GPGFRONTENDTEST_H